@@ -0,0 +1,249 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+namespace tt = boost::test_tools;
+
+#include <adolc/adolc.h>
+
+#include "const.h"
+
+BOOST_AUTO_TEST_SUITE( trace_decoded )
+
+
+/**************************************/
+/* Tests for the decoded sweeps over  */
+/* tapes kept in core                 */
+/**************************************/
+
+
+/* A tape kept completely in core for which set_tape_decoding is called
+ * (or DECODETAPES is set in .adolcrc) is decoded once and swept over its
+ * decoded form, a tape recorded with small buffers goes to disk and is
+ * swept over its streams. The
+ * tests below record the same function both ways and compare the
+ * results of the two sweeps. The function uses every operation the
+ * decoded sweeps handle: assignments, the arithmetic operations with
+ * active, constant and parameter operands, their compound assignments,
+ * the signs, exp, log, sqrt, sin, cos and pow with constant exponent.
+ */
+
+const short streamTag = 31, decodedTag = 32, otherTag = 33;
+const int n = 3, m = 2;
+
+static void recordMixedOps(short tag, int onDisk, int scalar) {
+  double x[n] = {0.289, 1.927, 0.562}, y[m];
+  size_t stats[STAT_SIZE];
+  adouble ax[n], ay[m];
+  adouble a, b, c, d, e, f;
+  const double p = 0.7;
+
+  if (onDisk)
+    trace_on(tag, 0, 64, 64, 64, 64);
+  else
+    trace_on(tag);
+  for (int i = 0; i < n; i++)
+    ax[i] <<= x[i];
+
+  a = ax[0] * ax[1];
+  a += ax[2];
+  a -= 0.5;
+  a *= 1.3;
+  a += mkparam(p);
+  a -= mkparam(p);
+  a *= mkparam(p);
+  b = sin(ax[0]) + cos(ax[1]);
+  b = b / (ax[2] + 2.0);
+  b -= a;
+  b *= ax[0];
+  c = exp(ax[1]) * 2.0 - log(ax[2] + 3.0);
+  c = 1.5 - c;
+  d = sqrt(ax[0] + 1.0) + pow(ax[1] + 1.5, 2.5);
+  d = -d + (+c);
+  e = 1.0 / (ax[0] + 4.0);
+  e = e * mkparam(p) + mkparam(p) / ax[1];
+  e = (e + mkparam(p)) - mkparam(p);
+  e = mkparam(p);
+  e = -mkparam(p) + e;
+  e += 1.0 / mkparam(p);
+  e += a * b;
+  e -= c * d;
+  e++;
+  e--;
+  f = 0.0;
+  f += ax[2];
+  f *= d;
+  d = 1.0;
+  d -= f;
+  ay[0] = a + b * c + e;
+  ay[1] = d - e + 2.0 * a;
+  if (scalar) {
+    ay[0] += ay[1];
+    ay[0] >>= y[0];
+  } else {
+    for (int i = 0; i < m; i++)
+      ay[i] >>= y[i];
+  }
+  trace_off();
+  set_tape_decoding(tag, 1);
+
+  tapestats(tag, stats);
+  BOOST_TEST(stats[OP_FILE_ACCESS] == (size_t)onDisk);
+}
+
+static double **identity(int rows, int cols) {
+  double **S = myalloc2(rows, cols);
+
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      S[i][j] = (i == j) ? 1. : 0.;
+  return S;
+}
+
+/* Compares the zos, fos and fov forward sweeps of "tag" with those of the
+ * stream tape. */
+static void compareForward(short tag) {
+  double x[n] = {0.361, 1.184, 0.947}, xd[n] = {0.25, -1.5, 0.75};
+  double y[m], yd[m], yRef[m], ydRef[m];
+  double **X = identity(n, n), **Y = myalloc2(m, n), **YRef = myalloc2(m, n);
+
+  zos_forward(streamTag, m, n, 0, x, yRef);
+  zos_forward(tag, m, n, 0, x, y);
+  for (int i = 0; i < m; i++)
+    BOOST_TEST(y[i] == yRef[i], tt::tolerance(tol));
+
+  fos_forward(streamTag, m, n, 0, x, xd, yRef, ydRef);
+  fos_forward(tag, m, n, 0, x, xd, y, yd);
+  for (int i = 0; i < m; i++) {
+    BOOST_TEST(y[i] == yRef[i], tt::tolerance(tol));
+    BOOST_TEST(yd[i] == ydRef[i], tt::tolerance(tol));
+  }
+
+  fov_forward(streamTag, m, n, n, x, X, yRef, YRef);
+  fov_forward(tag, m, n, n, x, X, y, Y);
+  for (int i = 0; i < m; i++) {
+    BOOST_TEST(y[i] == yRef[i], tt::tolerance(tol));
+    for (int j = 0; j < n; j++)
+      BOOST_TEST(Y[i][j] == YRef[i][j], tt::tolerance(tol));
+  }
+
+  myfree2(X);
+  myfree2(Y);
+  myfree2(YRef);
+}
+
+/* Compares the fos and fov reverse sweeps of "tag" with those of the
+ * stream tape, each after a zos_forward keeping the taylors. */
+static void compareReverse(short tag) {
+  double x[n] = {0.361, 1.184, 0.947}, y[m], u[m] = {1.5, -0.5};
+  double z[n], zRef[n];
+  double **U = identity(m, m), **Z = myalloc2(m, n), **ZRef = myalloc2(m, n);
+
+  zos_forward(streamTag, m, n, 1, x, y);
+  fos_reverse(streamTag, m, n, u, zRef);
+  zos_forward(tag, m, n, 1, x, y);
+  fos_reverse(tag, m, n, u, z);
+  for (int j = 0; j < n; j++)
+    BOOST_TEST(z[j] == zRef[j], tt::tolerance(tol));
+
+  zos_forward(streamTag, m, n, 1, x, y);
+  fov_reverse(streamTag, m, n, m, U, ZRef);
+  zos_forward(tag, m, n, 1, x, y);
+  fov_reverse(tag, m, n, m, U, Z);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++)
+      BOOST_TEST(Z[i][j] == ZRef[i][j], tt::tolerance(tol));
+
+  myfree2(U);
+  myfree2(Z);
+  myfree2(ZRef);
+}
+
+BOOST_AUTO_TEST_CASE(DecodedForward)
+{
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+
+  compareForward(decodedTag);
+}
+
+BOOST_AUTO_TEST_CASE(DecodedReverse)
+{
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+
+  compareReverse(decodedTag);
+}
+
+/* optimize_tape rewrites the tape, which is decoded anew. */
+BOOST_AUTO_TEST_CASE(DecodedOptimizedTape)
+{
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+
+  BOOST_TEST(optimize_tape(decodedTag) >= 0);
+  compareForward(decodedTag);
+  compareReverse(decodedTag);
+}
+
+/* A tape restored by load_tape is kept in core and decoded as well. */
+BOOST_AUTO_TEST_CASE(DecodedLoadedTape)
+{
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+
+  BOOST_TEST(save_tape(decodedTag, "ADOLC-decoded-tape.adt") == 0);
+  BOOST_TEST(load_tape(otherTag, "ADOLC-decoded-tape.adt") == 0);
+  set_tape_decoding(otherTag, 1);
+  remove("ADOLC-decoded-tape.adt");
+  compareForward(otherTag);
+  compareReverse(otherTag);
+}
+
+/* tape_codegen compiles the sweeps in the current directory. */
+BOOST_AUTO_TEST_CASE(CompiledTape)
+{
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+
+  BOOST_TEST(tape_codegen(decodedTag, ADOLC_CODEGEN_ZOS | ADOLC_CODEGEN_FOS |
+                          ADOLC_CODEGEN_FOV | ADOLC_CODEGEN_FOS_REVERSE,
+                          ".") == 0);
+  compareForward(decodedTag);
+  compareReverse(decodedTag);
+}
+
+/* The batch drivers sweep the decoded tape for several points at once. */
+BOOST_AUTO_TEST_CASE(DecodedBatchDrivers)
+{
+  const int N = 5;
+  double **X = myalloc2(N, n), **Y = myalloc2(N, m), **G = myalloc2(N, n);
+  double yRef[m], gRef[n];
+
+  for (int k = 0; k < N; k++)
+    for (int j = 0; j < n; j++)
+      X[k][j] = 0.2 * (k + 1) + 0.35 * j;
+
+  recordMixedOps(streamTag, 1, 0);
+  recordMixedOps(decodedTag, 0, 0);
+  BOOST_TEST(zos_forward_batch(decodedTag, m, n, N, X, Y) >= 0);
+  for (int k = 0; k < N; k++) {
+    zos_forward(streamTag, m, n, 0, X[k], yRef);
+    for (int i = 0; i < m; i++)
+      BOOST_TEST(Y[k][i] == yRef[i], tt::tolerance(tol));
+  }
+
+  recordMixedOps(streamTag, 1, 1);
+  recordMixedOps(decodedTag, 0, 1);
+  BOOST_TEST(gradient_batch(decodedTag, n, N, X, G) >= 0);
+  for (int k = 0; k < N; k++) {
+    gradient(streamTag, n, X[k], gRef);
+    for (int j = 0; j < n; j++)
+      BOOST_TEST(G[k][j] == gRef[j], tt::tolerance(tol));
+  }
+
+  myfree2(X);
+  myfree2(Y);
+  myfree2(G);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
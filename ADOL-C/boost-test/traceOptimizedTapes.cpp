@@ -0,0 +1,115 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+namespace tt = boost::test_tools;
+
+#include <adolc/adolc.h>
+
+#include "const.h"
+
+#if defined(ADOLC_ADVANCED_BRANCHING)
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#endif
+
+BOOST_AUTO_TEST_SUITE( trace_optimized )
+
+
+/**************************************/
+/* Tests for tapes rewritten by       */
+/* optimize_tape                      */
+/**************************************/
+
+
+/* optimize_tape removes the operations whose results do not reach a
+ * dependent. The comparisons recorded for the branches of the function
+ * only feed the control flow of the program and are kept nevertheless,
+ * such that the forward sweeps of the optimized tape still detect a
+ * switched branch.
+ */
+
+const short plainTag = 41, optimizedTag = 42;
+
+static void recordBranches(short tag) {
+  double x[2] = {2.0, 1.0}, y;
+  adouble ax[2], ay, t;
+
+  trace_on(tag);
+  ax[0] <<= x[0];
+  ax[1] <<= x[1];
+  t = ax[0] * ax[1];
+  t = t + sin(ax[0]);                   /* not used by the dependent */
+#if defined(ADOLC_ADVANCED_BRANCHING)
+  if ((ax[0] > ax[1]).value())
+#else
+  if (ax[0] > ax[1])
+#endif
+    ay = ax[0] * ax[1];
+  else
+    ay = ax[0] + ax[1];
+  ay >>= y;
+  trace_off();
+}
+
+#if defined(ADOLC_ADVANCED_BRANCHING)
+/* The comparisons of advanced branching report a switch on DIAG_OUT. */
+static bool reportsSwitch(short tag, double *x) {
+  char text[256] = "";
+  double y;
+  FILE *log = tmpfile();
+  int saved;
+
+  fflush(stderr);
+  saved = dup(fileno(stderr));
+  dup2(fileno(log), fileno(stderr));
+  zos_forward(tag, 1, 2, 0, x, &y);
+  fflush(stderr);
+  dup2(saved, fileno(stderr));
+  close(saved);
+  rewind(log);
+  size_t len = fread(text, 1, sizeof(text) - 1, log);
+  text[len] = '\0';
+  fclose(log);
+  return strstr(text, "Branch switch detected") != NULL;
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(OptimizedTapeValues)
+{
+  double x[2] = {2.5, 0.5}, y, yRef, g[2], gRef[2];
+
+  recordBranches(plainTag);
+  recordBranches(optimizedTag);
+  BOOST_TEST(optimize_tape(optimizedTag) > 0);
+
+  BOOST_TEST(zos_forward(optimizedTag, 1, 2, 0, x, &y) ==
+             zos_forward(plainTag, 1, 2, 0, x, &yRef));
+  BOOST_TEST(y == yRef, tt::tolerance(tol));
+  gradient(plainTag, 2, x, gRef);
+  gradient(optimizedTag, 2, x, g);
+  BOOST_TEST(g[0] == gRef[0], tt::tolerance(tol));
+  BOOST_TEST(g[1] == gRef[1], tt::tolerance(tol));
+}
+
+/* At a point taking the other branch the optimized tape reports the
+ * switch like the recorded one. */
+BOOST_AUTO_TEST_CASE(OptimizedTapeBranchSwitch)
+{
+  double x[2] = {0.5, 1.5}, y;
+
+  recordBranches(plainTag);
+  recordBranches(optimizedTag);
+  BOOST_TEST(optimize_tape(optimizedTag) > 0);
+
+  int rc = zos_forward(plainTag, 1, 2, 0, x, &y);
+  BOOST_TEST(zos_forward(optimizedTag, 1, 2, 0, x, &y) == rc);
+#if defined(ADOLC_ADVANCED_BRANCHING)
+  BOOST_TEST(reportsSwitch(plainTag, x));
+  BOOST_TEST(reportsSwitch(optimizedTag, x));
+#else
+  BOOST_TEST(rc < 0);
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
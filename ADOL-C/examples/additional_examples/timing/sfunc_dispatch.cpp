@@ -0,0 +1,153 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     sfunc_dispatch.cpp
+ Revision: $Id$
+ Contents: function module containing a long, irregular mix of elementary
+           operations (stresses the operation dispatch of the sweeps)
+
+   Each << function module >> contains:
+          
+     (1) const char* const controlFileName 
+     (2) int indepDim; 
+     (3) void initProblemParameters( void )
+     (4) void initIndependents( double* indeps )
+     (5) double originalScalarFunction( double* indeps )
+     (6) double tapingScalarFunction( int tag, double* indeps )   
+ 
+ Copyright (c) Andrea Walther, Andreas Griewank, Andreas Kowarz, 
+               Hristo Mitev, Sebastian Schlenkrich, Jean Utke, Olaf Vogel
+  
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes 
+ recipient's acceptance of the terms of the accompanying license file.
+ 
+---------------------------------------------------------------------------*/
+#define _SFUNC_DISPATCH_C_
+
+
+/****************************************************************************/
+/*                                                                 INCLUDES */
+#include <adolc/adolc.h>
+
+#include <cmath>
+
+
+/****************************************************************************/
+/*                                                         GLOBAL VARIABLES */
+
+/*--------------------------------------------------------------------------*/
+/*                                                        Control file name */
+const char* controlFileName = "dispatchexam.ctrl";
+
+/*--------------------------------------------------------------------------*/
+/*                                                               Dimensions */
+int indepDim;
+
+/*--------------------------------------------------------------------------*/
+/*                                       Other problem dependent parameters */
+const int rounds = 50;
+
+
+/****************************************************************************/
+/*                                                  INIT PROBLEM PARAMETERS */
+void initProblemParameters( void ) {
+    fprintf(stdout,"OPERATION MIX (ADOL-C Example)\n\n");
+    if (indepDim <= 0) {
+        fprintf(stdout,"    number of independent variables = ? ");
+        fscanf(stdin,"%d",&indepDim);
+        fprintf(stdout,"\n");
+    }
+}
+
+
+/****************************************************************************/
+/*                                                        INITIALIZE INDEPs */
+void initIndependents( double* indeps ) {
+    int i;
+    for (i=0; i<indepDim; i++)
+        indeps[i] = 0.5 + (i+1.0)/(3.0+i);
+}
+
+
+/****************************************************************************/
+/*                                                 ORIGINAL SCALAR FUNCTION */
+
+/*--------------------------------------------------------------------------*/
+/*                                                            operation mix */
+/* A linear congruential generator picks the next operation and its
+   operands, so consecutive tape entries have no regular pattern. */
+double mix( int dim, double* indeps ) {
+    int i, j, k;
+    unsigned int seed = 1;
+    double s = 0, t = 1;
+    for (k=0; k<rounds*dim; k++) {
+        seed = seed*1103515245u + 12345u;
+        i = (seed >> 4) % dim;
+        j = (seed >> 12) % dim;
+        switch ((seed >> 24) % 8) {
+        case 0: s += indeps[i]*indeps[j];          break;
+        case 1: t  = 0.5*t + indeps[i];            break;
+        case 2: s -= indeps[i]/(1.0 + t*t);        break;
+        case 3: t  = sin(s) + cos(indeps[j]);      break;
+        case 4: s += sqrt(1.0 + indeps[i]*t*t);    break;
+        case 5: t  = exp(-indeps[i]*indeps[i]) - t; break;
+        case 6: s  = s*0.999 + log(1.0 + t*t);     break;
+        case 7: t  = indeps[j] - t*s*1e-3;         break;
+        }
+    }
+    return s + t;
+}
+
+/*--------------------------------------------------------------------------*/
+/*                                                   The interface function */
+double originalScalarFunction( double* indeps ) {
+    return mix(indepDim, indeps);
+}
+
+
+/****************************************************************************/
+/*                                                   TAPING SCALAR FUNCTION */
+
+/*--------------------------------------------------------------------------*/
+/*                                                     active operation mix */
+adouble activeMix( int dim, adouble* indeps ) {
+    int i, j, k;
+    unsigned int seed = 1;
+    adouble s = 0, t = 1;
+    for (k=0; k<rounds*dim; k++) {
+        seed = seed*1103515245u + 12345u;
+        i = (seed >> 4) % dim;
+        j = (seed >> 12) % dim;
+        switch ((seed >> 24) % 8) {
+        case 0: s += indeps[i]*indeps[j];          break;
+        case 1: t  = 0.5*t + indeps[i];            break;
+        case 2: s -= indeps[i]/(1.0 + t*t);        break;
+        case 3: t  = sin(s) + cos(indeps[j]);      break;
+        case 4: s += sqrt(1.0 + indeps[i]*t*t);    break;
+        case 5: t  = exp(-indeps[i]*indeps[i]) - t; break;
+        case 6: s  = s*0.999 + log(1.0 + t*t);     break;
+        case 7: t  = indeps[j] - t*s*1e-3;         break;
+        }
+    }
+    return s + t;
+}
+
+/*--------------------------------------------------------------------------*/
+/*                                                   The interface function */
+double tapingScalarFunction( int tag, double* indeps ) {
+    int i;
+    trace_on(tag);
+    adouble* activeIndeps = new adouble[indepDim];
+    adouble* aIP = activeIndeps;
+    double*  iP  = indeps;
+    for (i=0; i<indepDim; i++)
+        *aIP++ <<= *iP++;
+    adouble ares = activeMix(indepDim, activeIndeps);
+    double res = 0;
+    ares >>= res;
+    trace_off();
+    set_tape_decoding(tag, 1);    /* the dispatch only affects these sweeps */
+    return res;
+}
+
+#undef _SFUNC_DISPATCH_C_
@@ -36,6 +36,10 @@ ADOLC_DLL_EXPORT fint function_(fint*,fint*,fint*,fdouble*,fdouble*);
 ADOLC_DLL_EXPORT int gradient(short,int,const double*,double*);
 ADOLC_DLL_EXPORT fint gradient_(fint*,fint*,fdouble*,fdouble*);
 
+/* gradient_batch(tag, n, N, X[N][n], G[N][n])                              */
+/* (N points in few sweeps, defined in tape_batch.c)                        */
+ADOLC_DLL_EXPORT int gradient_batch(short,int,int,double**,double**);
+
 /*--------------------------------------------------------------------------*/
 /*                                                                 jacobian */
 /* jacobian(tag, m, n, x[n], J[m][n])                                       */
@@ -194,6 +194,10 @@ ADOLC_DLL_EXPORT int zos_forward_nk(short,int,int,const double*,double*);
 
 ADOLC_DLL_EXPORT int zos_forward_partx(short,int,int,int*,double**,double*);
 
+/* zos_forward_batch(tag, m, n, N, X[N][n], Y[N][m])                        */
+/* (N points in few sweeps, defined in tape_batch.c)                        */
+ADOLC_DLL_EXPORT int zos_forward_batch(short,int,int,int,double**,double**);
+
 /*--------------------------------------------------------------------------*/
 /*                                                                      FOS */
 /* fos_forward(tag, m, n, keep, x[n], X[n], y[m], Y[m])                     */
@@ -32,6 +32,10 @@ typedef double revreal;
 /* Enable/disable advanced branching */
 #undef ADOLC_ADVANCED_BRANCHING
 
+/*--------------------------------------------------------------------------*/
+/* Every thread gets its own ADOL-C environment */
+#undef ADOLC_THREADLOCAL
+
 /*--------------------------------------------------------------------------*/
 /* Use reference counting for tapeless numbers */
 #undef USE_ADTL_REFCOUNTING
@@ -33,6 +33,28 @@
 /* Number of temporary Taylor stores*/
 #define TBUFNUM    32
 
+/*--------------------------------------------------------------------------*/
+/* Number of buffers per tape stream for asynchronous writing (1 = off) */
+#define IOBUFNUM   1
+
+/*--------------------------------------------------------------------------*/
+/* Bytes of memory for all tapes kept in core (0 = no limit) */
+#define TAPECACHESIZE 0
+
+/*--------------------------------------------------------------------------*/
+/* Encoding of spilled Taylor stacks (0 = off, 1 = drop repeated values,   */
+/* 2 = also store values in single precision)                              */
+#define TAYLORCODEC 0
+
+/*--------------------------------------------------------------------------*/
+/* Access to the tape files (0 = stdio, 1 = pread/pwrite bypassing the     */
+/* page cache, 2 = also O_DIRECT for aligned blocks where available)       */
+#define TAPEIOMODE 0
+
+/*--------------------------------------------------------------------------*/
+/* Decoded first order sweeps over tapes kept in core (0 = off, 1 = on)    */
+#define DECODETAPES 0
+
 /*--------------------------------------------------------------------------*/
 /* Data types used by Fortran callable versions of functions */
 #define fint       long
@@ -67,5 +89,45 @@
 /* fread  --- power of 2 > 8 preferable ;-) ---                             */
 #define ADOLC_IO_CHUNK_SIZE 1073741824
 
+/*--------------------------------------------------------------------------*/
+/* Alignment (Bytes) of tape buffers, file offsets and sizes for O_DIRECT   */
+/* transfers (TAPEIOMODE 2 in .adolcrc), a multiple of the page size        */
+#define ADOLC_IO_ALIGNMENT 4096
+
+/*--------------------------------------------------------------------------*/
+/* Alignment (Bytes) of the instructions of decoded tapes, a cache line     */
+#define ADOLC_DECODE_ALIGNMENT 64
+
+/*--------------------------------------------------------------------------*/
+/* Alignment (Bytes) of the rows of the derivative matrices in vector modes */
+/* (fov_forward, fov_reverse), a multiple of the widest SIMD register       */
+#define ADOLC_VECTOR_ALIGNMENT 64
+
+/*--------------------------------------------------------------------------*/
+/* Minimal number of directions per thread for which fov_forward splits the */
+/* directions of a decoded tape among the threads of an OpenMP team         */
+#define ADOLC_PARALLEL_DIRECTIONS 32
+
+/*--------------------------------------------------------------------------*/
+/* Minimal average number of independent operations per level for which     */
+/* zos_forward and fos_forward split the levels of a decoded tape among the */
+/* threads of an OpenMP team                                                */
+#define ADOLC_PARALLEL_OPS 1024
+
+/*--------------------------------------------------------------------------*/
+/* Compiler and flags building the kernels of tape_codegen, overridden by   */
+/* the environment variables ADOLC_CODEGEN_CC and ADOLC_CODEGEN_FLAGS       */
+#define ADOLC_CODEGEN_CC "cc"
+#define ADOLC_CODEGEN_FLAGS "-O2 -fPIC -shared -ffp-contract=off"
+
+/*--------------------------------------------------------------------------*/
+/* Operations per generated function of tape_codegen                        */
+#define ADOLC_CODEGEN_CHUNK 1000
+
+/*--------------------------------------------------------------------------*/
+/* Points per sweep of the batched drivers zos_forward_batch and            */
+/* gradient_batch                                                           */
+#define ADOLC_BATCH_WIDTH 64
+
 /*--------------------------------------------------------------------------*/
 #endif
@@ -31,9 +31,11 @@ typedef struct {
         int oldfine;
 } revolve_nums;
 
-#ifndef _OPENMP
+/* with ADOLC_THREADLOCAL the counters belong to the environment of each
+ * thread and are not exported */
+#if !defined(_OPENMP) && !defined(ADOLC_THREADLOCAL)
     extern revolve_nums revolve_numbers;
-#else
+#elif defined(_OPENMP)
 #include <omp.h>
     extern revolve_nums *revolve_numbers;
 #endif
@@ -42,6 +42,15 @@ enum StatEntries {
     STAT_SIZE                     /* represents the size of the stats vector */
 };
 
+enum TapeCacheEntries {
+    TAPE_CACHE_HITS,                    /* sweeps over tapes found in core */
+    TAPE_CACHE_MISSES,          /* sweeps over tapes evicted by the cache */
+    TAPE_CACHE_EVICTIONS,                  /* # of tapes moved to disk */
+    TAPE_CACHE_BYTES,                /* bytes currently held by in-core tapes */
+    TAPE_CACHE_BUDGET,                  /* byte budget (0 = no limit) */
+    TAPE_CACHE_STAT_SIZE       /* represents the size of the stats vector */
+};
+
 enum TapeRemovalType {
     ADOLC_REMOVE_FROM_CORE,
     ADOLC_REMOVE_COMPLETELY
@@ -54,10 +63,78 @@ enum LocationMgrType {
 
 ADOLC_DLL_EXPORT void skip_tracefile_cleanup(short tnum);
 
+/* Enables (flag != 0) or disables (flag == 0) memory mapped reading of the
+ * disk based parts of tape "tnum" in forward and reverse sweeps. Without a
+ * call the setting "MMAPTAPE" from .adolcrc is used. */
+ADOLC_DLL_EXPORT void set_tape_mmap(short tnum, int flag);
+
+/* Enables (flag != 0) or disables (flag == 0) the decoded first order
+ * sweeps over tape "tnum" while it is kept in core. Without a call the
+ * setting "DECODETAPES" from .adolcrc is used. */
+ADOLC_DLL_EXPORT void set_tape_decoding(short tnum, int flag);
+
 /* Returns statistics on the tape "tag". Use enumeration StatEntries for
  * accessing the individual elements of the vector "tape_stats"! */
 ADOLC_DLL_EXPORT void tapestats(short tag, size_t *tape_stats);
 
+/* Saves the complete tape "tag" together with a version header and a hash
+ * of its content to the file "path". Returns 0 on success. */
+ADOLC_DLL_EXPORT int save_tape(short tag, const char *path);
+
+/* Restores tape "tag" from the file "path" written by save_tape, possibly in
+ * another run, such that it can be evaluated without retaping. Returns 0 on
+ * success, -1 if the file cannot be read or the tape is being recorded, -2
+ * if it was written by an incompatible library (version, sizes of pointers,
+ * locint and revreal) and -3 if its content is corrupted. */
+ADOLC_DLL_EXPORT int load_tape(short tag, const char *path);
+
+/* Removes the operations from tape "tag" that do not contribute to the
+ * dependents, folds operations on constants, merges repeated computations
+ * of the same expression, fuses products and sums with the following
+ * addition (sums of at most three terms, longer sums stay chains) and
+ * rewrites the tape with the remaining operations,
+ * renumbering the locations such that the sweeps allocate fewer of them
+ * (NUM_MAX_LIVES). The values and derivatives of the dependents are
+ * unchanged up to rounding, taylors kept on the tape are discarded.
+ * Returns the number of removed operations, or -1 if the tape is being
+ * recorded or contains external functions (left unchanged). With
+ * "OPTIMIZETAPES" set in .adolcrc trace_off applies it to every tape
+ * recorded without keep. */
+ADOLC_DLL_EXPORT int optimize_tape(short tag);
+
+/* sweeps tape_codegen translates, to be combined by | */
+enum CodegenModes {
+    ADOLC_CODEGEN_ZOS = 1,            /* zos_forward */
+    ADOLC_CODEGEN_FOS = 2,            /* fos_forward */
+    ADOLC_CODEGEN_FOV = 4,            /* fov_forward */
+    ADOLC_CODEGEN_FOS_REVERSE = 8     /* fos_reverse */
+};
+
+/* Translates tape "tag" into straight-line C for the sweeps selected by
+ * "mode", compiles it into a shared library in the directory "path" and
+ * loads it. Until the tape is rewritten, zos_forward, fos_forward,
+ * fov_forward and fos_reverse on the tape then call the compiled kernels
+ * instead of interpreting the tape. The libraries are named after a hash
+ * of the tape, the modes and the compiler command, so later runs recording
+ * the same tape only load them, after checking that they were built for
+ * it. The compiler and its flags are taken from the environment variables
+ * ADOLC_CODEGEN_CC and ADOLC_CODEGEN_FLAGS (defaults in usrparms.h) and
+ * run without a shell. Returns 0 on success, -1 if the tape is being
+ * recorded, not completely kept in core or contains operations that
+ * cannot be translated, -2 if the code cannot be written or compiled and
+ * -3 if the library cannot be loaded. */
+ADOLC_DLL_EXPORT int tape_codegen(short tag, int mode, const char *path);
+
+/* Limits the memory of all tapes kept in core to "bytes" (0 = no limit).
+ * The least recently used tapes are moved to disk to meet the limit and
+ * read back when they are evaluated again. Without a call the setting
+ * "TAPECACHESIZE" from .adolcrc is used. */
+ADOLC_DLL_EXPORT void set_tape_cache_size(size_t bytes);
+
+/* Returns the counters of the in-core tape cache. Use enumeration
+ * TapeCacheEntries for accessing the elements of "cache_stats"! */
+ADOLC_DLL_EXPORT void tape_cache_stats(size_t *cache_stats);
+
 ADOLC_DLL_EXPORT void set_nested_ctx(short tag, char nested);
 
 ADOLC_DLL_EXPORT char currently_nested(short tag);
@@ -133,6 +133,31 @@ double** myalloc2(size_t m, size_t n) {
     return A;
 }
 
+/*--------------------------------------------------------------------------*/
+double** myalloc2_aligned(size_t m, size_t n) { /* rows aligned for SIMD */
+    double **A=NULL;
+    if (m>0 && n>0)  {
+      size_t i, row, bytes;
+      char *Adum;
+      row = (n*sizeof(double)+ADOLC_VECTOR_ALIGNMENT-1)
+            / ADOLC_VECTOR_ALIGNMENT * ADOLC_VECTOR_ALIGNMENT;
+      bytes = m*row+m*sizeof(double*)+ADOLC_VECTOR_ALIGNMENT;
+      Adum = (char*)ADOLC_MALLOC(bytes,sizeof(char));
+      if (Adum == NULL) {
+        fprintf(DIAG_OUT,"ADOL-C error: myalloc2_aligned cannot allocate %zd bytes\n",
+                bytes);
+        adolc_exit(-1,"",__func__,__FILE__,__LINE__);
+      }
+      A = (double**)Adum;
+      Adum += m*sizeof(double*);
+      Adum += (ADOLC_VECTOR_ALIGNMENT
+               - (size_t)Adum % ADOLC_VECTOR_ALIGNMENT) % ADOLC_VECTOR_ALIGNMENT;
+      for (i=0; i<m; i++)
+        A[i] = (double*)(Adum+i*row);
+    }
+    return A;
+}
+
 /*--------------------------------------------------------------------------*/
 double*** myalloc3(size_t m, size_t n, size_t p) { /* This function allocates 3-tensors contiguously */
     double  ***A = NULL;
@@ -26,10 +26,10 @@
 #include <stack>
 using namespace std;
 
-ADOLC_BUFFER_TYPE ADOLC_EXT_DIFF_FCTS_BUFFER_DECL;
+ADOLC_THREAD_LOCAL ADOLC_BUFFER_TYPE ADOLC_EXT_DIFF_FCTS_BUFFER_DECL;
 
 /* field of pointers to the value fields of a checkpoint */
-stack<StackElement> ADOLC_CHECKPOINTS_STACK_DECL;
+ADOLC_THREAD_LOCAL stack<StackElement> ADOLC_CHECKPOINTS_STACK_DECL;
 
 /* forward function declarations */
 void init_edf(ext_diff_fct *edf);
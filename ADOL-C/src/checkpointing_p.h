@@ -40,11 +40,11 @@ END_C_DECLS
 #if defined(__cplusplus)
 
 #define ADOLC_BUFFER_TYPE Buffer< CpInfos, CP_BLOCK_SIZE >
-extern ADOLC_BUFFER_TYPE ADOLC_EXT_DIFF_FCTS_BUFFER_DECL;
+extern ADOLC_THREAD_LOCAL ADOLC_BUFFER_TYPE ADOLC_EXT_DIFF_FCTS_BUFFER_DECL;
 
 /* field of pointers to the value fields of a checkpoint */
 typedef double **StackElement;
-extern stack<StackElement> ADOLC_CHECKPOINTS_STACK_DECL;
+extern ADOLC_THREAD_LOCAL stack<StackElement> ADOLC_CHECKPOINTS_STACK_DECL;
 
 /* a cleanup function */
 void cp_clearStack();
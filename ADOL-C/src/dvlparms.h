@@ -26,6 +26,7 @@
 #define ADOLC_VALUES_NAME     "ADOLC-Values_"
 #define ADOLC_LOCATIONS_NAME  "ADOLC-Locations_"
 #define ADOLC_OPERATIONS_NAME "ADOLC-Operations_"
+#define ADOLC_CONTAINER_NAME  "ADOLC-Tape_"
 
 #ifdef _WINDOWS
 #define PATHSEPARATOR         "\\"
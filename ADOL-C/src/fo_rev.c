@@ -105,6 +105,13 @@ results   Taylor-Jacobians       ------------          Taylor Jacobians
 #error Error ! Define [_FOS_ | _FOV_ | _INT_REV_SAFE_ | _INT_REV_TIGHT_ ]
 #endif
 #endif
+
+/*--------------------------------------------------------------------------*/
+/*                                                    decoded in-core tapes */
+#if (defined(_FOS_) || defined(_FOV_)) && \
+    !defined(_ABS_NORM_) && !defined(_ABS_NORM_SIG_)
+#define _DECODED_
+#endif
 /*--------------------------------------------------------------------------*/
 /*                                                     access to variables  */
 
@@ -345,12 +352,15 @@ int int_reverse_safe(
     revreal aTmp;
 #endif
 #ifdef _FOV_
-    revreal **rpp_A, *Aqo;
+    revreal **rpp_A;
     revreal aTmp;
 #endif
 #if !defined(_NTIGHT_)
     revreal *rp_T;
 #endif /* !_NTIGHT_ */
+#if defined(_DECODED_)
+    struct DecodedTape *decodedTape;
+#endif
 #if !defined _INT_REV_
     revreal  *Ares, *Aarg, *Aarg1, *Aarg2;
 #else
@@ -504,15 +514,10 @@ int int_reverse_safe(
     /*--------------------------------------------------------------------------*/
 #else
 #if defined _FOV_                                                          /* FOV */
-    rpp_A = (revreal**)malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES] *
-            sizeof(revreal*));
+    /* rows start at multiples of ADOLC_VECTOR_ALIGNMENT for the SIMD loops */
+    rpp_A = (revreal**)myalloc2_aligned(
+            ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES], p);
     if (rpp_A == NULL) fail(ADOLC_MALLOC_FAILED);
-    Aqo = (revreal*)malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES] * p *
-            sizeof(revreal));
-    if (Aqo == NULL) fail(ADOLC_MALLOC_FAILED);
-    for (j=0; j<ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES]; j++) {
-        rpp_A[j] = Aqo + j*p;
-    }
     ADOLC_CURRENT_TAPE_INFOS.rpp_A = rpp_A;
     rp_T = (revreal *)malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES] *
             sizeof(revreal));
@@ -574,6 +579,24 @@ int int_reverse_safe(
 
     /****************************************************************************/
     /*                                                            REVERSE SWEEP */
+#if defined(_DECODED_)
+    /* tapes compiled by tape_codegen run their kernel, other tapes kept in
+     * core completely are swept over their decoded form */
+#if defined(_FOS_)
+    if (fos_reverse_compiled(lagrange, results, rp_T, rp_A))
+        operation = start_of_tape;
+    else
+#endif
+    if ((decodedTape = get_decoded_tape()) != NULL) {
+#if defined(_FOS_)
+        fos_reverse_decoded(decodedTape, lagrange, results, rp_T, rp_A);
+#else
+        fov_reverse_parallel_decoded(decodedTape, p, lagrange, results,
+                                     rp_T, rpp_A);
+#endif
+        operation = start_of_tape;
+    } else
+#endif
     operation=get_op_r();
     while (operation != start_of_tape) { /* Switch statement to execute the operations in Reverse */
 
@@ -663,7 +686,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -685,7 +708,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -710,7 +733,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
                 /*--------------------------------------------------------------------------*/
@@ -728,7 +751,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -747,7 +770,7 @@ int int_reverse_safe(
                     RESULTS(l,indexi) = ARES_INC;
                 }
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 indexi--;
                 break;
@@ -789,7 +812,7 @@ int int_reverse_safe(
 #if !defined(_NTIGHT_)
                 coval = get_val_r();
 
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -801,7 +824,7 @@ int int_reverse_safe(
 #if !defined(_NTIGHT_)
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -822,7 +845,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -833,7 +856,7 @@ int int_reverse_safe(
 #if !defined(_NTIGHT_)
                 coval = get_val_r();
 
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                break;
 
@@ -845,7 +868,7 @@ int int_reverse_safe(
 #if !defined(_NTIGHT_)
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                break;
 
@@ -866,7 +889,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-               ADOLC_GET_TAYLOR(res);
+               ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -886,7 +909,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -907,7 +930,7 @@ int int_reverse_safe(
 #endif
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -942,7 +965,7 @@ int int_reverse_safe(
                 res   = get_locint_r();
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -974,7 +997,39 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
+#endif /* !_NTIGHT_ */
+                break;
+
+                /*--------------------------------------------------------------------------*/
+            case plus_a_a_a:         /* Add three adoubles, fused      plus_a_a_a */
+                res  = get_locint_r();
+                arg  = get_locint_r();
+                arg2 = get_locint_r();
+                arg1 = get_locint_r();
+
+                ASSIGN_A( Ares,  ADJOINT_BUFFER[res])
+                ASSIGN_A( Aarg1, ADJOINT_BUFFER[arg1])
+                ASSIGN_A( Aarg2, ADJOINT_BUFFER[arg2])
+                ASSIGN_A( Aarg,  ADJOINT_BUFFER[arg])
+
+                FOR_0_LE_l_LT_p
+                { aTmp = ARES;
+#if defined(_INT_REV_)
+                  ARES_INC = 0;
+                  AARG1_INC |= aTmp;
+                  AARG2_INC |= aTmp;
+                  AARG_INC |= aTmp;
+#else
+                  ARES_INC = 0.0;
+                  AARG1_INC += aTmp;
+                  AARG2_INC += aTmp;
+                  AARG_INC += aTmp;
+#endif
+            }
+
+#if !defined(_NTIGHT_)
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1002,7 +1057,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1032,7 +1087,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1061,7 +1116,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1089,7 +1144,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1203,7 +1258,39 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
+#endif /* !_NTIGHT_ */
+                break;
+
+                /*--------------------------------------------------------------------------*/
+            case axpy_d_a:     /* Add a multiple of an adouble to     axpy_d_a */
+                /* an adouble, fused (* +) */
+                res  = get_locint_r();
+                arg2 = get_locint_r();
+                arg1 = get_locint_r();
+#if !defined(_NTIGHT_)
+                coval = get_val_r();
+#endif /* !_NTIGHT_ */
+
+                ASSIGN_A( Ares,  ADJOINT_BUFFER[res])
+                ASSIGN_A( Aarg1, ADJOINT_BUFFER[arg1])
+                ASSIGN_A( Aarg2, ADJOINT_BUFFER[arg2])
+
+                FOR_0_LE_l_LT_p
+                { aTmp = ARES;
+#if defined(_INT_REV_)
+                  ARES_INC = 0;
+                  AARG1_INC |= aTmp;
+                  AARG2_INC |= aTmp;
+#else
+                  ARES_INC = 0.0;
+                  AARG1_INC += (aTmp==0)?0:(coval * aTmp);
+                  AARG2_INC += aTmp;
+#endif
+            }
+
+#if !defined(_NTIGHT_)
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1232,7 +1319,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1370,7 +1457,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -1394,7 +1481,7 @@ int int_reverse_safe(
             }
 
 #if !defined(_NTIGHT_)
-                ADOLC_GET_TAYLOR(res);
+                ADOLC_GET_TAYLOR_LINEAR(res);
 #endif /* !_NTIGHT_ */
                 break;
 
@@ -3356,8 +3443,7 @@ int int_reverse_safe(
     free(rp_A);
 #endif
 #ifdef _FOV_
-    free(Aqo);
-    myfree2(rpp_A);
+    myfree2((double**)rpp_A);
 #endif
 #ifdef _INT_REV_
     free(upp_A);
@@ -562,6 +562,13 @@ int hov_ti_reverse(
         adolc_exit(-2,"",__func__,__FILE__,__LINE__);
     };
 
+    if (ADOLC_CURRENT_TAPE_INFOS.tayKeepSelective) {
+        fprintf(DIAG_OUT,"\n ADOL-C error: higher order reverse needs the"
+                " complete taylor stack,\nwhich is not written by"
+                " zos_forward with SELECTIVETAYLORS!\n");
+        adolc_exit(-2,"",__func__,__FILE__,__LINE__);
+    }
+
     if((numdep != depen)||(numind != indep)) {
         fprintf(DIAG_OUT,"\n ADOL-C error: reverse fails on tape %d because "
                 "the number of\nindependent and/or dependent variables"
@@ -977,6 +984,45 @@ int hov_ti_reverse(
                 GET_TAYL(res,k,p)
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case plus_a_a_a:         /* Add three adoubles, fused      plus_a_a_a */
+                res  = get_locint_r();
+                arg  = get_locint_r();
+                arg2 = get_locint_r();
+                arg1 = get_locint_r();
+
+                ASSIGN_A(Ares,  rpp_A[res])
+                ASSIGN_A(Aarg1, rpp_A[arg1])
+                ASSIGN_A(Aarg2, rpp_A[arg2])
+                ASSIGN_A(Aarg,  rpp_A[arg])
+
+                FOR_0_LE_l_LT_p
+                if  (0 == ARES) {
+                    HOV_INC(Ares,  k1)
+                    HOV_INC(Aarg1, k1)
+                    HOV_INC(Aarg2, k1)
+                    HOV_INC(Aarg,  k1)
+                } else {
+                    aTmp = ARES;
+                    ARES_INC = 0.0;
+                    MAXDEC(AARG1,aTmp);
+                    MAXDEC(AARG2,aTmp);
+                    MAXDEC(AARG,aTmp);
+                    AARG_INC_O;
+                    AARG2_INC_O;
+                    AARG1_INC_O;
+                    FOR_0_LE_i_LT_k
+                    { aTmp = ARES;
+                      ARES_INC = 0.0;
+                      AARG1_INC += aTmp;
+                      AARG2_INC += aTmp;
+                      AARG_INC += aTmp;
+                    }
+                }
+
+                GET_TAYL(res,k,p)
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case plus_a_p:             /* Add an adouble and a double    plus_a_p */
             case min_a_p:                /* Subtract an adouble from a    min_a_p */
@@ -1268,6 +1314,41 @@ int hov_ti_reverse(
                 GET_TAYL(res,k,p)
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case axpy_d_a:     /* Add a multiple of an adouble to     axpy_d_a */
+                /* an adouble, fused (* +) */
+                res   = get_locint_r();
+                arg2  = get_locint_r();
+                arg1  = get_locint_r();
+                coval = get_val_r();
+
+                ASSIGN_A(Ares,  rpp_A[res])
+                ASSIGN_A(Aarg1, rpp_A[arg1])
+                ASSIGN_A(Aarg2, rpp_A[arg2])
+
+                FOR_0_LE_l_LT_p
+                if  (0 == ARES) {
+                    HOV_INC(Ares,  k1)
+                    HOV_INC(Aarg1, k1)
+                    HOV_INC(Aarg2, k1)
+                } else {
+                    aTmp = ARES;
+                    ARES_INC = 0.0;
+                    MAXDEC(AARG1,aTmp);
+                    MAXDEC(AARG2,aTmp);
+                    AARG2_INC_O;
+                    AARG1_INC_O;
+                    FOR_0_LE_i_LT_k
+                    { aTmp = ARES;
+                      ARES_INC = 0.0;
+                      AARG1_INC += coval * aTmp;
+                      AARG2_INC += aTmp;
+                    }
+                }
+
+                GET_TAYL(res,k,p)
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case mult_a_p:         /* Multiply an adouble by a double    mult_a_p */
                 /* (*) */
@@ -152,7 +152,9 @@ enum OPCODES {
   ampi_reduce,
   ampi_allreduce,
   medi_call,
-  cbrt_op
+  cbrt_op,
+  axpy_d_a,
+  plus_a_a_a
 };
 
 /****************************************************************************/
@@ -188,7 +188,9 @@
 
 #define MAXINT 2147483647
 
-#ifndef _OPENMP
+#if defined(ADOLC_THREADLOCAL)
+ADOLC_THREAD_LOCAL revolve_nums *revolve_numbers = NULL;
+#elif !defined(_OPENMP)
 revolve_nums revolve_numbers;
 #else
 revolve_nums *revolve_numbers = NULL;
@@ -0,0 +1,235 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_batch.c
+ Revision: $Id$
+ Contents: sweeps evaluating a tape kept in core at many points at once
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <adolc/interfaces.h>
+#include <adolc/drivers/drivers.h>
+#include "tape_decode.h"
+#include "dvlparms.h"
+
+BEGIN_C_DECLS
+
+/****************************************************************************/
+/* The batched sweeps walk the decoded instructions of a tape once for a    */
+/* batch of up to ADOLC_BATCH_WIDTH points. The values of a location for    */
+/* all points of the batch are stored next to each other, so every          */
+/* operation becomes a loop over the batch the compiler vectorizes, and the */
+/* dispatch per operation is shared by the whole batch. Each point sees the */
+/* same operations in the same order as in the scalar sweeps.               */
+/* For a reverse sweep the forward sweep pushes the overwritten values of   */
+/* the batch onto a stack in core, in the order zos_forward with keep       */
+/* writes them to the taylor stack, and the reverse sweep pops them again.  */
+/****************************************************************************/
+
+#define BATCH_LOOP(statement) \
+    ADOLC_SIMD_LOOP \
+    for (k = 0; k < w; ++k) { statement; }
+
+/* the sweeps of tape_decode_for.c and tape_decode_rev.c, dispatching by a  */
+/* plain switch                                                             */
+#define DISPATCH_TABLE
+#define DISPATCH_OP
+#define OP(op) case op:
+#define NEXT_OP break
+#define END_OF_OPS
+
+#define LOAD_OPERANDS \
+    res = dop->res; \
+    arg = dop->arg; \
+    arg1 = dop->arg1; \
+    arg2 = dop->arg2;
+
+#define KEEP_BATCH(x) \
+    if (S != NULL) { \
+        memcpy(S, T + (x) * stride, w * sizeof(double)); \
+        S += stride; \
+    }
+
+#define GET_BATCH(x) \
+    { \
+        S -= stride; \
+        memcpy(T + (x) * stride, S, w * sizeof(double)); \
+    }
+
+/*--------------------------------------------------------------------------*/
+#define _BATCH_ 1
+#include "tape_decode_for.c"
+#include "tape_decode_rev.c"
+#undef _BATCH_
+
+/*--------------------------------------------------------------------------*/
+/* Allocates the values of "numLives" locations for batches of "width"      */
+/* points, each location starting on a cache line.                          */
+static double *allocBatchStore(size_t numLives, size_t width,
+                               void **memory) {
+    *memory = malloc(numLives * width * sizeof(double) +
+                     ADOLC_DECODE_ALIGNMENT);
+    if (*memory == NULL) fail(ADOLC_MALLOC_FAILED);
+    return (double *)(((size_t)*memory + ADOLC_DECODE_ALIGNMENT - 1)
+                      / ADOLC_DECODE_ALIGNMENT * ADOLC_DECODE_ALIGNMENT);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Returns the number of points per batch for "npts" points and sets the    */
+/* stride of the locations, rounded up to whole cache lines.                */
+static int batchWidth(int npts, size_t *stride) {
+    size_t line = ADOLC_DECODE_ALIGNMENT / sizeof(double);
+    int w = npts < ADOLC_BATCH_WIDTH ? npts : ADOLC_BATCH_WIDTH;
+
+    if (w < 1) w = 1;
+    *stride = (w + line - 1) / line * line;
+    return w;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Returns the number of values zos_forward with keep writes to the taylor  */
+/* stack, per point of a batch.                                             */
+static size_t keptValues(const struct DecodedTape *tape) {
+    const DecodedOp *dop, *end = tape->ops + tape->numOps;
+    size_t count = 0;
+
+    for (dop = tape->ops; dop != end; ++dop)
+        switch (dop->op) {
+            case death_not:
+                count += dop->arg2 - dop->arg1 + 1;
+                break;
+            case take_stock_op:
+            case assign_dep:
+            case eq_plus_prod:
+            case eq_min_prod:
+                break;
+            case sin_op:
+            case cos_op:
+                count += 2;
+                break;
+            case pow_op:
+                count += 1 + (dop->arg == dop->res);
+                break;
+            default:
+                ++count;
+        }
+    return count;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Starts a batched sweep on tape "tnum" after checking the counts, returns */
+/* its decoded instructions or NULL (sweep ended) if there are none.        */
+static struct DecodedTape *init_batch_sweep(short tnum, int depen,
+                                            int indep) {
+    struct DecodedTape *tape;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    init_for_sweep(tnum);
+    if (((size_t)depen != ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS]) ||
+            ((size_t)indep != ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS])) {
+        fprintf(DIAG_OUT,"ADOL-C error: forward sweep on tape %d  aborted!\n"
+                "Number of dependent(%u) and/or independent(%u) variables passed"
+                " to forward is\ninconsistent with number "
+                "recorded on tape (%zu, %zu) \n", tnum,
+                depen, indep,
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS],
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS]);
+        adolc_exit(-1,"",__func__,__FILE__,__LINE__);
+    }
+    tape = decode_current_tape();
+    if (tape == NULL)
+        end_sweep();
+    return tape;
+}
+
+/****************************************************************************/
+/*                                                                  DRIVERS */
+
+/*--------------------------------------------------------------------------*/
+/*                                                                ZOS_BATCH */
+/* zos_forward_batch(tag, m, n, N, X[N][n], Y[N][m])                        */
+int zos_forward_batch(short tnum, int depen, int indep, int npts,
+                      double **X, double **Y) {
+    struct DecodedTape *tape;
+    void *memory;
+    double *T;
+    size_t stride;
+    int i, w, rc, ret_c = 3;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    /* tapes that cannot be decoded are evaluated point by point */
+    tape = init_batch_sweep(tnum, depen, indep);
+    if (tape == NULL) {
+        for (i = 0; i < npts; ++i) {
+            rc = zos_forward(tnum, depen, indep, 0, X[i], Y[i]);
+            if (rc < ret_c) ret_c = rc;
+        }
+        return ret_c;
+    }
+
+    w = batchWidth(npts, &stride);
+    T = allocBatchStore(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES], stride,
+                        &memory);
+    ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_ZOS_FORWARD;
+    for (i = 0; i < npts; i += w) {
+        if (npts - i < w) w = npts - i;
+        zos_forward_batched(tape, w, stride, X + i, Y + i, T, NULL);
+    }
+    free(memory);
+    ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_NO_MODE;
+    end_sweep();
+    return ret_c;
+}
+
+/*--------------------------------------------------------------------------*/
+/*                                                           GRADIENT_BATCH */
+/* gradient_batch(tag, n, N, X[N][n], G[N][n])                              */
+int gradient_batch(short tnum, int indep, int npts, double **X, double **G) {
+    struct DecodedTape *tape;
+    void *memory[4];
+    double *T, *A, *S, *R, *top;
+    size_t stride, numLives;
+    int i, w, rc, ret_c = 3;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    /* tapes that cannot be decoded are differentiated point by point */
+    tape = init_batch_sweep(tnum, 1, indep);
+    if (tape == NULL) {
+        for (i = 0; i < npts; ++i) {
+            rc = gradient(tnum, indep, X[i], G[i]);
+            if (rc < ret_c) ret_c = rc;
+        }
+        return ret_c;
+    }
+
+    w = batchWidth(npts, &stride);
+    numLives = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES];
+    T = allocBatchStore(numLives, stride, &memory[0]);
+    A = allocBatchStore(numLives, stride, &memory[1]);
+    S = allocBatchStore(keptValues(tape), stride, &memory[2]);
+    R = allocBatchStore(2, stride, &memory[3]);
+    ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_FOS_REVERSE;
+    for (i = 0; i < npts; i += w) {
+        if (npts - i < w) w = npts - i;
+        top = zos_forward_batched(tape, w, stride, X + i, NULL, T, S);
+        memset(A, 0, numLives * stride * sizeof(double));
+        fos_reverse_batched(tape, w, stride, G + i, T, A, top, R);
+    }
+    for (i = 0; i < 4; ++i)
+        free(memory[i]);
+    ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_NO_MODE;
+    end_sweep();
+    return ret_c;
+}
+
+END_C_DECLS
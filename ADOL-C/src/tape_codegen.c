@@ -0,0 +1,791 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_codegen.c
+ Revision: $Id$
+ Contents: translation of tapes into straight-line C, compiled with the
+           system compiler and loaded at runtime
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tape_decode.h"
+#include "tape_rules.h"
+#include "dvlparms.h"
+
+#if defined(HAVE_DLFCN_H) && !defined(_WINDOWS)
+#include <dlfcn.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define ADOLC_HAVE_DLOPEN 1
+extern char **environ;
+#endif
+
+/****************************************************************************/
+/* tape_codegen writes one C statement per instruction of the decoded tape  */
+/* for each selected sweep. The statements are macros defined at the head   */
+/* of the file, whose bodies are the rules of tape_rules.h the decoded      */
+/* sweeps are made of, invoked with the locations, constants and indices of */
+/* the operation as literals. The compiled sweeps thus compute the same     */
+/* values in the same order and keep or read the same taylor stack. Each    */
+/* generated function stages its taylors in a scratch array, in the order   */
+/* they are kept or restored, and moves them to or from the taylor buffer   */
+/* in one loop.                                                             */
+/* The generated functions hold ADOLC_CODEGEN_CHUNK operations each, which  */
+/* keeps the compile time of long tapes about linear.                       */
+/****************************************************************************/
+
+#define ADOLC_CODEGEN_VERSION 3
+
+/*--------------------------------------------------------------------------*/
+/* The taylor stack as seen by the generated sweeps, which declare the same */
+/* structure                                                                */
+typedef struct {
+    revreal **tay;                         /* current position in the buffer */
+    revreal **bound;      /* end of the buffer forward, its start in reverse */
+    void (*block)(void);           /* writes or reads the next buffer block */
+    revreal *scratch;   /* taylors of one generated function, fos_forward */
+    unsigned long size;      /* stages its tangents "size" entries further */
+} TaylorStack;
+
+typedef void (*ZosKernel)(int keep, const double *x, double *y, double *T,
+                          const revreal *P, const TaylorStack *S);
+typedef void (*FosKernel)(int keep, const double *x, const double *xd,
+                          double *y, double *yd, double *T, double *D,
+                          const revreal *P, const TaylorStack *S);
+typedef void (*FovKernel)(int p, const double *x, double **X, double *y,
+                          double **Y, double *T, double **V,
+                          const revreal *P);
+typedef void (*FosReverseKernel)(int nested, double *u, double *z,
+                                 revreal *T, revreal *A, const revreal *P,
+                                 const TaylorStack *S);
+
+struct CompiledTape {
+    void *library;
+    revreal *scratch;
+    unsigned long scratchSize;
+    ZosKernel zos;
+    FosKernel fos;
+    FovKernel fov;
+    FosReverseKernel fosReverse;
+};
+
+/****************************************************************************/
+/*                                                        RUNTIME CALLBACKS */
+
+static void putTaylorBlock(void) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    put_tay_block(ADOLC_CURRENT_TAPE_INFOS.lastTayP1);
+}
+
+/*--------------------------------------------------------------------------*/
+static void initTaylorStack(TaylorStack *stack,
+                            const struct CompiledTape *compiled,
+                            int reverse) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    stack->tay = &ADOLC_CURRENT_TAPE_INFOS.currTay;
+    if (reverse) {
+        stack->bound = &ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
+        stack->block = get_tay_block_r;
+    } else {
+        stack->bound = &ADOLC_CURRENT_TAPE_INFOS.lastTayP1;
+        stack->block = putTaylorBlock;
+    }
+    stack->scratch = compiled->scratch;
+    stack->size = compiled->scratchSize;
+}
+
+#if defined(ADOLC_HAVE_DLOPEN)
+/*--------------------------------------------------------------------------*/
+/* Statement macros of the generated sweeps, the rules of tape_rules.h with */
+/* the accessors of the generated code expanded and written as strings.     */
+/* They take the result, the arguments, the constant or parameter and the   */
+/* index of the independent or dependent of an operation. K_ stages the     */
+/* taylors of a function, k_ counts them.                                   */
+#define RULE_STRING(...) RULE_STRING2(__VA_ARGS__)
+#define RULE_STRING2(...) #__VA_ARGS__
+#define RULE_PARAMS "(res,arg,arg1,arg2,coval,indexi,indexd) "
+
+#define RESTORE_THREAD
+#define TV(x) T[x]
+#define XV(i) x[i]
+#define YV(i) y[i]
+#define HAS_YV (y != 0)
+#define VALUE(s) s;
+
+#define HAS_YD 0
+#define SCALAR(s)
+#define TANGENT(s)
+#define TANGENT_SERIAL(s)
+#define TANGENT_BRANCH(c, s, t)
+#define KEEPING 1
+#define KEEP(x) K_[k_++] = T[x];
+#define ZOS_RULE(op) \
+    "#define Z_" #op RULE_PARAMS RULE_STRING(FOR_##op) "\n"
+static const char zosMacros[] = DECODED_OPS(ZOS_RULE);
+#undef HAS_YD
+#undef SCALAR
+#undef TANGENT
+#undef TANGENT_SERIAL
+#undef TANGENT_BRANCH
+#undef KEEP
+
+#define TD(x) D[x]
+#define XD(i) xd[i]
+#define YD(i) yd[i]
+#define HAS_YD (yd != 0)
+#define SCALAR(s) s;
+#define TANGENT(s) s;
+#define TANGENT_SERIAL(s) { s; }
+#define TANGENT_BRANCH(c, s, t) if (c) { s; } else { t; }
+#define KEEP(x) K_[k_] = T[x]; KD_[k_++] = D[x];
+#define FOS_RULE(op) \
+    "#define F_" #op RULE_PARAMS RULE_STRING(FOR_##op) "\n"
+static const char fosMacros[] = DECODED_OPS(FOS_RULE);
+#undef TD
+#undef XD
+#undef YD
+#undef HAS_YD
+#undef TANGENT
+#undef TANGENT_SERIAL
+#undef TANGENT_BRANCH
+#undef KEEPING
+#undef KEEP
+
+#define TD(x) V[x][l]
+#define XD(i) X[i][l]
+#define YD(i) Y[i][l]
+#define HAS_YD (Y != 0)
+#define TANGENT(s) for (l = 0; l < p; ++l) { s; }
+#define TANGENT_SERIAL(s) for (l = 0; l < p; ++l) { s; }
+#define TANGENT_BRANCH(c, s, t) \
+    if (c) { TANGENT_SERIAL(s) } else { TANGENT(t) }
+#define KEEPING 0
+#define KEEP(x)
+#define FOV_RULE(op) \
+    "#define V_" #op RULE_PARAMS RULE_STRING(FOR_##op) "\n"
+static const char fovMacros[] = DECODED_OPS(FOV_RULE);
+#undef RESTORE_THREAD
+#undef TV
+#undef XV
+#undef YV
+#undef HAS_YV
+#undef VALUE
+#undef TD
+#undef XD
+#undef YD
+#undef HAS_YD
+#undef SCALAR
+#undef TANGENT
+#undef TANGENT_SERIAL
+#undef TANGENT_BRANCH
+#undef KEEPING
+#undef KEEP
+
+#define RV(x) T[x]
+#define RA(x) A[x]
+#define AREAL revreal
+#define ADJOINT(s) { s; }
+#define PARTIAL(s) { s; }
+#define P0 r0
+#define P1 r_0
+#define RESTORE(x) T[x] = K_[k_++];
+#define RESTORE_LINEAR(x) RESTORE(x)
+#define RESULT(i) z[i]
+#define RESULT_NESTED(i) z[i]
+#define LAGRANGE(d) u[d]
+#define LAGRANGE_NESTED(d) u[d]
+#define LAGRANGE_CLEAR(d) u[d] = 0.0
+#define FOS_REVERSE_RULE(op) \
+    "#define R_" #op RULE_PARAMS RULE_STRING(REV_##op) "\n"
+static const char fosReverseMacros[] = DECODED_OPS(FOS_REVERSE_RULE);
+#undef RV
+#undef RA
+#undef AREAL
+#undef ADJOINT
+#undef PARTIAL
+#undef P0
+#undef P1
+#undef RESTORE
+#undef RESTORE_LINEAR
+#undef RESULT
+#undef RESULT_NESTED
+#undef LAGRANGE
+#undef LAGRANGE_NESTED
+#undef LAGRANGE_CLEAR
+
+/*--------------------------------------------------------------------------*/
+/* The generated sweeps */
+typedef struct {
+    int mode;                                        /* CodegenModes entry */
+    const char *name;                             /* name of the functions */
+    const char *prefix;                               /* of the statements */
+    const char *macros;
+    const char *params;          /* parameters of the generated functions */
+    const char *args;
+    const char *prologue;  /* of a function, given its number of taylors */
+    const char *epilogue;
+    char reverse;
+} CodegenSweep;
+
+static const CodegenSweep codegenSweeps[] = {
+    { ADOLC_CODEGEN_ZOS, "zos_forward", "Z_", zosMacros,
+      "int keep, const double *x, double *y, double *T, const revreal *P, "
+      "const TaylorStack *S",
+      "keep, x, y, T, P, S",
+      "    revreal *K_ = S->scratch;\n    unsigned long j, k_ = 0;\n",
+      "    if (keep) pushTaylors(S, K_, 0, %luUL);\n", 0 },
+    { ADOLC_CODEGEN_FOS, "fos_forward", "F_", fosMacros,
+      "int keep, const double *x, const double *xd, double *y, double *yd, "
+      "double *T, double *D, const revreal *P, const TaylorStack *S",
+      "keep, x, xd, y, yd, T, D, P, S",
+      "    revreal *K_ = S->scratch, *KD_ = S->scratch + S->size;\n"
+      "    unsigned long j, k_ = 0;\n    double r0, r_0;\n",
+      "    if (keep) pushTaylors(S, K_, keep > 1 ? KD_ : 0, %luUL);\n", 0 },
+    { ADOLC_CODEGEN_FOV, "fov_forward", "V_", fovMacros,
+      "int p, const double *x, double **X, double *y, double **Y, "
+      "double *T, double **V, const revreal *P",
+      "p, x, X, y, Y, T, V, P",
+      "    unsigned long j;\n    int l;\n    double r0, r_0;\n", "", 0 },
+    { ADOLC_CODEGEN_FOS_REVERSE, "fos_reverse", "R_", fosReverseMacros,
+      "int nested, double *u, double *z, revreal *T, revreal *A, "
+      "const revreal *P, const TaylorStack *S",
+      "nested, u, z, T, A, P, S",
+      "    revreal *K_ = S->scratch;\n    unsigned long j, k_ = 0;\n"
+      "    double r0, r_0;\n    popTaylors(S, K_, %luUL);\n",
+      "", 1 }
+};
+
+#define NUM_CODEGEN_SWEEPS (sizeof(codegenSweeps) / sizeof(CodegenSweep))
+
+#define OP_NAME(op) [op] = #op,
+static const char *const opNames[256] = { DECODED_OPS(OP_NAME) };
+
+/*--------------------------------------------------------------------------*/
+/* Writes the constant "c" as an exact C expression */
+static void formatConstant(char *buf, double c) {
+    if (c != c)
+        strcpy(buf, "make_nan()");
+    else if (c == HUGE_VAL)
+        strcpy(buf, "HUGE_VAL");
+    else if (c == -HUGE_VAL)
+        strcpy(buf, "-HUGE_VAL");
+    else
+        sprintf(buf, "%a", c);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Number of taylors an operation keeps forward and restores in reverse */
+static size_t taylorCount(const DecodedOp *dop) {
+    switch (dop->op) {
+        case death_not:
+            return dop->arg1 <= dop->arg2 ? dop->arg2 - dop->arg1 + 1 : 0;
+        case take_stock_op:
+        case assign_dep:
+        case eq_plus_prod:
+        case eq_min_prod:
+            return 0;
+        case sin_op:
+        case cos_op:
+            return 2;
+        case pow_op:
+            return dop->arg == dop->res ? 2 : 1;
+        default:
+            return 1;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+/* Writes one statement, "c" is the constant or parameter operand and      */
+/* "index" the one of the independent or dependent                         */
+static void writeStatement(FILE *file, const CodegenSweep *sweep,
+                           const DecodedOp *dop, locint res, const char *c,
+                           size_t index) {
+    fprintf(file, "    %s%s(%lu,%lu,%lu,%lu,(%s),%lu,%lu)\n", sweep->prefix,
+            opNames[dop->op], (unsigned long)res, (unsigned long)dop->arg,
+            (unsigned long)dop->arg1, (unsigned long)dop->arg2, c,
+            (unsigned long)index, (unsigned long)index);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Writes the statements of operation "dop" in "sweep", "indexi" and        */
+/* "indexd" count the independents and dependents in the direction of the  */
+/* sweep.                                                                   */
+static void writeOperation(FILE *file, const CodegenSweep *sweep,
+                           const struct DecodedTape *tape,
+                           const DecodedOp *dop, size_t *indexi,
+                           size_t *indexd) {
+    char c[64];
+    size_t index = 0;
+    locint j;
+
+    strcpy(c, "0");
+    switch (dop->op) {
+        case take_stock_op:
+            for (j = 0; j < dop->arg; ++j) {
+                formatConstant(c, tape->vals[dop->val + j]);
+                writeStatement(file, sweep, dop, dop->res + j, c, 0);
+            }
+            return;
+        case assign_ind:
+            if (sweep->reverse) --*indexi;
+            index = *indexi;
+            if (!sweep->reverse) ++*indexi;
+            break;
+        case assign_dep:
+            if (sweep->reverse) --*indexd;
+            index = *indexd;
+            if (!sweep->reverse) ++*indexd;
+            break;
+        case assign_d:
+        case eq_plus_d:
+        case eq_min_d:
+        case eq_mult_d:
+        case plus_d_a:
+        case min_d_a:
+        case mult_d_a:
+        case div_d_a:
+        case axpy_d_a:
+        case pow_op:
+            formatConstant(c, tape->vals[dop->val]);
+            break;
+        case assign_p:
+        case neg_sign_p:
+        case recipr_p:
+        case eq_plus_p:
+        case eq_min_p:
+        case eq_mult_p:
+            sprintf(c, "(double)P[%lu]", (unsigned long)dop->arg);
+            break;
+        case plus_a_p:
+        case min_a_p:
+        case mult_a_p:
+        case div_p_a:
+            sprintf(c, "(double)P[%lu]", (unsigned long)dop->arg1);
+            break;
+    }
+    writeStatement(file, sweep, dop, dop->res, c, index);
+}
+
+/*--------------------------------------------------------------------------*/
+/* Number of taylors of the operations first to last - 1 */
+static size_t chunkTaylors(const struct DecodedTape *tape, size_t first,
+                           size_t last) {
+    size_t i, count = 0;
+
+    for (i = first; i < last; ++i)
+        count += taylorCount(tape->ops + i);
+    return count;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Writes a sweep as one function per ADOLC_CODEGEN_CHUNK operations, the   */
+/* same operations in both directions. Each function keeps or restores its  */
+/* taylors through the scratch array in one go.                            */
+static void writeSweep(FILE *file, const CodegenSweep *sweep,
+                       const struct DecodedTape *tape, size_t numInd,
+                       size_t numDep) {
+    size_t i, j, c, first, last, count, indexi, indexd;
+    size_t numChunks = (tape->numOps + ADOLC_CODEGEN_CHUNK - 1) /
+                       ADOLC_CODEGEN_CHUNK;
+    const DecodedOp *dop;
+
+    fprintf(file, "\n/* %s */\n%s", sweep->name, sweep->macros);
+    indexi = sweep->reverse ? numInd : 0;
+    indexd = sweep->reverse ? numDep : 0;
+    for (i = 0; i < numChunks; ++i) {
+        c = sweep->reverse ? numChunks - 1 - i : i;
+        first = c * ADOLC_CODEGEN_CHUNK;
+        last = first + ADOLC_CODEGEN_CHUNK;
+        if (last > tape->numOps) last = tape->numOps;
+        count = chunkTaylors(tape, first, last);
+        fprintf(file, "static NOINLINE void %s_%lu(%s) {\n", sweep->name,
+                (unsigned long)c, sweep->params);
+        fprintf(file, sweep->prologue, (unsigned long)count);
+        for (j = 0; j < last - first; ++j) {
+            dop = sweep->reverse ? tape->ops + last - 1 - j
+                                 : tape->ops + first + j;
+            writeOperation(file, sweep, tape, dop, &indexi, &indexd);
+        }
+        fprintf(file, sweep->epilogue, (unsigned long)count);
+        fprintf(file, "}\n");
+    }
+    fprintf(file, "void adolc_%s(%s) {\n", sweep->name, sweep->params);
+    for (i = 0; i < numChunks; ++i)
+        fprintf(file, "    %s_%lu(%s);\n", sweep->name,
+                (unsigned long)(sweep->reverse ? numChunks - 1 - i : i),
+                sweep->args);
+    fprintf(file, "}\n");
+}
+
+/*--------------------------------------------------------------------------*/
+/* Largest number of taylors of a generated function */
+static size_t scratchSize(const struct DecodedTape *tape) {
+    size_t first, last, count, size = 0;
+
+    for (first = 0; first < tape->numOps; first = last) {
+        last = first + ADOLC_CODEGEN_CHUNK;
+        if (last > tape->numOps) last = tape->numOps;
+        count = chunkTaylors(tape, first, last);
+        if (count > size) size = count;
+    }
+    return size;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Writes the C file for the sweeps in "mode", returns 0 on failure. The    */
+/* library exports "check", which loadKernels compares with that expected. */
+static int writeKernels(const char *fileName, const struct DecodedTape *tape,
+                        int mode, const unsigned long long *check) {
+    FILE *file;
+    size_t i;
+    int ok;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if ((file = fopen(fileName, "w")) == NULL) return 0;
+    fprintf(file,
+            "/* generated by ADOL-C tape_codegen, tape hash %016llx */\n"
+            "#include <math.h>\n"
+            "typedef %s revreal;\n"
+            "typedef struct {\n"
+            "    revreal **tay, **bound;\n"
+            "    void (*block)(void);\n"
+            "    revreal *scratch;\n"
+            "    unsigned long size;\n"
+            "} TaylorStack;\n"
+            "const unsigned long long adolc_tape_check[4] = "
+            "{0x%016llxULL, %lluULL, %lluULL, %lluULL};\n"
+            "const unsigned long adolc_taylor_scratch = %luUL;\n"
+            "#if defined(__GNUC__)\n"
+            "#define NOINLINE __attribute__((noinline))\n"
+            "#else\n"
+            "#define NOINLINE\n"
+            "#endif\n"
+            "static NOINLINE void pushTaylors(const TaylorStack *S, "
+            "const revreal *K, const revreal *KD, unsigned long n) {\n"
+            "    unsigned long i;\n"
+            "    for (i = 0; i < n; ++i) {\n"
+            "        if (*S->tay == *S->bound) S->block();\n"
+            "        *(*S->tay)++ = K[i];\n"
+            "        if (KD == 0) continue;\n"
+            "        if (*S->tay == *S->bound) S->block();\n"
+            "        *(*S->tay)++ = KD[i];\n"
+            "    }\n"
+            "}\n"
+            "static NOINLINE void popTaylors(const TaylorStack *S, "
+            "revreal *K, unsigned long n) {\n"
+            "    unsigned long i;\n"
+            "    for (i = 0; i < n; ++i) {\n"
+            "        if (*S->tay == *S->bound) S->block();\n"
+            "        K[i] = *--*S->tay;\n"
+            "    }\n"
+            "}\n"
+            "static double make_nan(void) {\n"
+            "    volatile double a = %a, b = %a;\n"
+            "    return a / b;\n"
+            "}\n"
+            "static double make_inf(void) {\n"
+            "    volatile double a = %a, b = %a;\n"
+            "    return a / b;\n"
+            "}\n",
+            check[0], sizeof(revreal) == sizeof(float) ? "float" : "double",
+            check[0], check[1], check[2], check[3],
+            (unsigned long)scratchSize(tape), (double)non_num, (double)non_den, (double)inf_num,
+            (double)inf_den);
+    for (i = 0; i < NUM_CODEGEN_SWEEPS; ++i)
+        if (mode & codegenSweeps[i].mode)
+            writeSweep(file, codegenSweeps + i, tape,
+                       ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS],
+                       ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS]);
+    ok = !ferror(file);
+    if (fclose(file) != 0) ok = 0;
+    return ok;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Hash of everything the generated library depends on */
+static unsigned long long hashKernels(const struct DecodedTape *tape,
+                                      int mode, const char *compiler,
+                                      const char *flags) {
+    unsigned long long hash = ADOLC_HASH_INIT;
+    size_t sizes[4];
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    sizes[0] = ADOLC_CODEGEN_VERSION;
+    sizes[1] = (size_t)mode;
+    sizes[2] = sizeof(revreal);
+    sizes[3] = tape->numOps;
+    hash = hashBytes(hash, sizes, sizeof(sizes));
+    hash = hashBytes(hash, ADOLC_CURRENT_TAPE_INFOS.stats,
+                     TAPE_STAT_SIZE * sizeof(size_t));
+    hash = hashBytes(hash, tape->ops, tape->numOps * sizeof(DecodedOp));
+    hash = hashBytes(hash, tape->vals,
+                     ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] *
+                     sizeof(double));
+    hash = hashBytes(hash, compiler, strlen(compiler));
+    hash = hashBytes(hash, flags, strlen(flags));
+    return hash;
+}
+
+/****************************************************************************/
+/*                                                                  LOADING */
+
+/*--------------------------------------------------------------------------*/
+/* Compiles "cFile" to "libFile", returns 0 on failure. The compiler is run */
+/* directly with the words of "compiler" and "flags" as its arguments,      */
+/* without a shell interpreting them.                                       */
+static int compileKernels(const char *compiler, const char *flags,
+                          const char *cFile, const char *libFile) {
+    char *words, *tmpFile, *word, **argv;
+    size_t length, numWords = 0;
+    pid_t pid, waited;
+    int ok = 0, status;
+
+    length = strlen(compiler) + strlen(flags) + 2;
+    words = (char *)malloc(length);
+    argv = (char **)malloc((length / 2 + 6) * sizeof(char *));
+    tmpFile = (char *)malloc(strlen(libFile) + 32);
+    if (words == NULL || argv == NULL || tmpFile == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    sprintf(words, "%s %s", compiler, flags);
+    for (word = strtok(words, " \t\n"); word != NULL;
+            word = strtok(NULL, " \t\n"))
+        argv[numWords++] = word;
+    /* build under a private name, concurrent runs only see whole files */
+    sprintf(tmpFile, "%s.%ld", libFile, (long)getpid());
+    argv[numWords++] = (char *)"-o";
+    argv[numWords++] = tmpFile;
+    argv[numWords++] = (char *)cFile;
+    argv[numWords++] = (char *)"-lm";
+    argv[numWords] = NULL;
+    if (posix_spawnp(&pid, argv[0], NULL, NULL, argv, environ) == 0) {
+        while ((waited = waitpid(pid, &status, 0)) < 0 && errno == EINTR)
+            ;
+        ok = waited == pid && WIFEXITED(status) &&
+             WEXITSTATUS(status) == 0 && rename(tmpFile, libFile) == 0;
+    }
+    if (!ok) remove(tmpFile);
+    free(words);
+    free(argv);
+    free(tmpFile);
+    return ok;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Loads the kernels for "mode" from "libFile", NULL if one is missing or  */
+/* the library was not generated for "check" (see writeKernels)             */
+static struct CompiledTape *loadKernels(const char *libFile, int mode,
+                                        const unsigned long long *check) {
+    struct CompiledTape *compiled;
+    const unsigned long long *libCheck;
+    const unsigned long *size;
+    void *library;
+
+    if ((library = dlopen(libFile, RTLD_NOW | RTLD_LOCAL)) == NULL)
+        return NULL;
+    libCheck = (const unsigned long long *)dlsym(library, "adolc_tape_check");
+    if (libCheck == NULL || memcmp(libCheck, check, 4 * sizeof(*check)) != 0) {
+        dlclose(library);
+        return NULL;
+    }
+    compiled = (struct CompiledTape *)calloc(1, sizeof(struct CompiledTape));
+    if (compiled == NULL) fail(ADOLC_MALLOC_FAILED);
+    compiled->library = library;
+    if ((size = (const unsigned long *)dlsym(library,
+                                            "adolc_taylor_scratch")) == NULL) {
+        dlclose(library);
+        free(compiled);
+        return NULL;
+    }
+    compiled->scratchSize = *size;
+    compiled->scratch = (revreal *)malloc((2 * *size + 1) * sizeof(revreal));
+    if (compiled->scratch == NULL) fail(ADOLC_MALLOC_FAILED);
+    /* function pointers are taken from dlsym through a union, as ISO C
+     * does not convert between object and function pointers */
+#define LOAD_KERNEL(field, type, symbol, flag) \
+    if (mode & flag) { \
+        union { void *object; type function; } kernel; \
+        kernel.object = dlsym(library, symbol); \
+        if ((compiled->field = kernel.function) == NULL) { \
+            dlclose(library); \
+            free(compiled->scratch); \
+            free(compiled); \
+            return NULL; \
+        } \
+    }
+    LOAD_KERNEL(zos, ZosKernel, "adolc_zos_forward", ADOLC_CODEGEN_ZOS)
+    LOAD_KERNEL(fos, FosKernel, "adolc_fos_forward", ADOLC_CODEGEN_FOS)
+    LOAD_KERNEL(fov, FovKernel, "adolc_fov_forward", ADOLC_CODEGEN_FOV)
+    LOAD_KERNEL(fosReverse, FosReverseKernel, "adolc_fos_reverse",
+                ADOLC_CODEGEN_FOS_REVERSE)
+#undef LOAD_KERNEL
+    return compiled;
+}
+#endif
+
+/*--------------------------------------------------------------------------*/
+void free_compiled_tape(TapeInfos *tapeInfos) {
+    if (tapeInfos->compiledTape != NULL) {
+#if defined(ADOLC_HAVE_DLOPEN)
+        dlclose(tapeInfos->compiledTape->library);
+#endif
+        free(tapeInfos->compiledTape->scratch);
+        free(tapeInfos->compiledTape);
+        tapeInfos->compiledTape = NULL;
+    }
+}
+
+/*--------------------------------------------------------------------------*/
+int tape_codegen(short tag, int mode, const char *path) {
+#if defined(ADOLC_HAVE_DLOPEN)
+    TapeInfos *tapeInfos;
+    struct DecodedTape *tape;
+    struct CompiledTape *compiled = NULL;
+    const char *compiler, *flags;
+    char *cFile, *libFile;
+    unsigned long long check[4];
+    int rc = 0;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    tapeInfos = getTapeInfos(tag);
+    if (tapeInfos->inUse != 0 && tapeInfos->tapingComplete == 0)
+        return -1;                                 /* still being recorded */
+
+    init_for_sweep(tag);
+    if ((tape = decode_current_tape()) == NULL) {
+        end_sweep();
+        return -1;
+    }
+    compiler = getenv("ADOLC_CODEGEN_CC");
+    if (compiler == NULL || *compiler == 0) compiler = ADOLC_CODEGEN_CC;
+    flags = getenv("ADOLC_CODEGEN_FLAGS");
+    if (flags == NULL || *flags == 0) flags = ADOLC_CODEGEN_FLAGS;
+    check[0] = hashKernels(tape, mode, compiler, flags);
+    check[1] = (unsigned long long)mode;
+    check[2] = tape->numOps;
+    check[3] = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES];
+
+    if (path == NULL || *path == 0) path = TAPE_DIR;
+    cFile = (char *)malloc(strlen(path) + 64);
+    libFile = (char *)malloc(strlen(path) + 64);
+    if (cFile == NULL || libFile == NULL) fail(ADOLC_MALLOC_FAILED);
+    sprintf(cFile, "%s" PATHSEPARATOR "adolc_tape_%016llx.c", path, check[0]);
+    sprintf(libFile, "%s" PATHSEPARATOR "adolc_tape_%016llx.so", path,
+            check[0]);
+
+    /* a library built for the same tape by an earlier run is reused, one
+     * that cannot be loaded or was built for another tape is rebuilt */
+    compiled = loadKernels(libFile, mode, check);
+    if (compiled == NULL && (!writeKernels(cFile, tape, mode, check) ||
+            !compileKernels(compiler, flags, cFile, libFile))) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to write or compile %s "
+                "for tape %d!\n", cFile, tag);
+        rc = -2;
+    }
+    if (rc == 0 && compiled == NULL &&
+            (compiled = loadKernels(libFile, mode, check)) == NULL) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to load %s for tape %d!\n",
+                libFile, tag);
+        rc = -3;
+    }
+    if (compiled != NULL) {
+        free_compiled_tape(&ADOLC_CURRENT_TAPE_INFOS);
+        ADOLC_CURRENT_TAPE_INFOS.compiledTape = compiled;
+    }
+    free(cFile);
+    free(libFile);
+    end_sweep();
+    return rc;
+#else
+    fprintf(DIAG_OUT, "ADOL-C warning: tape_codegen needs dlopen, which is "
+            "not available (tape %d)!\n", tag);
+    return -3;
+#endif
+}
+
+/****************************************************************************/
+/*                                                                   SWEEPS */
+
+/*--------------------------------------------------------------------------*/
+int zos_forward_compiled(int keep, const double *basepoint,
+                         double *valuepoint, double *dp_T0) {
+    struct CompiledTape *compiled;
+    TaylorStack stack;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    compiled = ADOLC_CURRENT_TAPE_INFOS.compiledTape;
+    if (compiled == NULL || compiled->zos == NULL) return 0;
+    initTaylorStack(&stack, compiled, 0);
+    compiled->zos(keep, basepoint, valuepoint, dp_T0,
+                  ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore, &stack);
+    return 1;
+}
+
+/*--------------------------------------------------------------------------*/
+int fos_forward_compiled(int keep, const double *basepoint,
+                         const double *argument, double *valuepoint,
+                         double *taylors, double *dp_T0, double *dp_T) {
+    struct CompiledTape *compiled;
+    TaylorStack stack;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    compiled = ADOLC_CURRENT_TAPE_INFOS.compiledTape;
+    if (compiled == NULL || compiled->fos == NULL) return 0;
+    initTaylorStack(&stack, compiled, 0);
+    compiled->fos(keep, basepoint, argument, valuepoint, taylors, dp_T0,
+                  dp_T, ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore,
+                  &stack);
+    return 1;
+}
+
+/*--------------------------------------------------------------------------*/
+int fov_forward_compiled(int p, const double *basepoint, double **argument,
+                         double *valuepoint, double **taylors,
+                         double *dp_T0, double **dpp_T) {
+    struct CompiledTape *compiled;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    compiled = ADOLC_CURRENT_TAPE_INFOS.compiledTape;
+    if (compiled == NULL || compiled->fov == NULL) return 0;
+    compiled->fov(p, basepoint, argument, valuepoint, taylors, dp_T0, dpp_T,
+                  ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore);
+    return 1;
+}
+
+/*--------------------------------------------------------------------------*/
+int fos_reverse_compiled(double *lagrange, double *results, revreal *rp_T,
+                         revreal *rp_A) {
+    struct CompiledTape *compiled;
+    TaylorStack stack;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    compiled = ADOLC_CURRENT_TAPE_INFOS.compiledTape;
+    if (compiled == NULL || compiled->fosReverse == NULL ||
+        ADOLC_CURRENT_TAPE_INFOS.tayKeepSelective)
+        return 0;
+    initTaylorStack(&stack, compiled, 1);
+    compiled->fosReverse(ADOLC_CURRENT_TAPE_INFOS.in_nested_ctx, lagrange,
+                         results, rp_T, rp_A,
+                         ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore,
+                         &stack);
+    return 1;
+}
@@ -0,0 +1,889 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_decode.c
+ Revision: $Id$
+ Contents: decoded first order sweeps over tapes kept in core
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tape_decode.h"
+#include "dvlparms.h"
+
+/****************************************************************************/
+/* A tape completely kept in core is decoded once into an array of fixed    */
+/* width instructions. The sweeps below walk this array instead of the      */
+/* operation, location and value streams, so they neither check for block  */
+/* markers nor move stream cursors per operation. They compute the same     */
+/* values in the same order as the stream sweeps, write and read the same   */
+/* taylor stack, and are used for tapes whose operations they all handle.  */
+/* Their statements are the rules of tape_rules.h, expanded for each mode   */
+/* by tape_decode_for.c and tape_decode_rev.c as uni5_for.c is for the      */
+/* stream sweeps.                                                           */
+/****************************************************************************/
+
+/*--------------------------------------------------------------------------*/
+/* Sets the fields receiving the locations of an operation in the order     */
+/* they are stored. Returns their number, -1 for unsupported operations.    */
+static int decodeFields(unsigned char op, DecodedOp *dop, locint **fields,
+                        size_t *numVals) {
+    *numVals = 0;
+    switch (op) {
+        case assign_ind:
+        case assign_dep:
+        case assign_d_zero:
+        case assign_d_one:
+        case incr_a:
+        case decr_a:
+            fields[0] = &dop->res;
+            return 1;
+        case assign_d:
+        case eq_plus_d:
+        case eq_min_d:
+        case eq_mult_d:
+            fields[0] = &dop->res;
+            *numVals = 1;
+            return 1;
+        case death_not:
+            fields[0] = &dop->arg1;
+            fields[1] = &dop->arg2;
+            return 2;
+        case take_stock_op:        /* constants counted by the first field */
+        case assign_p:
+        case neg_sign_p:
+        case recipr_p:
+        case eq_plus_p:
+        case eq_min_p:
+        case eq_mult_p:
+        case assign_a:
+        case eq_plus_a:
+        case eq_min_a:
+        case eq_mult_a:
+        case pos_sign_a:
+        case neg_sign_a:
+        case exp_op:
+        case log_op:
+        case sqrt_op:
+            fields[0] = &dop->arg;
+            fields[1] = &dop->res;
+            return 2;
+        case plus_d_a:
+        case min_d_a:
+        case mult_d_a:
+        case div_d_a:
+        case pow_op:
+            fields[0] = &dop->arg;
+            fields[1] = &dop->res;
+            *numVals = 1;
+            return 2;
+        case plus_a_a:
+        case min_a_a:
+        case mult_a_a:
+        case div_a_a:
+        case eq_plus_prod:
+        case eq_min_prod:
+        case sin_op:
+        case cos_op:
+            fields[0] = &dop->arg1;
+            fields[1] = &dop->arg2;
+            fields[2] = &dop->res;
+            return 3;
+        case axpy_d_a:
+            fields[0] = &dop->arg1;
+            fields[1] = &dop->arg2;
+            fields[2] = &dop->res;
+            *numVals = 1;
+            return 3;
+        case plus_a_p:
+        case min_a_p:
+        case mult_a_p:
+        case div_p_a:
+            fields[0] = &dop->arg;
+            fields[1] = &dop->arg1;
+            fields[2] = &dop->res;
+            return 3;
+        case plus_a_a_a:
+            fields[0] = &dop->arg1;
+            fields[1] = &dop->arg2;
+            fields[2] = &dop->arg;
+            fields[3] = &dop->res;
+            return 4;
+        default:
+            return -1;
+    }
+}
+
+#if defined(ADOLC_DEBUG)
+/*--------------------------------------------------------------------------*/
+/* Tells that a tape is swept over its streams because of an operation the  */
+/* decoded sweeps do not handle, e.g. a quadrature, fabs or condassign.     */
+static void reportRejected(unsigned char op) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    fprintf(DIAG_OUT, "ADOL-C debug: tape %d contains operation %d (see "
+            "oplate.h), it is swept over its streams\n",
+            ADOLC_CURRENT_TAPE_INFOS.tapeID, (int)op);
+}
+#endif
+
+/*--------------------------------------------------------------------------*/
+/* Decodes the in-core buffers of the current tape without touching its     */
+/* stream cursors. Returns 0 if the tape cannot be decoded.                 */
+static int decodeTape(struct DecodedTape *tape) {
+    const unsigned char *op, *opEnd;
+    const locint *loc, *locEnd;
+    locint *fields[4];
+    size_t numVals, val = 0, i;
+    DecodedOp *dop;
+    int numLocs;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    op = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+    opEnd = op + ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS];
+    loc = ADOLC_CURRENT_TAPE_INFOS.locBuffer + statSpace;
+    locEnd = ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS];
+    if (op == opEnd || *op != start_of_tape) return 0;
+
+    tape->opMemory = malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] *
+                            sizeof(DecodedOp) + ADOLC_DECODE_ALIGNMENT);
+    tape->vals = (double *)malloc((ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] + 1)
+                                  * sizeof(double));
+    if (tape->opMemory == NULL || tape->vals == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    tape->ops = (DecodedOp *)(((size_t)tape->opMemory + ADOLC_DECODE_ALIGNMENT - 1)
+                              / ADOLC_DECODE_ALIGNMENT * ADOLC_DECODE_ALIGNMENT);
+    memcpy(tape->vals, ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+           ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] * sizeof(double));
+
+    for (++op; op < opEnd && *op != end_of_tape; ++op) {
+        dop = tape->ops + tape->numOps;
+        memset(dop, 0, sizeof(DecodedOp));
+        dop->op = *op;
+        numLocs = decodeFields(*op, dop, fields, &numVals);
+        if (numLocs < 0) {
+#if defined(ADOLC_DEBUG)
+            reportRejected(*op);
+#endif
+            return 0;
+        }
+        if ((size_t)(locEnd - loc) < (size_t)numLocs)
+            return 0;
+        for (i = 0; i < (size_t)numLocs; ++i)
+            *fields[i] = *loc++;
+        if (*op == take_stock_op)
+            numVals = dop->arg;
+        if (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] - val < numVals)
+            return 0;
+        dop->val = (locint)val;
+        val += numVals;
+        ++tape->numOps;
+    }
+    return op < opEnd;
+}
+
+/*--------------------------------------------------------------------------*/
+struct DecodedTape *get_decoded_tape() {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.decodeTape < 0 ||
+            (ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.decodeTape == 0 &&
+             !ADOLC_GLOBAL_TAPE_VARS.decodeTapes))
+        return NULL;
+    return decode_current_tape();
+}
+
+/*--------------------------------------------------------------------------*/
+/* Views of worker threads share the decoded tape of the serial tape whose */
+/* buffers they read, the first one to need it decodes it.                 */
+static struct DecodedTape *decodeSharedTape() {
+    struct DecodedTape *tape;
+    TapeInfos *owner;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    owner = ADOLC_CURRENT_TAPE_INFOS.sharedTape;
+    if (ADOLC_CURRENT_TAPE_INFOS.decodedTape != NULL ||
+            ADOLC_CURRENT_TAPE_INFOS.decodeRejected)
+        return ADOLC_CURRENT_TAPE_INFOS.decodedTape;
+#if defined(_OPENMP)
+#pragma omp critical (adolc_shared_tape)
+#endif
+    {
+        if (owner->decodedTape == NULL && !owner->decodeRejected) {
+            tape = (struct DecodedTape *)calloc(1,
+                    sizeof(struct DecodedTape));
+            if (tape == NULL) fail(ADOLC_MALLOC_FAILED);
+            ADOLC_CURRENT_TAPE_INFOS.decodedTape = tape;
+            if (decodeTape(tape))
+                owner->decodedTape = tape;
+            else {
+                free_decoded_tape(&ADOLC_CURRENT_TAPE_INFOS);
+                owner->decodeRejected = 1;
+            }
+        }
+        ADOLC_CURRENT_TAPE_INFOS.decodedTape = owner->decodedTape;
+        ADOLC_CURRENT_TAPE_INFOS.decodeRejected = owner->decodeRejected;
+    }
+    return ADOLC_CURRENT_TAPE_INFOS.decodedTape;
+}
+
+/*--------------------------------------------------------------------------*/
+struct DecodedTape *decode_current_tape() {
+    struct DecodedTape *tape;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_CURRENT_TAPE_INFOS.sharedTape != NULL)
+        return decodeSharedTape();
+    if (ADOLC_CURRENT_TAPE_INFOS.decodeRejected ||
+            in_core_tape_size(&ADOLC_CURRENT_TAPE_INFOS) == 0)
+        return NULL;
+    if (ADOLC_CURRENT_TAPE_INFOS.decodedTape != NULL)
+        return ADOLC_CURRENT_TAPE_INFOS.decodedTape;
+
+    tape = (struct DecodedTape *)calloc(1, sizeof(struct DecodedTape));
+    if (tape == NULL) fail(ADOLC_MALLOC_FAILED);
+    ADOLC_CURRENT_TAPE_INFOS.decodedTape = tape;
+    if (!decodeTape(tape)) {
+        free_decoded_tape(&ADOLC_CURRENT_TAPE_INFOS);
+        ADOLC_CURRENT_TAPE_INFOS.decodeRejected = 1;
+        return NULL;
+    }
+    return tape;
+}
+
+/*--------------------------------------------------------------------------*/
+void free_decoded_tape(TapeInfos *tapeInfos) {
+    if (tapeInfos->decodedTape != NULL) {
+        if (tapeInfos->decodedTape->levels != NULL) {
+            free(tapeInfos->decodedTape->levels->ops);
+            free(tapeInfos->decodedTape->levels->levelStart);
+            free(tapeInfos->decodedTape->levels->lastSlot);
+            free(tapeInfos->decodedTape->levels);
+        }
+        free(tapeInfos->decodedTape->opMemory);
+        free(tapeInfos->decodedTape->vals);
+        free(tapeInfos->decodedTape);
+        tapeInfos->decodedTape = NULL;
+    }
+    tapeInfos->decodeRejected = 0;
+}
+
+/****************************************************************************/
+/* With ADOLC_THREADED_DISPATCH (configure --enable-threaded-dispatch) each */
+/* operation ends in a computed goto to the code of the next one, instead   */
+/* of returning to the switch at the head of the loop. The single indirect  */
+/* branch of the switch thus becomes one per operation, each of which the   */
+/* branch predictor learns separately. The sweeps define MORE_OPS and       */
+/* STEP_OP for the direction they walk the instructions in.                 */
+
+#if defined(ADOLC_THREADED_DISPATCH) && defined(__GNUC__)
+#define DISPATCH_ENTRY(op) [op] = &&op_##op,
+#define DISPATCH_TABLE \
+    static const void *const dispatch[256] = { DECODED_OPS(DISPATCH_ENTRY) };
+#define DISPATCH_OP goto *dispatch[dop->op];
+#define OP(op) case op: op_##op:
+#define NEXT_OP \
+    if (!MORE_OPS) goto end_of_ops; \
+    STEP_OP; \
+    LOAD_OPERANDS \
+    goto *dispatch[dop->op]
+#define END_OF_OPS end_of_ops: ;
+/* functions taking the addresses of their labels cannot be cloned */
+#undef ADOLC_SIMD_TARGETS
+#define ADOLC_SIMD_TARGETS
+#else
+#define DISPATCH_TABLE
+#define DISPATCH_OP
+#define OP(op) case op:
+#define NEXT_OP break
+#define END_OF_OPS
+#endif
+
+/****************************************************************************/
+/*                                                          FORWARD SWEEPS */
+
+#define MORE_OPS (dop + 1 != end)
+#define STEP_OP ++dop
+
+#define LOAD_OPERANDS \
+    res = dop->res; \
+    arg = dop->arg; \
+    arg1 = dop->arg1; \
+    arg2 = dop->arg2;
+
+/*--------------------------------------------------------------------------*/
+#define _ZOS_ 1
+#include "tape_decode_for.c"
+#undef _ZOS_
+
+/*--------------------------------------------------------------------------*/
+void zos_forward_decoded(const struct DecodedTape *tape, int keep,
+                         const double *basepoint, double *valuepoint,
+                         double *dp_T0) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    zos_forward_ops(tape->ops, tape->ops + tape->numOps, tape->vals,
+                    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore, keep, 0,
+                    basepoint, valuepoint, dp_T0);
+}
+
+/*--------------------------------------------------------------------------*/
+#define _FOS_ 1
+#include "tape_decode_for.c"
+#undef _FOS_
+
+/*--------------------------------------------------------------------------*/
+void fos_forward_decoded(const struct DecodedTape *tape, int keep,
+                         const double *basepoint, const double *argument,
+                         double *valuepoint, double *taylors,
+                         double *dp_T0, double *dp_T) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    fos_forward_ops(tape->ops, tape->ops + tape->numOps, tape->vals,
+                    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore, keep, 0,
+                    basepoint, argument, valuepoint, taylors, dp_T0, dp_T);
+}
+
+/*--------------------------------------------------------------------------*/
+#define _FOV_ 1
+#include "tape_decode_for.c"
+#undef _FOV_
+
+/*--------------------------------------------------------------------------*/
+void fov_forward_decoded(const struct DecodedTape *tape, int p,
+                         const double *basepoint, double **argument,
+                         double *valuepoint, double **taylors,
+                         double *dp_T0, double **dpp_T) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    fov_forward_ops(tape, ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore, 0,
+                    p, 0, basepoint, argument, valuepoint, taylors, dp_T0,
+                    dpp_T);
+}
+
+/*--------------------------------------------------------------------------*/
+/* first direction of slice s if p directions are split into slices, the    */
+/* slices starting on separate cache lines of aligned rows of elements of   */
+/* the given size                                                           */
+static int sliceStart(int p, int slices, int s, size_t size) {
+    int line = ADOLC_VECTOR_ALIGNMENT / size;
+
+    if (s == slices)
+        return p;
+    return (int)((long)p * s / slices) / line * line;
+}
+
+/*--------------------------------------------------------------------------*/
+/* With many directions the threads of an OpenMP team run fov_forward_ops   */
+/* on slices of them. Each thread computes the values in a copy of dp_T0,   */
+/* the first in the one of the caller.                                     */
+void fov_forward_parallel_decoded(const struct DecodedTape *tape, int p,
+                                  int offset, const double *basepoint,
+                                  double **argument, double *valuepoint,
+                                  double **taylors, double *dp_T0,
+                                  double **dpp_T) {
+    const revreal *params;
+    size_t numLives;
+    int slices = 1, s;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+    numLives = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES];
+#if defined(_OPENMP)
+    if (!omp_in_parallel())
+        slices = omp_get_max_threads();
+#endif
+    if (slices > p / ADOLC_PARALLEL_DIRECTIONS)
+        slices = p / ADOLC_PARALLEL_DIRECTIONS;
+    if (slices <= 1) {
+        fov_forward_ops(tape, params, 0, p, offset, basepoint, argument,
+                        valuepoint, taylors, dp_T0, dpp_T);
+        return;
+    }
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (s = 0; s < slices; ++s) {
+        int first = sliceStart(p, slices, s, sizeof(double));
+        int count = sliceStart(p, slices, s + 1, sizeof(double)) - first;
+        double *values = dp_T0;
+
+        if (s > 0 && (values = (double *)malloc(numLives *
+                                                sizeof(double))) == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+        fov_forward_ops(tape, params, first, count, offset + first,
+                        basepoint, argument, s == 0 ? valuepoint : NULL,
+                        taylors, values, dpp_T);
+        if (s > 0)
+            free(values);
+    }
+}
+
+#if defined(_OPENMP)
+/*--------------------------------------------------------------------------*/
+/* Sets the location fields an operation reads, the field it updates in     */
+/* place if any, and the fields it writes afresh. Returns the number of the */
+/* fields read. take_stock_op writes the arg locations from res on.        */
+static int slotFields(DecodedOp *dop, locint **reads, locint **update,
+                      locint **writes, int *numWrites) {
+    int numReads = 0;
+
+    *update = NULL;
+    *numWrites = 0;
+    switch (dop->op) {
+        case eq_plus_a:
+        case eq_min_a:
+        case eq_mult_a:
+            reads[numReads++] = &dop->arg;
+            *update = &dop->res;
+            return numReads;
+        case eq_plus_d:
+        case eq_plus_p:
+        case eq_min_d:
+        case eq_min_p:
+        case eq_mult_d:
+        case eq_mult_p:
+        case incr_a:
+        case decr_a:
+            *update = &dop->res;
+            return numReads;
+        case eq_plus_prod:
+        case eq_min_prod:
+            reads[numReads++] = &dop->arg1;
+            reads[numReads++] = &dop->arg2;
+            *update = &dop->res;
+            return numReads;
+        case assign_dep:
+            reads[numReads++] = &dop->res;
+            return numReads;
+        case take_stock_op:
+        case assign_ind:
+        case assign_d:
+        case assign_p:
+        case neg_sign_p:
+        case recipr_p:
+        case assign_d_zero:
+        case assign_d_one:
+            break;
+        case sin_op:
+        case cos_op:
+            reads[numReads++] = &dop->arg1;
+            writes[(*numWrites)++] = &dop->arg2;
+            break;
+        case plus_a_a_a:
+            reads[numReads++] = &dop->arg;
+            reads[numReads++] = &dop->arg1;
+            reads[numReads++] = &dop->arg2;
+            break;
+        case plus_a_a:
+        case min_a_a:
+        case mult_a_a:
+        case div_a_a:
+        case axpy_d_a:
+            reads[numReads++] = &dop->arg1;
+            reads[numReads++] = &dop->arg2;
+            break;
+        default:                    /* unary operations reading arg */
+            reads[numReads++] = &dop->arg;
+            break;
+    }
+    writes[(*numWrites)++] = &dop->res;
+    return numReads;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Sorts the operations of a decoded tape into levels. The level of an     */
+/* operation is the highest level of the operations writing the slots it   */
+/* reads and, for a slot it updates in place, also of those reading that   */
+/* slot before, plus one. Rejects tapes with fewer than ADOLC_PARALLEL_OPS */
+/* operations per level on average, whose levels would cost more barriers  */
+/* than the threads save.                                                   */
+static int buildLevels(const struct DecodedTape *tape,
+                       struct DecodedLevels *levels, size_t maxLives) {
+    const DecodedOp *op, *end = tape->ops + tape->numOps;
+    DecodedOp *dop, *ops = NULL;
+    locint *reads[3], *update, *writes[2], *cur = NULL, indexi = 0,
+        indexd = 0;
+    size_t numOps = 0, numLocs = 0, numSlots, level, *levelOf = NULL,
+        *written = NULL, *read = NULL, *levelStart = NULL, i, j;
+    int numReads, numWrites, k;
+
+    /* locations used and slots needed */
+    numSlots = 0;
+    for (op = tape->ops; op != end; ++op) {
+        DecodedOp copy = *op;
+        if (op->op == death_not)
+            continue;
+        ++numOps;
+        numReads = slotFields(&copy, reads, &update, writes, &numWrites);
+        if (op->op == take_stock_op) {
+            if (numLocs < (size_t)op->res + op->arg)
+                numLocs = (size_t)op->res + op->arg;
+            numSlots += op->arg;
+            continue;
+        }
+        for (k = 0; k < numReads; ++k)
+            if (numLocs <= *reads[k]) numLocs = *reads[k] + 1;
+        if (update != NULL && numLocs <= *update) numLocs = *update + 1;
+        for (k = 0; k < numWrites; ++k)
+            if (numLocs <= *writes[k]) numLocs = *writes[k] + 1;
+        numSlots += numWrites;
+    }
+    numSlots += numLocs;
+    if (numOps == 0 || numLocs > maxLives || numSlots > (locint)-1)
+        return 0;
+
+    cur = (locint *)malloc(numLocs * sizeof(locint));
+    written = (size_t *)calloc(numSlots, sizeof(size_t));
+    read = (size_t *)calloc(numSlots, sizeof(size_t));
+    levelOf = (size_t *)malloc(numOps * sizeof(size_t));
+    ops = (DecodedOp *)malloc(numOps * sizeof(DecodedOp));
+    if (cur == NULL || written == NULL || read == NULL || levelOf == NULL ||
+            ops == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    for (i = 0; i < numLocs; ++i)
+        cur[i] = (locint)i;
+
+    /* rename the locations to slots, the levels follow from the slots */
+    levels->numLevels = 0;
+    numSlots = numLocs;
+    for (op = tape->ops, i = 0; op != end; ++op) {
+        if (op->op == death_not)
+            continue;
+        dop = ops + i;
+        *dop = *op;
+        if (dop->op == assign_ind)
+            dop->val = indexi++;
+        else if (dop->op == assign_dep)
+            dop->val = indexd++;
+        numReads = slotFields(dop, reads, &update, writes, &numWrites);
+        level = 0;
+        for (k = 0; k < numReads; ++k) {
+            *reads[k] = cur[*reads[k]];
+            if (level < written[*reads[k]]) level = written[*reads[k]];
+        }
+        if (update != NULL) {
+            *update = cur[*update];
+            if (level < written[*update]) level = written[*update];
+            if (level < read[*update]) level = read[*update];
+            written[*update] = level + 1;
+        }
+        for (k = 0; k < numReads; ++k)
+            if (read[*reads[k]] < level + 1) read[*reads[k]] = level + 1;
+        if (dop->op == take_stock_op) {
+            for (j = 0; j < dop->arg; ++j) {
+                cur[dop->res + j] = (locint)(numSlots + j);
+                written[numSlots + j] = 1;
+            }
+            dop->res = (locint)numSlots;
+            numSlots += dop->arg;
+        }
+        for (k = 0; k < numWrites && dop->op != take_stock_op; ++k) {
+            cur[*writes[k]] = (locint)numSlots;
+            *writes[k] = (locint)numSlots;
+            written[numSlots++] = level + 1;
+        }
+        levelOf[i++] = level;
+        if (levels->numLevels < level + 1)
+            levels->numLevels = level + 1;
+    }
+    free(written);
+    free(read);
+
+    if (numOps / levels->numLevels < ADOLC_PARALLEL_OPS) {
+        free(cur);
+        free(levelOf);
+        free(ops);
+        return 0;
+    }
+
+    /* stable counting sort of the operations by level */
+    levelStart = (size_t *)calloc(levels->numLevels + 1, sizeof(size_t));
+    levels->ops = (DecodedOp *)malloc(numOps * sizeof(DecodedOp));
+    if (levelStart == NULL || levels->ops == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    for (i = 0; i < numOps; ++i)
+        ++levelStart[levelOf[i] + 1];
+    for (i = 0; i < levels->numLevels; ++i)
+        levelStart[i + 1] += levelStart[i];
+    for (i = 0; i < numOps; ++i)
+        levels->ops[levelStart[levelOf[i]]++] = ops[i];
+    for (i = levels->numLevels; i > 0; --i)
+        levelStart[i] = levelStart[i - 1];
+    levelStart[0] = 0;
+    free(levelOf);
+    free(ops);
+
+    levels->levelStart = levelStart;
+    levels->lastSlot = cur;
+    levels->numLocs = numLocs;
+    levels->numSlots = numSlots;
+    return 1;
+}
+
+/*--------------------------------------------------------------------------*/
+/* Returns the levels of a decoded tape if a team of OpenMP threads should  */
+/* run its zero or first order forward sweep, NULL otherwise.               */
+static const struct DecodedLevels *parallelLevels(struct DecodedTape *tape) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (omp_in_parallel() || omp_get_max_threads() < 2 ||
+            tape->numOps < 2 * ADOLC_PARALLEL_OPS)
+        return NULL;
+    if (tape->levels == NULL) {
+        tape->levels = (struct DecodedLevels *)calloc(1,
+                sizeof(struct DecodedLevels));
+        if (tape->levels == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+        buildLevels(tape, tape->levels,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES]);
+    }
+    return tape->levels->ops != NULL ? tape->levels : NULL;
+}
+
+/* operations one thread takes at a time from a level */
+#define ADOLC_LEVEL_CHUNK 256
+#endif
+
+/*--------------------------------------------------------------------------*/
+void zos_forward_parallel_decoded(struct DecodedTape *tape, int keep,
+                                  const double *basepoint,
+                                  double *valuepoint, double *dp_T0) {
+#if defined(_OPENMP)
+    const struct DecodedLevels *levels = NULL;
+    const revreal *params;
+    double *T0;
+    size_t i;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (keep == 0)
+        levels = parallelLevels(tape);
+    if (levels != NULL) {
+        params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+        T0 = (double *)malloc(levels->numSlots * sizeof(double));
+        if (T0 == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+        memcpy(T0, dp_T0, levels->numLocs * sizeof(double));
+#pragma omp parallel
+        {
+            size_t l;
+            long first, last, c;
+            for (l = 0; l < levels->numLevels; ++l) {
+                first = (long)levels->levelStart[l];
+                last = (long)levels->levelStart[l + 1];
+#pragma omp for schedule(dynamic)
+                for (c = first; c < last; c += ADOLC_LEVEL_CHUNK)
+                    zos_forward_ops(levels->ops + c, levels->ops +
+                                    (c + ADOLC_LEVEL_CHUNK < last ?
+                                     c + ADOLC_LEVEL_CHUNK : last),
+                                    tape->vals, params, 0, 1, basepoint,
+                                    valuepoint, T0);
+            }
+        }
+        for (i = 0; i < levels->numLocs; ++i)
+            dp_T0[i] = T0[levels->lastSlot[i]];
+        free(T0);
+        return;
+    }
+#endif
+    zos_forward_decoded(tape, keep, basepoint, valuepoint, dp_T0);
+}
+
+/*--------------------------------------------------------------------------*/
+void fos_forward_parallel_decoded(struct DecodedTape *tape, int keep,
+                                  const double *basepoint,
+                                  const double *argument,
+                                  double *valuepoint, double *taylors,
+                                  double *dp_T0, double *dp_T) {
+#if defined(_OPENMP)
+    const struct DecodedLevels *levels = NULL;
+    const revreal *params;
+    double *T0, *T;
+    size_t i;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (keep == 0)
+        levels = parallelLevels(tape);
+    if (levels != NULL) {
+        params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+        T0 = (double *)malloc(2 * levels->numSlots * sizeof(double));
+        if (T0 == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+        T = T0 + levels->numSlots;
+        memcpy(T0, dp_T0, levels->numLocs * sizeof(double));
+        memcpy(T, dp_T, levels->numLocs * sizeof(double));
+#pragma omp parallel
+        {
+            size_t l;
+            long first, last, c;
+            for (l = 0; l < levels->numLevels; ++l) {
+                first = (long)levels->levelStart[l];
+                last = (long)levels->levelStart[l + 1];
+#pragma omp for schedule(dynamic)
+                for (c = first; c < last; c += ADOLC_LEVEL_CHUNK)
+                    fos_forward_ops(levels->ops + c, levels->ops +
+                                    (c + ADOLC_LEVEL_CHUNK < last ?
+                                     c + ADOLC_LEVEL_CHUNK : last),
+                                    tape->vals, params, 0, 1, basepoint,
+                                    argument, valuepoint, taylors, T0, T);
+            }
+        }
+        for (i = 0; i < levels->numLocs; ++i) {
+            dp_T0[i] = T0[levels->lastSlot[i]];
+            dp_T[i] = T[levels->lastSlot[i]];
+        }
+        free(T0);
+        return;
+    }
+#endif
+    fos_forward_decoded(tape, keep, basepoint, argument, valuepoint,
+                        taylors, dp_T0, dp_T);
+}
+
+/****************************************************************************/
+/*                                                          REVERSE SWEEPS */
+
+#undef MORE_OPS
+#undef STEP_OP
+#define MORE_OPS (dop != tape->ops)
+#define STEP_OP --dop
+
+/*--------------------------------------------------------------------------*/
+#define _FOS_ 1
+#include "tape_decode_rev.c"
+#undef _FOS_
+
+/*--------------------------------------------------------------------------*/
+/* The taylors restored by a reverse sweep in the order it reads them. The  */
+/* slices of a parallel fov_reverse replay them instead of the stack.      */
+typedef struct {
+    revreal *values;
+    size_t size, used;
+    int replay;
+} TaylorLog;
+
+static void logTaylor(TaylorLog *log, revreal value) {
+    if (log->used == log->size) {
+        log->size = log->size > 0 ? 2 * log->size : 1024;
+        log->values = (revreal *)realloc(log->values,
+                                         log->size * sizeof(revreal));
+        if (log->values == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+    }
+    log->values[log->used++] = value;
+}
+
+#define RESTORE_TAYLOR_FROM(X, get) \
+    { \
+        if (log == NULL) \
+            get(X) \
+        else if (log->replay) \
+            rp_T[X] = log->values[log->used++]; \
+        else { \
+            get(X) \
+            logTaylor(log, rp_T[X]); \
+        } \
+    }
+#define RESTORE_TAYLOR(X) RESTORE_TAYLOR_FROM(X, ADOLC_GET_TAYLOR)
+#define RESTORE_TAYLOR_LINEAR(X) \
+    RESTORE_TAYLOR_FROM(X, ADOLC_GET_TAYLOR_LINEAR)
+
+/*--------------------------------------------------------------------------*/
+#define _FOV_ 1
+#include "tape_decode_rev.c"
+#undef _FOV_
+
+/*--------------------------------------------------------------------------*/
+void fov_reverse_decoded(const struct DecodedTape *tape, int p,
+                         double **lagrange, double **results,
+                         revreal *rp_T, revreal **rpp_A) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    fov_reverse_ops(tape, ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore,
+                    ADOLC_CURRENT_TAPE_INFOS.in_nested_ctx,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS] - 1,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS] - 1, 0, p,
+                    lagrange, results, rp_T, rpp_A, NULL);
+}
+
+/*--------------------------------------------------------------------------*/
+/* With many directions fov_reverse_ops first reads the taylor stack for no */
+/* direction into a log, then the threads of an OpenMP team run it on       */
+/* slices of the directions, each replaying the log in a copy of rp_T as   */
+/* it was on entry.                                                        */
+void fov_reverse_parallel_decoded(const struct DecodedTape *tape, int p,
+                                  double **lagrange, double **results,
+                                  revreal *rp_T, revreal **rpp_A) {
+    const revreal *params;
+    revreal *initial;
+    TaylorLog log = { NULL, 0, 0, 0 };
+    size_t numLives;
+    locint n, m;
+    int slices = 1, nested, s;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+#if defined(_OPENMP)
+    if (!omp_in_parallel())
+        slices = omp_get_max_threads();
+#endif
+    if (slices > p / ADOLC_PARALLEL_DIRECTIONS)
+        slices = p / ADOLC_PARALLEL_DIRECTIONS;
+    if (slices <= 1) {
+        fov_reverse_decoded(tape, p, lagrange, results, rp_T, rpp_A);
+        return;
+    }
+
+    params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+    numLives = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES];
+    n = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS];
+    m = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS];
+    nested = ADOLC_CURRENT_TAPE_INFOS.in_nested_ctx;
+    initial = (revreal *)malloc(numLives * sizeof(revreal));
+    if (initial == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    memcpy(initial, rp_T, numLives * sizeof(revreal));
+    fov_reverse_ops(tape, params, nested, n - 1, m - 1, 0, 0, lagrange,
+                    results, rp_T, rpp_A, &log);
+    log.replay = 1;
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (s = 0; s < slices; ++s) {
+        int first = sliceStart(p, slices, s, sizeof(revreal));
+        TaylorLog replay = log;
+        revreal *values;
+
+        values = (revreal *)malloc(numLives * sizeof(revreal));
+        if (values == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+        memcpy(values, initial, numLives * sizeof(revreal));
+        replay.used = 0;
+        fov_reverse_ops(tape, params, nested, n - 1, m - 1, first,
+                        sliceStart(p, slices, s + 1, sizeof(revreal)) -
+                        first, lagrange, results, values, rpp_A, &replay);
+        free(values);
+    }
+    free(initial);
+    free(log.values);
+}
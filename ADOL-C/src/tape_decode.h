@@ -0,0 +1,63 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_decode.h
+ Revision: $Id$
+ Contents: fixed width instructions of tapes kept in core, shared by the
+           decoded sweeps (tape_decode.c) and the code generator
+           (tape_codegen.c)
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#if !defined(ADOLC_TAPE_DECODE_H)
+#define ADOLC_TAPE_DECODE_H 1
+
+#include "taping_p.h"
+#include "oplate.h"
+
+typedef struct {
+    locint arg, arg1, arg2, res;      /* locations as read by the sweeps */
+    locint val;                         /* index of the first constant */
+    unsigned char op;
+} DecodedOp;
+
+/* The operations of a decoded tape sorted into levels of independent
+ * operations for the forward sweeps of OpenMP teams. They read and write
+ * slots instead of locations: locations 0..numLocs-1 start in the slots of
+ * the same number, and each operation writing a location afresh writes a
+ * new slot, so that only true dependences order the operations. */
+struct DecodedLevels {
+    DecodedOp *ops;                 /* NULL if the levels are too narrow */
+    size_t *levelStart;             /* numLevels + 1 offsets into ops */
+    size_t numLevels;
+    locint *lastSlot;               /* slot of the final value of a location */
+    size_t numLocs;
+    size_t numSlots;
+};
+
+struct DecodedTape {
+    DecodedOp *ops;                 /* aligned to ADOLC_DECODE_ALIGNMENT */
+    void *opMemory;
+    size_t numOps;
+    double *vals;
+    struct DecodedLevels *levels;   /* built on first use */
+};
+
+/*--------------------------------------------------------------------------*/
+/* The operations a decoded tape may contain */
+#define DECODED_OPS(X) \
+    X(death_not) X(take_stock_op) X(assign_ind) X(assign_dep) \
+    X(assign_a) X(assign_d) X(assign_p) X(neg_sign_p) X(recipr_p) \
+    X(assign_d_zero) X(assign_d_one) X(eq_plus_d) X(eq_plus_p) \
+    X(eq_plus_a) X(eq_min_d) X(eq_min_p) X(eq_min_a) X(eq_mult_d) \
+    X(eq_mult_p) X(eq_mult_a) X(incr_a) X(decr_a) X(plus_a_a) \
+    X(plus_a_a_a) X(plus_d_a) X(plus_a_p) X(min_a_a) X(min_d_a) \
+    X(min_a_p) X(mult_a_a) X(eq_plus_prod) X(eq_min_prod) X(mult_d_a) \
+    X(mult_a_p) X(axpy_d_a) X(div_a_a) X(div_d_a) X(div_p_a) \
+    X(pos_sign_a) X(neg_sign_a) X(exp_op) X(sin_op) X(cos_op) \
+    X(log_op) X(pow_op) X(sqrt_op)
+
+#endif
@@ -0,0 +1,376 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_decode_for.c
+ Revision: $Id$
+ Contents: Contains the forward sweeps over decoded tapes :
+           zos_forward_ops (zero-order-scalar):             define _ZOS_
+           fos_forward_ops (first-order-scalar):            define _FOS_
+           fov_forward_ops (first-order-vector):            define _FOV_
+           zos_forward_batched (zero-order, many points):   define _BATCH_
+
+           Included by tape_decode.c and tape_batch.c, which define the
+           dispatch macros OP, NEXT_OP, DISPATCH_TABLE, DISPATCH_OP,
+           END_OF_OPS and LOAD_OPERANDS. The statements of the operations
+           are those of tape_rules.h.
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include "tape_rules.h"
+
+/****************************************************************************/
+/*                                                                   MACROS */
+
+#if defined(_ZOS_) || defined(_FOS_)
+#define NUMBERED numbered
+#else
+#define NUMBERED 0
+#endif
+
+#define RESTORE_THREAD ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
+
+/*--------------------------------------------------------------------------*/
+#if defined(_ZOS_)
+#define TV(x) dp_T0[x]
+#define XV(i) basepoint[i]
+#define YV(i) valuepoint[i]
+#define HAS_YV (valuepoint != NULL)
+#define HAS_YD 0
+#define VALUE(s) s;
+#define SCALAR(s)
+#define TANGENT(s)
+#define TANGENT_SERIAL(s)
+#define TANGENT_BRANCH(c, s, t)
+#define KEEPING keep
+#define KEEP(x) \
+    if (keep) ADOLC_WRITE_SCAYLOR(dp_T0[x])
+#endif
+
+/*--------------------------------------------------------------------------*/
+#if defined(_FOS_)
+#define TV(x) dp_T0[x]
+#define TD(x) dp_T[x]
+#define XV(i) basepoint[i]
+#define XD(i) argument[i]
+#define YV(i) valuepoint[i]
+#define YD(i) taylors[i]
+#define HAS_YV (valuepoint != NULL)
+#define HAS_YD (taylors != NULL)
+#define VALUE(s) s;
+#define SCALAR(s) s;
+#define TANGENT(s) s;
+#define TANGENT_SERIAL(s) { s; }
+#define TANGENT_BRANCH(c, s, t) \
+    if (c) { s; } else { t; }
+#define KEEPING keep
+#define KEEP(x) \
+    if (keep) { \
+        ADOLC_WRITE_SCAYLOR(dp_T0[x]); \
+        if (keep > 1) ADOLC_WRITE_SCAYLOR(dp_T[x]); \
+    }
+#endif
+
+/*--------------------------------------------------------------------------*/
+#if defined(_FOV_)
+#define TV(x) dp_T0[x]
+#define TD(x) dpp_T[x][first + l]
+#define XV(i) basepoint[i]
+#define XD(i) argument[i][offset + l]
+#define YV(i) valuepoint[i]
+#define YD(i) taylors[i][offset + l]
+#define HAS_YV (valuepoint != NULL)
+#define HAS_YD (taylors != NULL)
+#define VALUE(s) s;
+#define SCALAR(s) s;
+#define TANGENT(s) \
+    ADOLC_SIMD_LOOP \
+    for (l = 0; l < p; ++l) { s; }
+#define TANGENT_SERIAL(s) \
+    for (l = 0; l < p; ++l) { s; }
+#define TANGENT_BRANCH(c, s, t) \
+    if (c) { TANGENT_SERIAL(s) } else { TANGENT(t) }
+#define KEEPING 0
+#define KEEP(x)
+#endif
+
+/*--------------------------------------------------------------------------*/
+#if defined(_BATCH_)
+#define TV(x) T[(x) * stride + k]
+#define XV(i) X[k][i]
+#define YV(i) Y[k][i]
+#define HAS_YV (Y != NULL)
+#define HAS_YD 0
+#define VALUE(s) BATCH_LOOP(s)
+#define SCALAR(s)
+#define TANGENT(s)
+#define TANGENT_SERIAL(s)
+#define TANGENT_BRANCH(c, s, t)
+#define KEEPING (S != NULL)
+#define KEEP(x) KEEP_BATCH(x)
+#endif
+
+/****************************************************************************/
+/*                                                            FORWARD SWEEP */
+
+#if defined(_ZOS_)
+/*--------------------------------------------------------------------------*/
+/* zos_forward on the operations dop..end-1. If numbered is set the val     */
+/* fields of assign_ind and assign_dep hold the indices of the independent  */
+/* and dependent, otherwise they are counted from the start of the range.   */
+static void zos_forward_ops(const DecodedOp *dop, const DecodedOp *end,
+                            const double *vals, const revreal *params,
+                            int keep, int numbered, const double *basepoint,
+                            double *valuepoint, double *dp_T0) {
+#elif defined(_FOS_)
+/*--------------------------------------------------------------------------*/
+/* fos_forward on the operations dop..end-1, numbered as in zos_forward_ops */
+static void fos_forward_ops(const DecodedOp *dop, const DecodedOp *end,
+                            const double *vals, const revreal *params,
+                            int keep, int numbered, const double *basepoint,
+                            const double *argument, double *valuepoint,
+                            double *taylors, double *dp_T0, double *dp_T) {
+#elif defined(_FOV_)
+/*--------------------------------------------------------------------------*/
+/* fov_forward on the directions first..first+p-1 of dpp_T, which are the   */
+/* columns offset..offset+p-1 of argument and taylors. The values are       */
+/* computed in dp_T0 along with them.                                      */
+ADOLC_SIMD_TARGETS
+static void fov_forward_ops(const struct DecodedTape *tape,
+                            const revreal *params, int first, int p,
+                            int offset, const double *basepoint,
+                            double **argument, double *valuepoint,
+                            double **taylors, double *dp_T0,
+                            double **dpp_T) {
+    const DecodedOp *dop = tape->ops, *end = tape->ops + tape->numOps;
+    const double *vals = tape->vals;
+    int l;
+#elif defined(_BATCH_)
+/*--------------------------------------------------------------------------*/
+/* Evaluates the points X[0..w-1] into Y[0..w-1] (if Y != NULL), T holds    */
+/* the values of the locations with "stride" points per location. With a   */
+/* stack S the overwritten values are kept, returns the top of the stack.   */
+ADOLC_SIMD_TARGETS
+static double *zos_forward_batched(const struct DecodedTape *tape, int w,
+                                   size_t stride, double **X, double **Y,
+                                   double *T, double *S) {
+    const DecodedOp *dop = tape->ops, *end = tape->ops + tape->numOps;
+    const double *vals = tape->vals;
+    const revreal *params;
+    int k;
+#endif
+    locint indexi = 0, indexd = 0, j, res, arg, arg1, arg2;
+    double coval;
+#if defined(_FOS_) || defined(_FOV_)
+    double r0, r_0;
+#endif
+    DISPATCH_TABLE
+#if !defined(_FOV_)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+#endif
+
+#if defined(_BATCH_)
+    params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+#endif
+    for (; dop != end; ++dop) {
+        LOAD_OPERANDS
+        DISPATCH_OP
+        switch (dop->op) {
+            OP(death_not)
+                FOR_death_not
+                NEXT_OP;
+            OP(take_stock_op)
+                for (j = 0; j < arg; ++j, ++res) {
+                    coval = vals[dop->val + j];
+                    FOR_take_stock_op
+                }
+                NEXT_OP;
+            OP(assign_ind)
+                if (NUMBERED)
+                    indexi = dop->val;
+                FOR_assign_ind
+                ++indexi;
+                NEXT_OP;
+            OP(assign_dep)
+                if (NUMBERED)
+                    indexd = dop->val;
+                FOR_assign_dep
+                ++indexd;
+                NEXT_OP;
+            OP(assign_a)
+                FOR_assign_a
+                NEXT_OP;
+            OP(assign_d)
+                coval = vals[dop->val];
+                FOR_assign_d
+                NEXT_OP;
+            OP(assign_p)
+                coval = params[arg];
+                FOR_assign_p
+                NEXT_OP;
+            OP(neg_sign_p)
+                coval = params[arg];
+                FOR_neg_sign_p
+                NEXT_OP;
+            OP(recipr_p)
+                coval = params[arg];
+                FOR_recipr_p
+                NEXT_OP;
+            OP(assign_d_zero)
+                FOR_assign_d_zero
+                NEXT_OP;
+            OP(assign_d_one)
+                FOR_assign_d_one
+                NEXT_OP;
+            OP(eq_plus_d)
+                coval = vals[dop->val];
+                FOR_eq_plus_d
+                NEXT_OP;
+            OP(eq_plus_p)
+                coval = params[arg];
+                FOR_eq_plus_p
+                NEXT_OP;
+            OP(eq_plus_a)
+                FOR_eq_plus_a
+                NEXT_OP;
+            OP(eq_min_d)
+                coval = vals[dop->val];
+                FOR_eq_min_d
+                NEXT_OP;
+            OP(eq_min_p)
+                coval = params[arg];
+                FOR_eq_min_p
+                NEXT_OP;
+            OP(eq_min_a)
+                FOR_eq_min_a
+                NEXT_OP;
+            OP(eq_mult_d)
+                coval = vals[dop->val];
+                FOR_eq_mult_d
+                NEXT_OP;
+            OP(eq_mult_p)
+                coval = params[arg];
+                FOR_eq_mult_p
+                NEXT_OP;
+            OP(eq_mult_a)
+                FOR_eq_mult_a
+                NEXT_OP;
+            OP(incr_a)
+                FOR_incr_a
+                NEXT_OP;
+            OP(decr_a)
+                FOR_decr_a
+                NEXT_OP;
+            OP(plus_a_a)
+                FOR_plus_a_a
+                NEXT_OP;
+            OP(plus_a_a_a)
+                FOR_plus_a_a_a
+                NEXT_OP;
+            OP(plus_d_a)
+                coval = vals[dop->val];
+                FOR_plus_d_a
+                NEXT_OP;
+            OP(plus_a_p)
+                coval = params[arg1];
+                FOR_plus_a_p
+                NEXT_OP;
+            OP(min_a_a)
+                FOR_min_a_a
+                NEXT_OP;
+            OP(min_d_a)
+                coval = vals[dop->val];
+                FOR_min_d_a
+                NEXT_OP;
+            OP(min_a_p)
+                coval = params[arg1];
+                FOR_min_a_p
+                NEXT_OP;
+            OP(mult_a_a)
+                FOR_mult_a_a
+                NEXT_OP;
+            OP(eq_plus_prod)
+                FOR_eq_plus_prod
+                NEXT_OP;
+            OP(eq_min_prod)
+                FOR_eq_min_prod
+                NEXT_OP;
+            OP(mult_d_a)
+                coval = vals[dop->val];
+                FOR_mult_d_a
+                NEXT_OP;
+            OP(mult_a_p)
+                coval = params[arg1];
+                FOR_mult_a_p
+                NEXT_OP;
+            OP(axpy_d_a)
+                coval = vals[dop->val];
+                FOR_axpy_d_a
+                NEXT_OP;
+            OP(div_a_a)
+                FOR_div_a_a
+                NEXT_OP;
+            OP(div_d_a)
+                coval = vals[dop->val];
+                FOR_div_d_a
+                NEXT_OP;
+            OP(div_p_a)
+                coval = params[arg1];
+                FOR_div_p_a
+                NEXT_OP;
+            OP(pos_sign_a)
+                FOR_pos_sign_a
+                NEXT_OP;
+            OP(neg_sign_a)
+                FOR_neg_sign_a
+                NEXT_OP;
+            OP(exp_op)
+                FOR_exp_op
+                NEXT_OP;
+            OP(sin_op)
+                FOR_sin_op
+                NEXT_OP;
+            OP(cos_op)
+                FOR_cos_op
+                NEXT_OP;
+            OP(log_op)
+                FOR_log_op
+                NEXT_OP;
+            OP(pow_op)
+                coval = vals[dop->val];
+                FOR_pow_op
+                NEXT_OP;
+            OP(sqrt_op)
+                FOR_sqrt_op
+                NEXT_OP;
+        }
+    }
+    END_OF_OPS
+#if defined(_BATCH_)
+    return S;
+#endif
+}
+
+/****************************************************************************/
+/*                                                                 CLEAN UP */
+
+#undef NUMBERED
+#undef RESTORE_THREAD
+#undef TV
+#undef TD
+#undef XV
+#undef XD
+#undef YV
+#undef YD
+#undef HAS_YV
+#undef HAS_YD
+#undef VALUE
+#undef SCALAR
+#undef TANGENT
+#undef TANGENT_SERIAL
+#undef TANGENT_BRANCH
+#undef KEEPING
+#undef KEEP
@@ -0,0 +1,314 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_decode_rev.c
+ Revision: $Id$
+ Contents: Contains the reverse sweeps over decoded tapes :
+           fos_reverse_decoded (first-order-scalar):        define _FOS_
+           fov_reverse_ops (first-order-vector):            define _FOV_
+           fos_reverse_batched (first-order, many points):  define _BATCH_
+
+           Included by tape_decode.c and tape_batch.c, which define the
+           dispatch macros OP, NEXT_OP, DISPATCH_TABLE, DISPATCH_OP,
+           END_OF_OPS and LOAD_OPERANDS. The statements of the operations
+           are those of tape_rules.h.
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include "tape_rules.h"
+
+/****************************************************************************/
+/*                                                                   MACROS */
+
+/*--------------------------------------------------------------------------*/
+#if defined(_FOS_)
+#define RV(x) rp_T[x]
+#define RA(x) rp_A[x]
+#define AREAL revreal
+#define ADJOINT(s) { s; }
+#define PARTIAL(s) { s; }
+#define P0 r0
+#define P1 r_0
+#define RESTORE(x) ADOLC_GET_TAYLOR(x)
+#define RESTORE_LINEAR(x) ADOLC_GET_TAYLOR_LINEAR(x)
+#define RESULT(i) results[i]
+#define RESULT_NESTED(i) results[i]
+#define LAGRANGE(d) lagrange[d]
+#define LAGRANGE_NESTED(d) lagrange[d]
+#define LAGRANGE_CLEAR(d) lagrange[d] = 0.0
+#endif
+
+/*--------------------------------------------------------------------------*/
+#if defined(_FOV_)
+#define RV(x) rp_T[x]
+#define RA(x) rpp_A[x][first + l]
+#define AREAL revreal
+#define ADJOINT(s) \
+    ADOLC_SIMD_LOOP \
+    for (l = 0; l < p; ++l) { s; }
+#define PARTIAL(s) { s; }
+#define P0 r0
+#define P1 r_0
+#define RESTORE(x) RESTORE_TAYLOR(x)
+#define RESTORE_LINEAR(x) RESTORE_TAYLOR_LINEAR(x)
+#define RESULT(i) results[first + l][i]
+#define RESULT_NESTED(i) results[i][first + l]
+#define LAGRANGE(d) lagrange[first + l][d]
+#define LAGRANGE_NESTED(d) lagrange[d][first + l]
+#define LAGRANGE_CLEAR(d) lagrange[d][first + l] = 0.0
+#endif
+
+/*--------------------------------------------------------------------------*/
+#if defined(_BATCH_)
+#define RV(x) T[(x) * stride + k]
+#define RA(x) A[(x) * stride + k]
+#define AREAL double
+#define ADJOINT(s) BATCH_LOOP(s)
+#define PARTIAL(s) BATCH_LOOP(s)
+#define P0 R[k]
+#define P1 R[stride + k]
+#define RESTORE(x) GET_BATCH(x)
+#define RESTORE_LINEAR(x) GET_BATCH(x)
+#define RESULT(i) G[k][i]
+#define RESULT_NESTED(i) G[k][i]
+#define LAGRANGE(d) 1.0
+#define LAGRANGE_NESTED(d) 1.0
+#define LAGRANGE_CLEAR(d)
+#endif
+
+/****************************************************************************/
+/*                                                            REVERSE SWEEP */
+
+#if defined(_FOS_)
+/*--------------------------------------------------------------------------*/
+void fos_reverse_decoded(const struct DecodedTape *tape, double *lagrange,
+                         double *results, revreal *rp_T, revreal *rp_A) {
+    const DecodedOp *dop = tape->ops + tape->numOps;
+    const double *vals = tape->vals;
+    const revreal *params;
+    locint indexi, indexd;
+    int nested;
+    double r0, r_0;
+#elif defined(_FOV_)
+/*--------------------------------------------------------------------------*/
+/* fov_reverse on the directions first..first+p-1, reading the taylors from */
+/* the stack if log is NULL, else recording them in it or replaying them.  */
+/* indexi and indexd are the last independent and dependent.               */
+ADOLC_SIMD_TARGETS
+static void fov_reverse_ops(const struct DecodedTape *tape,
+                            const revreal *params, int nested,
+                            locint indexi, locint indexd, int first, int p,
+                            double **lagrange, double **results,
+                            revreal *rp_T, revreal **rpp_A, TaylorLog *log) {
+    const DecodedOp *dop = tape->ops + tape->numOps;
+    const double *vals = tape->vals;
+    double r0, r_0;
+    int l;
+#elif defined(_BATCH_)
+/*--------------------------------------------------------------------------*/
+/* Reverse sweep of a scalar function for the points of the batch after     */
+/* zos_forward_batched with the stack S, whose top is passed. The gradients */
+/* go to G[0..w-1], A holds the adjoints of the locations as T their values */
+/* and R receives two temporary values per point, "stride" apart.           */
+ADOLC_SIMD_TARGETS
+static void fos_reverse_batched(const struct DecodedTape *tape, int w,
+                                size_t stride, double **G, double *T,
+                                double *A, double *S, double *R) {
+    const DecodedOp *dop = tape->ops + tape->numOps;
+    const double *vals = tape->vals;
+    const revreal *params;
+    locint indexi, indexd = 0;
+    int k, nested;
+#endif
+    locint j, res, arg, arg1, arg2;
+    double coval;
+    DISPATCH_TABLE
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+#if defined(_FOS_) || defined(_BATCH_)
+    params = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore;
+    nested = ADOLC_CURRENT_TAPE_INFOS.in_nested_ctx;
+    indexi = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS] - 1;
+#endif
+#if defined(_FOS_)
+    indexd = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS] - 1;
+#endif
+    while (dop != tape->ops) {
+        --dop;
+        LOAD_OPERANDS
+        DISPATCH_OP
+        switch (dop->op) {
+            OP(death_not)
+                REV_death_not
+                NEXT_OP;
+            OP(take_stock_op)
+                for (j = 0; j < arg; ++j, ++res) {
+                    REV_take_stock_op
+                }
+                NEXT_OP;
+            OP(assign_ind)
+                REV_assign_ind
+                indexi--;
+                NEXT_OP;
+            OP(assign_dep)
+                REV_assign_dep
+                indexd--;
+                NEXT_OP;
+            OP(assign_a)
+                REV_assign_a
+                NEXT_OP;
+            OP(assign_d)
+                REV_assign_d
+                NEXT_OP;
+            OP(assign_p)
+                REV_assign_p
+                NEXT_OP;
+            OP(neg_sign_p)
+                REV_neg_sign_p
+                NEXT_OP;
+            OP(recipr_p)
+                REV_recipr_p
+                NEXT_OP;
+            OP(assign_d_zero)
+                REV_assign_d_zero
+                NEXT_OP;
+            OP(assign_d_one)
+                REV_assign_d_one
+                NEXT_OP;
+            OP(eq_plus_d)
+                REV_eq_plus_d
+                NEXT_OP;
+            OP(eq_plus_p)
+                REV_eq_plus_p
+                NEXT_OP;
+            OP(eq_plus_a)
+                REV_eq_plus_a
+                NEXT_OP;
+            OP(eq_min_d)
+                REV_eq_min_d
+                NEXT_OP;
+            OP(eq_min_p)
+                REV_eq_min_p
+                NEXT_OP;
+            OP(eq_min_a)
+                REV_eq_min_a
+                NEXT_OP;
+            OP(eq_mult_d)
+                coval = vals[dop->val];
+                REV_eq_mult_d
+                NEXT_OP;
+            OP(eq_mult_p)
+                coval = params[arg];
+                REV_eq_mult_p
+                NEXT_OP;
+            OP(eq_mult_a)
+                REV_eq_mult_a
+                NEXT_OP;
+            OP(incr_a)
+                REV_incr_a
+                NEXT_OP;
+            OP(decr_a)
+                REV_decr_a
+                NEXT_OP;
+            OP(plus_a_a)
+                REV_plus_a_a
+                NEXT_OP;
+            OP(plus_a_a_a)
+                REV_plus_a_a_a
+                NEXT_OP;
+            OP(plus_d_a)
+                REV_plus_d_a
+                NEXT_OP;
+            OP(plus_a_p)
+                REV_plus_a_p
+                NEXT_OP;
+            OP(min_a_a)
+                REV_min_a_a
+                NEXT_OP;
+            OP(min_d_a)
+                REV_min_d_a
+                NEXT_OP;
+            OP(min_a_p)
+                REV_min_a_p
+                NEXT_OP;
+            OP(mult_a_a)
+                REV_mult_a_a
+                NEXT_OP;
+            OP(eq_plus_prod)
+                REV_eq_plus_prod
+                NEXT_OP;
+            OP(eq_min_prod)
+                REV_eq_min_prod
+                NEXT_OP;
+            OP(mult_d_a)
+                coval = vals[dop->val];
+                REV_mult_d_a
+                NEXT_OP;
+            OP(mult_a_p)
+                coval = params[arg1];
+                REV_mult_a_p
+                NEXT_OP;
+            OP(axpy_d_a)
+                coval = vals[dop->val];
+                REV_axpy_d_a
+                NEXT_OP;
+            OP(div_a_a)
+                REV_div_a_a
+                NEXT_OP;
+            OP(div_d_a)
+                REV_div_d_a
+                NEXT_OP;
+            OP(div_p_a)
+                REV_div_p_a
+                NEXT_OP;
+            OP(pos_sign_a)
+                REV_pos_sign_a
+                NEXT_OP;
+            OP(neg_sign_a)
+                REV_neg_sign_a
+                NEXT_OP;
+            OP(exp_op)
+                REV_exp_op
+                NEXT_OP;
+            OP(sin_op)
+                REV_sin_op
+                NEXT_OP;
+            OP(cos_op)
+                REV_cos_op
+                NEXT_OP;
+            OP(log_op)
+                REV_log_op
+                NEXT_OP;
+            OP(pow_op)
+                coval = vals[dop->val];
+                REV_pow_op
+                NEXT_OP;
+            OP(sqrt_op)
+                REV_sqrt_op
+                NEXT_OP;
+        }
+    }
+    END_OF_OPS
+}
+
+/****************************************************************************/
+/*                                                                 CLEAN UP */
+
+#undef RV
+#undef RA
+#undef AREAL
+#undef ADJOINT
+#undef PARTIAL
+#undef P0
+#undef P1
+#undef RESTORE
+#undef RESTORE_LINEAR
+#undef RESULT
+#undef RESULT_NESTED
+#undef LAGRANGE
+#undef LAGRANGE_NESTED
+#undef LAGRANGE_CLEAR
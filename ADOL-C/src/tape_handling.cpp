@@ -32,6 +32,9 @@
 #include <vector>
 #include <stack>
 #include <errno.h>
+#if defined(ADOLC_THREADLOCAL)
+#include <pthread.h>
+#endif
 
 using namespace std;
 
@@ -57,6 +60,16 @@ GlobalTapeVarsCL::GlobalTapeVarsCL() {
   numparam = 0;
   maxparam = 0;
   initialStoreSize = 0;
+  tapeCacheSize = 0;
+  tapeCacheClock = 0;
+  tapeCacheHits = 0;
+  tapeCacheMisses = 0;
+  tapeCacheEvictions = 0;
+  tayCodec = 0;
+  selectiveTaylors = 0;
+  tapeIOMode = 0;
+  optimizeTapes = 0;
+  decodeTapes = 0;
 #if defined(ADOLC_TRACK_ACTIVITY)
   storeManagerPtr = new StoreManagerLocintBlock(store, actStore, storeSize, numLives);
 #else
@@ -85,6 +98,20 @@ const GlobalTapeVarsCL& GlobalTapeVarsCL::operator=(const GlobalTapeVarsCL& gtv)
     valueBufferSize = gtv.valueBufferSize;
     taylorBufferSize = gtv.taylorBufferSize;
     maxNumberTaylorBuffers = gtv.maxNumberTaylorBuffers;
+    mmapTapes = gtv.mmapTapes;
+    numIOBuffers = gtv.numIOBuffers;
+    locFileFormat = gtv.locFileFormat;
+    tapeContainer = gtv.tapeContainer;
+    tapeCacheSize = gtv.tapeCacheSize;
+    tapeCacheClock = gtv.tapeCacheClock;
+    tapeCacheHits = gtv.tapeCacheHits;
+    tapeCacheMisses = gtv.tapeCacheMisses;
+    tayCodec = gtv.tayCodec;
+    selectiveTaylors = gtv.selectiveTaylors;
+    tapeIOMode = gtv.tapeIOMode;
+    optimizeTapes = gtv.optimizeTapes;
+    decodeTapes = gtv.decodeTapes;
+    tapeCacheEvictions = gtv.tapeCacheEvictions;
     inParallelRegion = gtv.inParallelRegion;
     newTape = gtv.newTape;
     branchSwitchWarning = gtv.branchSwitchWarning;
@@ -334,18 +361,18 @@ void free_loc(locint loc) {
 }
 
 /* vector of tape infos for all tapes in use */
-vector<TapeInfos *> ADOLC_TAPE_INFOS_BUFFER_DECL;
+ADOLC_THREAD_LOCAL vector<TapeInfos *> ADOLC_TAPE_INFOS_BUFFER_DECL;
 
 /* stack of pointers to tape infos
  * represents the order of tape usage when doing nested taping */
-stack<TapeInfos *> ADOLC_TAPE_STACK_DECL;
+ADOLC_THREAD_LOCAL stack<TapeInfos *> ADOLC_TAPE_STACK_DECL;
 
 /* the main tape info buffer and its fallback */
-TapeInfos ADOLC_CURRENT_TAPE_INFOS_DECL;
-TapeInfos ADOLC_CURRENT_TAPE_INFOS_FALLBACK_DECL;
+ADOLC_THREAD_LOCAL TapeInfos ADOLC_CURRENT_TAPE_INFOS_DECL;
+ADOLC_THREAD_LOCAL TapeInfos ADOLC_CURRENT_TAPE_INFOS_FALLBACK_DECL;
 
 /* global tapeing variables */
-GlobalTapeVars ADOLC_GLOBAL_TAPE_VARS_DECL;
+ADOLC_THREAD_LOCAL GlobalTapeVars ADOLC_GLOBAL_TAPE_VARS_DECL;
 
 #if defined(_OPENMP)
 static vector<TapeInfos *> *tapeInfosBuffer_s;
@@ -391,9 +418,27 @@ void initTapeInfos(TapeInfos *newTapeInfos) {
 
 /* as above but keep allocated buffers if possible */
 void initTapeInfos_keep(TapeInfos *newTapeInfos) {
-    unsigned char *opBuffer = newTapeInfos->opBuffer;
-    locint *locBuffer = newTapeInfos->locBuffer;
-    double *valBuffer = newTapeInfos->valBuffer;
+    unsigned char *opBuffer;
+    locint *locBuffer;
+    double *valBuffer;
+
+    if (newTapeInfos->sharedTape != NULL) {
+        /* a view is retaped into buffers of its own */
+        newTapeInfos->opBuffer = NULL;
+        newTapeInfos->locBuffer = NULL;
+        newTapeInfos->valBuffer = NULL;
+        newTapeInfos->decodedTape = NULL;
+    }
+    unmap_tape_files(newTapeInfos);
+    finish_tape_io(newTapeInfos);
+    free(newTapeInfos->locFrame);
+    free_block_index(newTapeInfos);
+    free_tay_index(newTapeInfos);
+    free_decoded_tape(newTapeInfos);
+    free_compiled_tape(newTapeInfos);
+    opBuffer = newTapeInfos->opBuffer;
+    locBuffer = newTapeInfos->locBuffer;
+    valBuffer = newTapeInfos->valBuffer;
     revreal *tayBuffer = newTapeInfos->tayBuffer;
     double *signature = newTapeInfos->signature;
     FILE *tay_file = newTapeInfos->tay_file;
@@ -441,8 +486,16 @@ int initNewTape(short tapeID) {
                         retval = 1;
                     }
                 }
+                finish_tape_io(*tiIter);
                 if ((*tiIter)->tay_file != NULL)
                     rewind((*tiIter)->tay_file);
+                /* files written by the tape cache are outdated now */
+                if ((*tiIter)->cacheOnDisk) {
+                    remove((*tiIter)->pTapeInfos.op_fileName);
+                    remove((*tiIter)->pTapeInfos.loc_fileName);
+                    remove((*tiIter)->pTapeInfos.val_fileName);
+                    remove((*tiIter)->pTapeInfos.container_fileName);
+                }
                 initTapeInfos_keep(*tiIter);
                 (*tiIter)->tapeID = tapeID;
 #ifdef SPARSE
@@ -507,6 +560,9 @@ int initNewTape(short tapeID) {
         ADOLC_GLOBAL_TAPE_VARS.valueBufferSize;
     newTapeInfos->stats[TAY_BUFFER_SIZE] =
         ADOLC_GLOBAL_TAPE_VARS.taylorBufferSize;
+    newTapeInfos->stats[LOC_FILE_FORMAT] =
+        ADOLC_GLOBAL_TAPE_VARS.locFileFormat;
+    newTapeInfos->containerTape = ADOLC_GLOBAL_TAPE_VARS.tapeContainer;
 
     /* update tapeStack and save tapeInfos */
     if (ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr != NULL) {
@@ -529,6 +585,62 @@ int initNewTape(short tapeID) {
     return retval;
 }
 
+#if defined(_OPENMP)
+/* lets a new view of a worker thread read the in-core buffers of the tape
+ * recorded in the serial part instead of tape files of its own - returns
+ * false if there is no such tape (the serial part does not run before
+ * endParallel drops the views) */
+static bool shareSerialTape(TapeInfos *view) {
+    TapeInfos *owner = NULL;
+    size_t numParams;
+    vector<TapeInfos *>::iterator tiIter;
+
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 0) return false;
+    for (tiIter=tapeInfosBuffer_s->begin();
+            tiIter!=tapeInfosBuffer_s->end();
+            ++tiIter)
+        if ((*tiIter)->tapeID == view->tapeID) owner = *tiIter;
+    if (owner == NULL || in_core_tape_size(owner) == 0) return false;
+
+    memcpy(view->stats, owner->stats, TAPE_STAT_SIZE * sizeof(size_t));
+    view->opBuffer = owner->opBuffer;
+    view->locBuffer = owner->locBuffer;
+    view->valBuffer = owner->valBuffer;
+    view->sharedTape = owner;
+    view->pTapeInfos.decodeTape = owner->pTapeInfos.decodeTape;
+    /* set_param_vec may change the parameters of a single thread */
+    numParams = owner->stats[NUM_PARAM];
+    if (numParams > 0 && owner->pTapeInfos.paramstore != NULL) {
+        view->pTapeInfos.paramstore =
+            (double *)malloc(numParams * sizeof(double));
+        if (view->pTapeInfos.paramstore == NULL) fail(ADOLC_MALLOC_FAILED);
+        memcpy(view->pTapeInfos.paramstore, owner->pTapeInfos.paramstore,
+                numParams * sizeof(double));
+    }
+    return true;
+}
+
+/* removes the views of serial tapes from the tape infos of the workers */
+static void dropSharedTapes(vector<TapeInfos *> *buffer) {
+    vector<TapeInfos *>::iterator tiIter;
+
+    for (tiIter=buffer->begin(); tiIter!=buffer->end(); )
+        if ((*tiIter)->sharedTape != NULL) {
+            freeTapeResources(*tiIter);
+            free((*tiIter)->pTapeInfos.op_fileName);
+            free((*tiIter)->pTapeInfos.loc_fileName);
+            free((*tiIter)->pTapeInfos.val_fileName);
+            free((*tiIter)->pTapeInfos.container_fileName);
+            free((*tiIter)->pTapeInfos.tay_fileName);
+            delete *tiIter;
+            tiIter = buffer->erase(tiIter);
+        } else ++tiIter;
+}
+#endif /* _OPENMP */
+
 /* opens an existing tape or creates a new handle for a tape on hard disk
  * - called from init_for_sweep and init_rev_sweep */
 void openTape(short tapeID, char mode) {
@@ -547,6 +659,7 @@ void openTape(short tapeID, char mode) {
                 /* tape has been used before (in the current program) */
                 if ((*tiIter)->inUse == 0) {
                     /* forward sweep */
+                    finish_tape_io(*tiIter);
                     if ((*tiIter)->tay_file != NULL)
                         rewind((*tiIter)->tay_file);
                     initTapeInfos_keep(*tiIter);
@@ -586,6 +699,9 @@ void openTape(short tapeID, char mode) {
     tempTapeInfos->tapingComplete = 1;
     ADOLC_TAPE_INFOS_BUFFER.push_back(tempTapeInfos);
 
+#if defined(_OPENMP)
+    if (!shareSerialTape(tempTapeInfos))
+#endif
     read_tape_stats(tempTapeInfos);
     /* update tapeStack and save tapeInfos */
     if (ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr != NULL) {
@@ -603,6 +719,50 @@ void openTape(short tapeID, char mode) {
     ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr = tempTapeInfos;
 }
 
+/* writes the parts of a tape kept in core to disk and releases its buffers
+ * (see evict_tape) - no tape may be active */
+void write_tape_files(TapeInfos *tapeInfos) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    /* evict_tape works on the current tape */
+    ADOLC_CURRENT_TAPE_INFOS_FALLBACK.copy(ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.copy(*tapeInfos);
+    evict_tape();
+    tapeInfos->copy(ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.copy(ADOLC_CURRENT_TAPE_INFOS_FALLBACK);
+}
+
+/* moves the least recently used in-core tapes to disk until all in-core
+ * tapes fit into the budget of the tape cache - no tape may be active */
+static void enforceTapeCache() {
+    TapeInfos *victim;
+    size_t used = 0;
+    vector<TapeInfos *>::iterator tiIter;
+
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize == 0) return;
+    for (tiIter=ADOLC_TAPE_INFOS_BUFFER.begin();
+            tiIter!=ADOLC_TAPE_INFOS_BUFFER.end();
+            ++tiIter)
+        used += in_core_tape_size(*tiIter);
+    while (used > ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize) {
+        victim = NULL;
+        for (tiIter=ADOLC_TAPE_INFOS_BUFFER.begin();
+                tiIter!=ADOLC_TAPE_INFOS_BUFFER.end();
+                ++tiIter)
+            if (in_core_tape_size(*tiIter) != 0 && (victim == NULL ||
+                        (*tiIter)->cacheStamp < victim->cacheStamp))
+                victim = *tiIter;
+        if (victim == NULL) break;
+        used -= in_core_tape_size(victim);
+        write_tape_files(victim);
+        ++ADOLC_GLOBAL_TAPE_VARS.tapeCacheEvictions;
+    }
+}
+
 /* release the current tape and give control to the previous one */
 void releaseTape() {
     ADOLC_OPENMP_THREAD_NUMBER;
@@ -616,6 +776,8 @@ void releaseTape() {
             ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 1 ) {
         ADOLC_CURRENT_TAPE_INFOS.inUse = 0;
     }
+    ADOLC_CURRENT_TAPE_INFOS.cacheStamp =
+        ++ADOLC_GLOBAL_TAPE_VARS.tapeCacheClock;
 
     ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr->copy(
             ADOLC_CURRENT_TAPE_INFOS);
@@ -623,8 +785,40 @@ void releaseTape() {
     ADOLC_CURRENT_TAPE_INFOS.copy(
             *ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr);
     ADOLC_TAPE_STACK.pop();
-    if (ADOLC_TAPE_STACK.empty())
+    if (ADOLC_TAPE_STACK.empty()) {
         ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr = NULL;
+        enforceTapeCache();
+    }
+}
+
+/* sets the byte budget of the in-core tape cache, 0 = no limit */
+void set_tape_cache_size(size_t bytes) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize = bytes;
+    if (ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr == NULL)
+        enforceTapeCache();
+}
+
+/* returns the counters of the in-core tape cache */
+void tape_cache_stats(size_t *cache_stats) {
+    size_t used = 0;
+    vector<TapeInfos *>::iterator tiIter;
+
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    for (tiIter=ADOLC_TAPE_INFOS_BUFFER.begin();
+            tiIter!=ADOLC_TAPE_INFOS_BUFFER.end();
+            ++tiIter)
+        used += in_core_tape_size(*tiIter);
+    cache_stats[TAPE_CACHE_HITS] = ADOLC_GLOBAL_TAPE_VARS.tapeCacheHits;
+    cache_stats[TAPE_CACHE_MISSES] = ADOLC_GLOBAL_TAPE_VARS.tapeCacheMisses;
+    cache_stats[TAPE_CACHE_EVICTIONS] =
+        ADOLC_GLOBAL_TAPE_VARS.tapeCacheEvictions;
+    cache_stats[TAPE_CACHE_BYTES] = used;
+    cache_stats[TAPE_CACHE_BUDGET] = ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize;
 }
 
 /* updates the tape infos for the given ID - a tapeInfos struct is created
@@ -775,6 +969,89 @@ void setTapeInfoHessSparse(short tapeID, SparseHessInfos sHinfos) {
 }
 #endif
 
+/* settings of a new environment not taken from .adolcrc */
+static void initEnvironment() {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    ADOLC_CURRENT_TAPE_INFOS.traceFlag = 0;
+    ADOLC_CURRENT_TAPE_INFOS.keepTaylors = 0;
+
+    ADOLC_GLOBAL_TAPE_VARS.maxLoc=1;
+    for (uint i=0; i<sizeof(locint)*8-1; ++i) {
+        ADOLC_GLOBAL_TAPE_VARS.maxLoc<<=1;
+        ++ADOLC_GLOBAL_TAPE_VARS.maxLoc;
+    }
+    ADOLC_GLOBAL_TAPE_VARS.inParallelRegion = 0;
+    ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr = NULL;
+    ADOLC_GLOBAL_TAPE_VARS.branchSwitchWarning = 1;
+
+    ADOLC_EXT_DIFF_FCTS_BUFFER.init(init_CpInfos);
+}
+
+#if defined(ADOLC_THREADLOCAL)
+ADOLC_THREAD_LOCAL unsigned int ADOLC_threadIndex = 0;
+
+static pthread_mutex_t threadMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t threadOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t threadKey;
+static unsigned int numThreadEnvironments = 0;
+/* the settings read from .adolcrc by the thread that loaded the library */
+static GlobalTapeVars *threadDefaults = NULL;
+
+static void exitThreadEnvironment(void *) {
+    if (globalTapeVars != NULL) cleanUp();
+}
+
+static void createThreadKey() {
+    pthread_key_create(&threadKey, exitThreadEnvironment);
+}
+
+/* copies the settings read from .adolcrc */
+static void copyTapeSettings(GlobalTapeVars *to, const GlobalTapeVars *from) {
+    to->operationBufferSize = from->operationBufferSize;
+    to->locationBufferSize = from->locationBufferSize;
+    to->valueBufferSize = from->valueBufferSize;
+    to->taylorBufferSize = from->taylorBufferSize;
+    to->maxNumberTaylorBuffers = from->maxNumberTaylorBuffers;
+    to->mmapTapes = from->mmapTapes;
+    to->numIOBuffers = from->numIOBuffers;
+    to->locFileFormat = from->locFileFormat;
+    to->tapeContainer = from->tapeContainer;
+    to->tapeCacheSize = from->tapeCacheSize;
+    to->tayCodec = from->tayCodec;
+    to->selectiveTaylors = from->selectiveTaylors;
+    to->tapeIOMode = from->tapeIOMode;
+    to->optimizeTapes = from->optimizeTapes;
+    to->decodeTapes = from->decodeTapes;
+    to->initialStoreSize = from->initialStoreSize;
+}
+
+/* creates the environment of a thread on its first call of ADOL-C, the
+ * thread that loaded the library finishes it in init_lib */
+void initThreadEnvironment() {
+    tapeInfosBuffer = new vector<TapeInfos *>;
+    tapeStack = new stack<TapeInfos *>;
+    currentTapeInfos = new TapeInfos;
+    currentTapeInfos->tapingComplete = 1;
+    currentTapeInfos_fallBack = new TapeInfos;
+    globalTapeVars = new GlobalTapeVars;
+    ADOLC_extDiffFctsBuffer = new ADOLC_BUFFER_TYPE;
+    ADOLC_checkpointsStack = new stack<StackElement>;
+    revolve_numbers = new revolve_nums;
+
+    pthread_once(&threadOnce, createThreadKey);
+    pthread_setspecific(threadKey, globalTapeVars);
+    pthread_mutex_lock(&threadMutex);
+    ADOLC_threadIndex = numThreadEnvironments++;
+    if (threadDefaults != NULL) {
+        initEnvironment();
+        copyTapeSettings(globalTapeVars, threadDefaults);
+    }
+    pthread_mutex_unlock(&threadMutex);
+}
+#endif /* ADOLC_THREADLOCAL */
+
 static void init_lib() {
     ADOLC_OPENMP_THREAD_NUMBER;
     errno = 0;
@@ -792,17 +1069,7 @@ static void init_lib() {
     revolve_numbers = new revolve_nums;
 #endif /* _OPENMP */
 
-    ADOLC_CURRENT_TAPE_INFOS.traceFlag = 0;
-    ADOLC_CURRENT_TAPE_INFOS.keepTaylors = 0;
-
-    ADOLC_GLOBAL_TAPE_VARS.maxLoc=1;
-    for (uint i=0; i<sizeof(locint)*8-1; ++i) {
-        ADOLC_GLOBAL_TAPE_VARS.maxLoc<<=1;
-        ++ADOLC_GLOBAL_TAPE_VARS.maxLoc;
-    }
-    ADOLC_GLOBAL_TAPE_VARS.inParallelRegion = 0;
-    ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr = NULL;
-    ADOLC_GLOBAL_TAPE_VARS.branchSwitchWarning = 1;
+    initEnvironment();
 
     adolc_id.adolc_ver    = ADOLC_VERSION;
     adolc_id.adolc_sub    = ADOLC_SUBVERSION;
@@ -811,8 +1078,13 @@ static void init_lib() {
     adolc_id.revreal_size = sizeof(revreal);
     adolc_id.address_size = sizeof(size_t);
 
-    ADOLC_EXT_DIFF_FCTS_BUFFER.init(init_CpInfos);
     readConfigFile();
+#if defined(ADOLC_THREADLOCAL)
+    pthread_mutex_lock(&threadMutex);
+    threadDefaults = new GlobalTapeVars;
+    copyTapeSettings(threadDefaults, globalTapeVars);
+    pthread_mutex_unlock(&threadMutex);
+#endif
 }
 
 static void clearCurrentTape() {
@@ -837,21 +1109,11 @@ void cleanUp() {
         ADOLC_TAPE_INFOS_BUFFER.pop_back();
         {
             /* close open files though they may be incomplete */
-            if ((*tiIter)->op_file!=NULL)
-            {
-                fclose((*tiIter)->op_file);
-                (*tiIter)->op_file = NULL;
-            }
-            if ((*tiIter)->val_file!=NULL)
-            {
-                fclose((*tiIter)->val_file);
-                (*tiIter)->val_file = NULL;
-            }
-            if ((*tiIter)->loc_file!=NULL)
-            {
-                fclose((*tiIter)->loc_file);
-                (*tiIter)->loc_file = NULL;
-            }
+            unmap_tape_files(*tiIter);
+            finish_tape_io(*tiIter);
+            close_tape_files(*tiIter);
+            free_block_index(*tiIter);
+            free_tay_index(*tiIter);
             if ((*tiIter)->tay_file!=NULL && (*tiIter)->pTapeInfos.skipFileCleanup==0 ) {
                 fclose((*tiIter)->tay_file);
                 (*tiIter)->tay_file = NULL;
@@ -872,6 +1134,11 @@ void cleanUp() {
                 free((*tiIter)->locBuffer);
                 (*tiIter)->locBuffer = NULL;
             }
+            if ((*tiIter)->locFrame != NULL)
+            {
+                free((*tiIter)->locFrame);
+                (*tiIter)->locFrame = NULL;
+            }
 	    if ((*tiIter)->signature != NULL)
 	    {
 		free((*tiIter)->signature);
@@ -908,17 +1175,19 @@ void cleanUp() {
             int filesWritten = (*tiIter)->stats[OP_FILE_ACCESS] +
                 (*tiIter)->stats[LOC_FILE_ACCESS] +
                 (*tiIter)->stats[VAL_FILE_ACCESS];
-            if ( (filesWritten > 0) && ((*tiIter)->pTapeInfos.keepTape == 0) && (*tiIter)->pTapeInfos.skipFileCleanup==0 )
+            if ( (filesWritten > 0 || (*tiIter)->cacheOnDisk) && ((*tiIter)->pTapeInfos.keepTape == 0) && (*tiIter)->pTapeInfos.skipFileCleanup==0 )
             {
                 /* try to remove all tapes (even those not written by this
                  * run) => this ensures that there is no mixture of tapes from
                  * different ADOLC runs */
-                if ( (*tiIter)->stats[OP_FILE_ACCESS] == 1 )
+                if ( (*tiIter)->stats[OP_FILE_ACCESS] == 1 || (*tiIter)->cacheOnDisk )
                     remove((*tiIter)->pTapeInfos.op_fileName);
-                if ( (*tiIter)->stats[LOC_FILE_ACCESS] == 1 )
+                if ( (*tiIter)->stats[LOC_FILE_ACCESS] == 1 || (*tiIter)->cacheOnDisk )
                     remove((*tiIter)->pTapeInfos.loc_fileName);
-                if ( (*tiIter)->stats[VAL_FILE_ACCESS] == 1 )
+                if ( (*tiIter)->stats[VAL_FILE_ACCESS] == 1 || (*tiIter)->cacheOnDisk )
                     remove((*tiIter)->pTapeInfos.val_fileName);
+                if ( (*tiIter)->containerTape )
+                    remove((*tiIter)->pTapeInfos.container_fileName);
             }
             if ((*tiIter)->pTapeInfos.op_fileName != NULL)
             {
@@ -935,6 +1204,11 @@ void cleanUp() {
                 free((*tiIter)->pTapeInfos.loc_fileName);
                 (*tiIter)->pTapeInfos.loc_fileName = NULL;
             }
+            if ((*tiIter)->pTapeInfos.container_fileName != NULL)
+            {
+                free((*tiIter)->pTapeInfos.container_fileName);
+                (*tiIter)->pTapeInfos.container_fileName = NULL;
+            }
             if ((*tiIter)->pTapeInfos.tay_fileName != NULL)
             {
                 free((*tiIter)->pTapeInfos.tay_fileName);
@@ -969,6 +1243,28 @@ void cleanUp() {
         delete tapeStack;
         delete tapeInfosBuffer;
     }
+#elif defined(ADOLC_THREADLOCAL)
+    /* a terminating thread or the program exits */
+    delete revolve_numbers;
+    delete ADOLC_checkpointsStack;
+    delete ADOLC_extDiffFctsBuffer;
+    delete globalTapeVars;
+    delete currentTapeInfos;
+    delete currentTapeInfos_fallBack;
+    delete tapeStack;
+    delete tapeInfosBuffer;
+    revolve_numbers = NULL;
+    ADOLC_checkpointsStack = NULL;
+    ADOLC_extDiffFctsBuffer = NULL;
+    globalTapeVars = NULL;
+    currentTapeInfos = NULL;
+    currentTapeInfos_fallBack = NULL;
+    tapeStack = NULL;
+    tapeInfosBuffer = NULL;
+    /* the base names belong to the thread that loaded the library */
+    if (ADOLC_threadIndex != 0) return;
+    delete threadDefaults;
+    threadDefaults = NULL;
 #endif
 
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
@@ -1028,11 +1324,13 @@ int removeTape(short tapeID, short type) {
         remove(tapeInfos->pTapeInfos.op_fileName);
         remove(tapeInfos->pTapeInfos.loc_fileName);
         remove(tapeInfos->pTapeInfos.val_fileName);
+        remove(tapeInfos->pTapeInfos.container_fileName);
     }
 
     free(tapeInfos->pTapeInfos.op_fileName);
     free(tapeInfos->pTapeInfos.val_fileName);
     free(tapeInfos->pTapeInfos.loc_fileName);
+    free(tapeInfos->pTapeInfos.container_fileName);
     if (tapeInfos->pTapeInfos.tay_fileName != NULL)
         free(tapeInfos->pTapeInfos.tay_fileName);
 
@@ -1096,12 +1394,18 @@ int trace_on(short tnum, int keepTaylors,
 /* enforces writing of the three main tape files (op+loc+val).              */
 /****************************************************************************/
 void trace_off(int flag) {
+    short tag;
+    bool optimize;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
     if (ADOLC_CURRENT_TAPE_INFOS.workMode != ADOLC_TAPING) {
 	failAdditionalInfo1 = ADOLC_CURRENT_TAPE_INFOS.tapeID;
 	fail(ADOLC_TAPING_NOT_ACTUALLY_TAPING);
     }
+    tag = ADOLC_CURRENT_TAPE_INFOS.tapeID;
+    /* optimizing would discard the taylors of trace_on(tag, 1) */
+    optimize = ADOLC_GLOBAL_TAPE_VARS.optimizeTapes != 0 &&
+        ADOLC_CURRENT_TAPE_INFOS.keepTaylors == 0;
     ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.keepTape = flag;
     keep_stock();         /* copy remaining live variables + trace_flag = 0 */
     stop_trace(flag);
@@ -1109,6 +1413,9 @@ void trace_off(int flag) {
     ADOLC_CURRENT_TAPE_INFOS.tapingComplete = 1;
     ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_NO_MODE;
     releaseTape();
+    /* not while nested in the recording of another tape */
+    if (optimize && ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr == NULL)
+        optimize_tape(tag);
 }
 
 bool isTaping() {
@@ -1294,6 +1601,10 @@ void endParallel() {
 
         firstParallel = false;
 
+        /* the serial tapes may change from now on */
+        for (int i = 0; i < numThreads; ++i)
+            dropSharedTapes(&tapeInfosBuffer[i]);
+
         revolve_numbers_p           = revolve_numbers;
         ADOLC_checkpointsStack_p    = ADOLC_checkpointsStack;
         ADOLC_extDiffFctsBuffer_p   = ADOLC_extDiffFctsBuffer;
@@ -1333,6 +1644,7 @@ TapeInfos::TapeInfos(short _tapeID) : pTapeInfos() {
     pTapeInfos.op_fileName = createFileName(tapeID, OPERATIONS_TAPE);
     pTapeInfos.loc_fileName = createFileName(tapeID, LOCATIONS_TAPE);
     pTapeInfos.val_fileName = createFileName(tapeID, VALUES_TAPE);
+    pTapeInfos.container_fileName = createFileName(tapeID, CONTAINER_TAPE);
     pTapeInfos.tay_fileName = NULL;
 }
 
@@ -0,0 +1,1341 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_optimize.c
+ Revision: $Id$
+ Contents: optimization passes over complete tapes
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "taping_p.h"
+#include "oplate.h"
+
+/****************************************************************************/
+/* The passes read the operations, locations and constants of a complete    */
+/* tape into memory, decide which operations to keep and record the kept    */
+/* ones as a new version of the tape. Operations are classified by the way  */
+/* they use the locations stored with them.                                 */
+/****************************************************************************/
+
+enum OptOpKinds {
+    OPT_PURE,         /* only defines its results, removable if they are dead */
+    OPT_EFFECT,     /* interface of the tape (inds, deps, comparisons, abs) */
+    OPT_NEUTRAL,                  /* does not touch values of locations */
+    OPT_BARRIER            /* vector and reference operations, any location */
+};
+
+typedef struct {
+    unsigned char numLocs;       /* # of locations stored with the operation */
+    unsigned char numVals;       /* # of constants stored with the operation */
+    unsigned char reads;                     /* bit i: location i is read */
+    unsigned char writes;                 /* bit i: location i is written */
+    unsigned char kind;                                 /* see OptOpKinds */
+} OptOpLayout;
+
+#define OPT_LOC(i) (1 << (i))
+
+typedef struct {
+    unsigned char *ops;
+    size_t numOps, maxOps;
+    size_t *locStart;       /* first location of each operation + sentinel */
+    size_t *valStart;        /* first constant of each operation + sentinel */
+    locint *locs;
+    size_t numLocs, maxLocs;
+    double *vals;
+    size_t numVals, maxVals;
+    size_t numLives;            /* # of store locations used by the tape */
+    size_t stats[TAPE_STAT_SIZE];                /* stats of the read version */
+    char keepTape, skipFileCleanup;
+} OptTape;
+
+static void setLayout(OptOpLayout *layout, int numLocs, int numVals,
+                      int reads, int writes, int kind) {
+    layout->numLocs = (unsigned char)numLocs;
+    layout->numVals = (unsigned char)numVals;
+    layout->reads = (unsigned char)reads;
+    layout->writes = (unsigned char)writes;
+    layout->kind = (unsigned char)kind;
+}
+
+/* describes the locations and constants stored with an operation as read by
+ * the forward sweeps, returns 0 for operations the passes do not handle
+ * (external functions, AMPI and MeDiPack) - the number of constants of
+ * take_stock_op is its first location */
+static int opLayout(unsigned char op, OptOpLayout *layout) {
+    switch (op) {
+        case death_not:
+            setLayout(layout, 2, 0, 0, 0, OPT_NEUTRAL);
+            break;
+        case take_stock_op:
+            setLayout(layout, 2, 0, 0, 0, OPT_EFFECT);
+            break;
+        case assign_ind:
+            setLayout(layout, 1, 0, 0, OPT_LOC(0), OPT_EFFECT);
+            break;
+        case assign_dep:
+            setLayout(layout, 1, 0, OPT_LOC(0), 0, OPT_EFFECT);
+            break;
+        case eq_zero:
+        case neq_zero:
+        case le_zero:
+        case gt_zero:
+        case ge_zero:
+        case lt_zero:
+            setLayout(layout, 1, 0, OPT_LOC(0), 0, OPT_EFFECT);
+            break;
+        case abs_val:
+            setLayout(layout, 2, 1, OPT_LOC(0), OPT_LOC(1), OPT_EFFECT);
+            break;
+        case eq_a_a:
+        case neq_a_a:
+        case le_a_a:
+        case gt_a_a:
+        case ge_a_a:
+        case lt_a_a:
+            setLayout(layout, 3, 1, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(2),
+                      OPT_EFFECT);
+            break;
+        case eq_a_p:
+        case neq_a_p:
+        case le_a_p:
+        case gt_a_p:
+        case ge_a_p:
+        case lt_a_p:
+            setLayout(layout, 3, 1, OPT_LOC(0), OPT_LOC(2), OPT_EFFECT);
+            break;
+
+        case assign_a:
+        case pos_sign_a:
+        case neg_sign_a:
+        case exp_op:
+        case log_op:
+        case sqrt_op:
+        case cbrt_op:
+            setLayout(layout, 2, 0, OPT_LOC(0), OPT_LOC(1), OPT_PURE);
+            break;
+        case assign_d:
+            setLayout(layout, 1, 1, 0, OPT_LOC(0), OPT_PURE);
+            break;
+        case assign_d_zero:
+        case assign_d_one:
+            setLayout(layout, 1, 0, 0, OPT_LOC(0), OPT_PURE);
+            break;
+        case assign_p:
+        case neg_sign_p:
+        case recipr_p:
+            setLayout(layout, 2, 0, 0, OPT_LOC(1), OPT_PURE);
+            break;
+        case eq_plus_d:
+        case eq_min_d:
+        case eq_mult_d:
+            setLayout(layout, 1, 1, OPT_LOC(0), OPT_LOC(0), OPT_PURE);
+            break;
+        case eq_plus_p:
+        case eq_min_p:
+        case eq_mult_p:
+            setLayout(layout, 2, 0, OPT_LOC(1), OPT_LOC(1), OPT_PURE);
+            break;
+        case eq_plus_a:
+        case eq_min_a:
+        case eq_mult_a:
+            setLayout(layout, 2, 0, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(1),
+                      OPT_PURE);
+            break;
+        case incr_a:
+        case decr_a:
+            setLayout(layout, 1, 0, OPT_LOC(0), OPT_LOC(0), OPT_PURE);
+            break;
+        case eq_plus_prod:
+        case eq_min_prod:
+            setLayout(layout, 3, 0, OPT_LOC(0) | OPT_LOC(1) | OPT_LOC(2),
+                      OPT_LOC(2), OPT_PURE);
+            break;
+        case plus_a_a:
+        case min_a_a:
+        case mult_a_a:
+        case div_a_a:
+        case atan_op:
+        case asin_op:
+        case acos_op:
+        case asinh_op:
+        case acosh_op:
+        case atanh_op:
+        case erf_op:
+            setLayout(layout, 3, 0, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(2),
+                      OPT_PURE);
+            break;
+        case plus_a_a_a:
+            setLayout(layout, 4, 0, OPT_LOC(0) | OPT_LOC(1) | OPT_LOC(2),
+                      OPT_LOC(3), OPT_PURE);
+            break;
+        case axpy_d_a:
+            setLayout(layout, 3, 1, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(2),
+                      OPT_PURE);
+            break;
+        case sin_op:
+        case cos_op:
+            setLayout(layout, 3, 0, OPT_LOC(0), OPT_LOC(1) | OPT_LOC(2),
+                      OPT_PURE);
+            break;
+        case plus_d_a:
+        case min_d_a:
+        case mult_d_a:
+        case div_d_a:
+        case pow_op:
+        case ceil_op:
+        case floor_op:
+            setLayout(layout, 2, 1, OPT_LOC(0), OPT_LOC(1), OPT_PURE);
+            break;
+        case plus_a_p:
+        case min_a_p:
+        case mult_a_p:
+        case div_p_a:
+        case pow_op_p:
+            setLayout(layout, 3, 0, OPT_LOC(0), OPT_LOC(2), OPT_PURE);
+            break;
+        case gen_quad:
+            setLayout(layout, 3, 2, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(2),
+                      OPT_PURE);
+            break;
+        case min_op:
+            setLayout(layout, 3, 1, OPT_LOC(0) | OPT_LOC(1), OPT_LOC(2),
+                      OPT_PURE);
+            break;
+        case cond_assign:
+        case cond_eq_assign:
+            setLayout(layout, 4, 1, OPT_LOC(0) | OPT_LOC(1) | OPT_LOC(2),
+                      OPT_LOC(3), OPT_PURE);
+            break;
+        case cond_assign_s:
+        case cond_eq_assign_s:
+            setLayout(layout, 3, 1, OPT_LOC(0) | OPT_LOC(1) | OPT_LOC(2),
+                      OPT_LOC(2), OPT_PURE);
+            break;
+
+        case ref_incr_a:
+        case ref_decr_a:
+        case ref_assign_d_zero:
+        case ref_assign_d_one:
+        case ref_assign_ind:
+            setLayout(layout, 1, 0, 0, 0, OPT_BARRIER);
+            break;
+        case ref_assign_d:
+        case ref_eq_plus_d:
+        case ref_eq_min_d:
+        case ref_eq_mult_d:
+            setLayout(layout, 1, 1, 0, 0, OPT_BARRIER);
+            break;
+        case ref_copyout:
+        case ref_assign_a:
+        case ref_assign_p:
+        case ref_eq_plus_a:
+        case ref_eq_min_a:
+        case ref_eq_mult_a:
+        case ref_eq_plus_p:
+        case ref_eq_min_p:
+        case ref_eq_mult_p:
+            setLayout(layout, 2, 0, 0, 0, OPT_BARRIER);
+            break;
+        case subscript:
+        case subscript_ref:
+        case ref_cond_assign_s:
+        case ref_cond_eq_assign_s:
+            setLayout(layout, 3, 1, 0, 0, OPT_BARRIER);
+            break;
+        case ref_cond_assign:
+        case ref_cond_eq_assign:
+            setLayout(layout, 4, 1, 0, 0, OPT_BARRIER);
+            break;
+        case vec_copy:
+            setLayout(layout, 3, 0, 0, 0, OPT_BARRIER);
+            break;
+        case vec_dot:
+            setLayout(layout, 4, 0, 0, 0, OPT_BARRIER);
+            break;
+        case vec_axpy:
+            setLayout(layout, 5, 0, 0, 0, OPT_BARRIER);
+            break;
+
+        default:
+            return 0;
+    }
+    return 1;
+}
+
+/* makes room for "need" elements of size "size" in "*array" */
+static void *growArray(void *array, size_t *max, size_t need, size_t size) {
+    if (need <= *max) return array;
+    while (*max < need) *max = (*max == 0) ? 1024 : 2 * *max;
+    array = realloc(array, *max * size);
+    if (array == NULL) fail(ADOLC_MALLOC_FAILED);
+    return array;
+}
+
+/* starts the empty tape "out" with the stats of "in" */
+static void initOptTape(OptTape *out, const OptTape *in) {
+    memset(out, 0, sizeof(OptTape));
+    memcpy(out->stats, in->stats, TAPE_STAT_SIZE * sizeof(size_t));
+    out->keepTape = in->keepTape;
+    out->skipFileCleanup = in->skipFileCleanup;
+    out->numLives = in->numLives;
+}
+
+static void freeOptTape(OptTape *tape) {
+    free(tape->ops);
+    free(tape->locStart);
+    free(tape->valStart);
+    free(tape->locs);
+    free(tape->vals);
+}
+
+/* appends an operation with its locations and constants to "tape" */
+static void appendOp(OptTape *tape, unsigned char op, const locint *locs,
+                     const double *vals) {
+    OptOpLayout layout;
+    size_t numVals, end;
+    int i;
+
+    opLayout(op, &layout);
+    numVals = (op == take_stock_op) ? locs[0] : layout.numVals;
+    if (tape->numOps == tape->maxOps) {
+        tape->ops = (unsigned char *)growArray(tape->ops, &tape->maxOps,
+                tape->numOps + 1, sizeof(unsigned char));
+        tape->locStart = (size_t *)realloc(tape->locStart,
+                (tape->maxOps + 1) * sizeof(size_t));
+        tape->valStart = (size_t *)realloc(tape->valStart,
+                (tape->maxOps + 1) * sizeof(size_t));
+        if (tape->locStart == NULL || tape->valStart == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+    }
+    tape->locs = (locint *)growArray(tape->locs, &tape->maxLocs,
+            tape->numLocs + layout.numLocs, sizeof(locint));
+    tape->vals = (double *)growArray(tape->vals, &tape->maxVals,
+            tape->numVals + numVals, sizeof(double));
+    tape->ops[tape->numOps] = op;
+    tape->locStart[tape->numOps] = tape->numLocs;
+    tape->valStart[tape->numOps] = tape->numVals;
+    memcpy(tape->locs + tape->numLocs, locs, layout.numLocs * sizeof(locint));
+    if (numVals > 0)
+        memcpy(tape->vals + tape->numVals, vals, numVals * sizeof(double));
+    for (i = 0; i < layout.numLocs; ++i)
+        if (((layout.reads | layout.writes) & OPT_LOC(i)) &&
+                locs[i] >= tape->numLives)
+            tape->numLives = locs[i] + 1;
+    if (op == take_stock_op) {
+        end = (size_t)locs[1] + locs[0];
+        if (end > tape->numLives) tape->numLives = end;
+    }
+    tape->numLocs += layout.numLocs;
+    tape->numVals += numVals;
+    ++tape->numOps;
+    tape->locStart[tape->numOps] = tape->numLocs;
+    tape->valStart[tape->numOps] = tape->numVals;
+}
+
+/* reads all operations of tape "tag" with their locations and constants,
+ * returns 0 if the tape contains an operation not handled by the passes */
+static int readOptTape(short tag, OptTape *tape) {
+    OptOpLayout layout;
+    unsigned char operation;
+    locint locs[5];
+    double vals[2];
+    int i, supported = 1;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    memset(tape, 0, sizeof(OptTape));
+    init_for_sweep(tag);
+    memcpy(tape->stats, ADOLC_CURRENT_TAPE_INFOS.stats,
+           TAPE_STAT_SIZE * sizeof(size_t));
+    tape->keepTape = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.keepTape;
+    tape->skipFileCleanup =
+        ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.skipFileCleanup;
+    tape->numLives = tape->stats[NUM_MAX_LIVES];
+    operation = get_op_f();
+    while (operation != end_of_tape) {
+        switch (operation) {
+            case end_of_op:
+                get_op_block_f();
+                operation = get_op_f();
+                /* Skip next operation, it's another end_of_op */
+                break;
+            case end_of_int:
+                get_loc_block_f();
+                break;
+            case end_of_val:
+                get_val_block_f();
+                break;
+            case start_of_tape:
+                break;
+            default:
+                if (!opLayout(operation, &layout)) {
+                    supported = 0;
+                    break;
+                }
+                for (i = 0; i < layout.numLocs; ++i)
+                    locs[i] = get_locint_f();
+                if (operation == take_stock_op)
+                    appendOp(tape, operation, locs, get_val_v_f(locs[0]));
+                else {
+                    for (i = 0; i < layout.numVals; ++i)
+                        vals[i] = get_val_f();
+                    appendOp(tape, operation, locs, vals);
+                }
+                break;
+        }
+        if (!supported) break;
+        operation = get_op_f();
+    }
+    end_sweep();
+    return supported;
+}
+
+/****************************************************************************/
+/* Liveness of the store locations during a backward pass. A location is    */
+/* live if it holds a value still needed by a kept operation. The state of  */
+/* a location is only valid if it was set in the current generation, older  */
+/* states fall back to "allLive" which barriers use to make everything live */
+/****************************************************************************/
+
+typedef struct {
+    size_t *state;                    /* 2 * generation + (live ? 1 : 0) */
+    size_t generation;
+    int allLive;
+} OptLiveness;
+
+static int isLive(const OptLiveness *live, locint loc) {
+    if (live->state[loc] >= 2 * live->generation)
+        return (int)(live->state[loc] & 1);
+    return live->allLive;
+}
+
+static void setLive(OptLiveness *live, locint loc, int flag) {
+    live->state[loc] = 2 * live->generation + (flag ? 1 : 0);
+}
+
+/* marks the operations of "tape" whose results never reach a dependent or
+ * a kept comparison/abs, returns the number of remaining operations */
+static size_t markDeadOps(const OptTape *tape, char *keep) {
+    OptLiveness live;
+    OptOpLayout layout;
+    const locint *locs;
+    size_t op, numKept = 0;
+    locint l;
+    int i, used;
+
+    live.state = (size_t *)calloc(tape->numLives + 1, sizeof(size_t));
+    if (live.state == NULL) fail(ADOLC_MALLOC_FAILED);
+    live.generation = 1;
+    live.allLive = 0;
+    for (op = tape->numOps; op-- > 0; ) {
+        opLayout(tape->ops[op], &layout);
+        locs = tape->locs + tape->locStart[op];
+        keep[op] = 1;
+        switch (layout.kind) {
+            case OPT_PURE:
+                used = 0;
+                for (i = 0; i < layout.numLocs; ++i)
+                    if ((layout.writes & OPT_LOC(i)) && isLive(&live, locs[i]))
+                        used = 1;
+                if (!used) {
+                    keep[op] = 0;
+                    break;
+                }
+                /* fall through */
+            case OPT_EFFECT:
+                for (i = 0; i < layout.numLocs; ++i)
+                    if (layout.writes & OPT_LOC(i))
+                        setLive(&live, locs[i], 0);
+                if (tape->ops[op] == take_stock_op)
+                    for (l = 0; l < locs[0]; ++l)
+                        setLive(&live, locs[1] + l, 0);
+                for (i = 0; i < layout.numLocs; ++i)
+                    if (layout.reads & OPT_LOC(i))
+                        setLive(&live, locs[i], 1);
+                break;
+            case OPT_BARRIER:
+                ++live.generation;
+                live.allLive = 1;
+                break;
+            default:
+                break;
+        }
+        if (keep[op]) ++numKept;
+    }
+    free(live.state);
+    return numKept;
+}
+
+/****************************************************************************/
+/* Value numbering for constant folding and common subexpression            */
+/* elimination. Every value computed on the tape gets a number, equal       */
+/* numbers denote equal values with equal derivatives. An operation that    */
+/* recomputes a known number is replaced by a copy of a location still      */
+/* holding it, and arguments are read from the location that computed them */
+/* first, such that the copies mostly become dead. Barriers forget the      */
+/* numbers of all locations.                                                */
+/****************************************************************************/
+
+typedef struct {
+    unsigned char op;
+    size_t arg1, arg2;     /* value numbers of arguments, parameter indices */
+    double val;
+    size_t num, num2;    /* numbers of the result(s), 0 marks empty slots */
+} OptExpr;
+
+typedef struct {
+    size_t *locNum;                 /* number of the value of each location */
+    size_t *locGen;                 /* generation in which it has been set */
+    size_t generation;
+    locint *home;                   /* a location holding each number */
+    char *isConst;
+    double *constVal;
+    size_t numNums, maxNums;
+    OptExpr *exprs;             /* hash table of the computed expressions */
+    size_t numExprs, maxExprs;
+} OptValues;
+
+static size_t newNumber(OptValues *values, locint home, int isConst,
+                        double value) {
+    size_t max = values->maxNums;
+
+    values->home = (locint *)growArray(values->home, &max,
+            values->numNums + 1, sizeof(locint));
+    max = values->maxNums;
+    values->isConst = (char *)growArray(values->isConst, &max,
+            values->numNums + 1, sizeof(char));
+    values->constVal = (double *)growArray(values->constVal,
+            &values->maxNums, values->numNums + 1, sizeof(double));
+    values->home[values->numNums] = home;
+    values->isConst[values->numNums] = (char)isConst;
+    values->constVal[values->numNums] = value;
+    return values->numNums++;
+}
+
+static int holds(const OptValues *values, locint loc, size_t num) {
+    return values->locGen[loc] == values->generation &&
+        values->locNum[loc] == num;
+}
+
+static void defineLoc(OptValues *values, locint loc, size_t num) {
+    values->locNum[loc] = num;
+    values->locGen[loc] = values->generation;
+    if (!holds(values, values->home[num], num))
+        values->home[num] = loc;
+}
+
+/* number of the value in "loc", a new one if it is not known */
+static size_t valueOf(OptValues *values, locint loc) {
+    if (values->locGen[loc] != values->generation)
+        defineLoc(values, loc, newNumber(values, loc, 0, 0.0));
+    return values->locNum[loc];
+}
+
+/* the location that computed the value of "loc" if it still holds it */
+static locint homeOf(OptValues *values, locint loc) {
+    size_t num = valueOf(values, loc);
+    return holds(values, values->home[num], num) ? values->home[num] : loc;
+}
+
+static int isConstant(OptValues *values, locint loc, double value) {
+    size_t num = valueOf(values, loc);
+    return values->isConst[num] && values->constVal[num] == value;
+}
+
+static size_t hashExpr(const OptExpr *expr) {
+    unsigned long long h = 14695981039346656037ULL, bits;
+
+    memcpy(&bits, &expr->val, sizeof(double));
+    h = (h ^ expr->op) * 1099511628211ULL;
+    h = (h ^ expr->arg1) * 1099511628211ULL;
+    h = (h ^ expr->arg2) * 1099511628211ULL;
+    h = (h ^ bits) * 1099511628211ULL;
+    return (size_t)(h ^ (h >> 29));
+}
+
+/* the slot of "key" in the hash table, empty if it is not there yet */
+static OptExpr *findExpr(const OptValues *values, const OptExpr *key) {
+    size_t i = hashExpr(key) & (values->maxExprs - 1);
+    OptExpr *expr;
+
+    for (;;) {
+        expr = values->exprs + i;
+        if (expr->num == 0 || (expr->op == key->op &&
+                    expr->arg1 == key->arg1 && expr->arg2 == key->arg2 &&
+                    memcmp(&expr->val, &key->val, sizeof(double)) == 0))
+            return expr;
+        i = (i + 1) & (values->maxExprs - 1);
+    }
+}
+
+/* makes room for one more expression, the table stays half empty */
+static void reserveExpr(OptValues *values) {
+    OptExpr *old = values->exprs;
+    size_t i, oldMax = values->maxExprs;
+
+    if (2 * (values->numExprs + 1) <= values->maxExprs) return;
+    values->maxExprs = (oldMax == 0) ? 1024 : 2 * oldMax;
+    values->exprs = (OptExpr *)calloc(values->maxExprs, sizeof(OptExpr));
+    if (values->exprs == NULL) fail(ADOLC_MALLOC_FAILED);
+    for (i = 0; i < oldMax; ++i)
+        if (old[i].num != 0) *findExpr(values, old + i) = old[i];
+    free(old);
+}
+
+static void setKey(OptExpr *key, unsigned char op, size_t arg1, size_t arg2,
+                   double val) {
+    memset(key, 0, sizeof(OptExpr));
+    key->op = op;
+    key->arg1 = arg1;
+    key->arg2 = arg2;
+    key->val = val;
+}
+
+static void emitOp(OptTape *out, unsigned char op, locint arg, locint res) {
+    locint locs[2];
+
+    locs[0] = arg;
+    locs[1] = res;
+    appendOp(out, op, locs, NULL);
+}
+
+/* sets "res" to the constant "value" */
+static int emitConst(OptValues *values, OptTape *out, locint res,
+                     double value) {
+    OptExpr key, *expr;
+    size_t num;
+
+    setKey(&key, assign_d, 0, 0, value);
+    reserveExpr(values);
+    expr = findExpr(values, &key);
+    if (expr->num == 0) {
+        *expr = key;
+        expr->num = newNumber(values, res, 1, value);
+        ++values->numExprs;
+    }
+    num = expr->num;
+    if (holds(values, res, num)) return 1;
+    if (value == 0.0)
+        appendOp(out, assign_d_zero, &res, NULL);
+    else if (value == 1.0)
+        appendOp(out, assign_d_one, &res, NULL);
+    else
+        appendOp(out, assign_d, &res, &value);
+    defineLoc(values, res, num);
+    return 1;
+}
+
+/* sets "res" to the value of "arg" */
+static int emitCopy(OptValues *values, OptTape *out, locint arg, locint res) {
+    size_t num = valueOf(values, arg);
+
+    if (values->isConst[num])
+        return emitConst(values, out, res, values->constVal[num]);
+    if (holds(values, res, num)) return 1;
+    emitOp(out, assign_a, homeOf(values, arg), res);
+    defineLoc(values, res, num);
+    return 1;
+}
+
+/* records an operation computing the expression "key" into the location
+ * "locs[resIdx]" (and the second result of sin_op and cos_op into
+ * "locs[1]") unless a location holding the value can be copied */
+static int emitExpr(OptValues *values, OptTape *out, OptExpr *key,
+                    unsigned char op, const locint *locs, const double *vals,
+                    int resIdx) {
+    OptExpr *expr;
+    locint res = locs[resIdx];
+    int twoResults = (op == sin_op || op == cos_op);
+
+    reserveExpr(values);
+    expr = findExpr(values, key);
+    if (expr->num == 0) {
+        *expr = *key;
+        expr->num = newNumber(values, res, 0, 0.0);
+        if (twoResults) expr->num2 = newNumber(values, locs[1], 0, 0.0);
+        ++values->numExprs;
+    } else if (!twoResults) {
+        if (holds(values, res, expr->num)) return 1;
+        if (holds(values, values->home[expr->num], expr->num)) {
+            emitOp(out, assign_a, values->home[expr->num], res);
+            defineLoc(values, res, expr->num);
+            return 1;
+        }
+    } else if (holds(values, values->home[expr->num], expr->num) &&
+               holds(values, values->home[expr->num2], expr->num2) &&
+               values->home[expr->num] != locs[1]) {
+        if (!holds(values, locs[1], expr->num2))
+            emitOp(out, assign_a, values->home[expr->num2], locs[1]);
+        defineLoc(values, locs[1], expr->num2);
+        if (!holds(values, res, expr->num))
+            emitOp(out, assign_a, values->home[expr->num], res);
+        defineLoc(values, res, expr->num);
+        return 1;
+    }
+    appendOp(out, op, locs, vals);
+    if (twoResults) defineLoc(values, locs[1], expr->num2);
+    defineLoc(values, res, expr->num);
+    return 1;
+}
+
+/* folds operations on constants and identities and replaces recomputed
+ * expressions, returns 0 if "op" has to be recorded unchanged */
+static int foldOp(OptValues *values, OptTape *out, unsigned char op,
+                  const locint *locs, const double *vals) {
+    OptExpr key;
+    size_t a, b;
+    double x, y;
+
+    switch (op) {
+        case assign_a:
+            return emitCopy(values, out, locs[0], locs[1]);
+        case assign_d:
+            return emitConst(values, out, locs[0], vals[0]);
+        case assign_d_zero:
+            return emitConst(values, out, locs[0], 0.0);
+        case assign_d_one:
+            return emitConst(values, out, locs[0], 1.0);
+
+        case eq_plus_d:
+        case eq_min_d:
+        case eq_mult_d:
+            if (op == eq_mult_d ? vals[0] == 1.0 : vals[0] == 0.0)
+                return 1;                          /* value is unchanged */
+            a = valueOf(values, locs[0]);
+            if (!values->isConst[a]) return 0;
+            x = values->constVal[a];
+            return emitConst(values, out, locs[0], op == eq_plus_d ?
+                             x + vals[0] : op == eq_min_d ? x - vals[0] :
+                             x * vals[0]);
+        case eq_plus_a:
+        case eq_min_a:
+        case eq_mult_a:
+            if (isConstant(values, locs[0], op == eq_mult_a ? 1.0 : 0.0))
+                return 1;                          /* value is unchanged */
+            a = valueOf(values, locs[1]);
+            b = valueOf(values, locs[0]);
+            if (!values->isConst[a] || !values->isConst[b]) return 0;
+            x = values->constVal[a];
+            y = values->constVal[b];
+            return emitConst(values, out, locs[1], op == eq_plus_a ? x + y :
+                             op == eq_min_a ? x - y : x * y);
+
+        case plus_d_a:
+        case min_d_a:
+        case mult_d_a:
+        case div_d_a:
+            a = valueOf(values, locs[0]);
+            if (values->isConst[a]) {
+                x = values->constVal[a];
+                return emitConst(values, out, locs[1], op == plus_d_a ?
+                                 x + vals[0] : op == min_d_a ? vals[0] - x :
+                                 op == mult_d_a ? x * vals[0] : vals[0] / x);
+            }
+            if ((op == plus_d_a && vals[0] == 0.0) ||
+                    (op == mult_d_a && vals[0] == 1.0))
+                return emitCopy(values, out, locs[0], locs[1]);
+            setKey(&key, op, a, 0, vals[0]);
+            return emitExpr(values, out, &key, op, locs, vals, 1);
+
+        case plus_a_a:
+        case min_a_a:
+        case mult_a_a:
+        case div_a_a:
+            a = valueOf(values, locs[0]);
+            b = valueOf(values, locs[1]);
+            if (values->isConst[a] && values->isConst[b]) {
+                x = values->constVal[a];
+                y = values->constVal[b];
+                return emitConst(values, out, locs[2], op == plus_a_a ?
+                                 x + y : op == min_a_a ? x - y :
+                                 op == mult_a_a ? x * y : x / y);
+            }
+            if ((op == plus_a_a || op == min_a_a) &&
+                    isConstant(values, locs[1], 0.0))
+                return emitCopy(values, out, locs[0], locs[2]);
+            if ((op == mult_a_a || op == div_a_a) &&
+                    isConstant(values, locs[1], 1.0))
+                return emitCopy(values, out, locs[0], locs[2]);
+            if (op == plus_a_a && isConstant(values, locs[0], 0.0))
+                return emitCopy(values, out, locs[1], locs[2]);
+            if (op == mult_a_a && isConstant(values, locs[0], 1.0))
+                return emitCopy(values, out, locs[1], locs[2]);
+            if ((op == plus_a_a || op == mult_a_a) && b < a)
+                setKey(&key, op, b, a, 0.0);             /* commutative */
+            else
+                setKey(&key, op, a, b, 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 2);
+
+        case pos_sign_a:
+            return emitCopy(values, out, locs[0], locs[1]);
+        case neg_sign_a:
+            a = valueOf(values, locs[0]);
+            if (values->isConst[a])
+                return emitConst(values, out, locs[1], -values->constVal[a]);
+            setKey(&key, op, a, 0, 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 1);
+        case exp_op:
+        case log_op:
+        case sqrt_op:
+        case cbrt_op:
+            setKey(&key, op, valueOf(values, locs[0]), 0, 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 1);
+        case pow_op:
+            setKey(&key, op, valueOf(values, locs[0]), 0, vals[0]);
+            return emitExpr(values, out, &key, op, locs, vals, 1);
+        case sin_op:
+        case cos_op:
+            setKey(&key, op, valueOf(values, locs[0]), 0, 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 2);
+        case atan_op:
+        case asin_op:
+        case acos_op:
+        case asinh_op:
+        case acosh_op:
+        case atanh_op:
+        case erf_op:
+            setKey(&key, op, valueOf(values, locs[0]),
+                   valueOf(values, locs[1]), 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 2);
+        case assign_p:
+        case neg_sign_p:
+        case recipr_p:
+            setKey(&key, op, locs[0], 0, 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 1);
+        case plus_a_p:
+        case min_a_p:
+        case mult_a_p:
+        case div_p_a:
+        case pow_op_p:
+            setKey(&key, op, valueOf(values, locs[0]), locs[1], 0.0);
+            return emitExpr(values, out, &key, op, locs, vals, 2);
+        default:
+            return 0;
+    }
+}
+
+/* records the operations of "in" into "out" with constants folded and
+ * recomputations replaced by copies, see markDeadOps for the copies */
+static void foldOptTape(const OptTape *in, OptTape *out) {
+    OptValues values;
+    OptOpLayout layout;
+    locint locs[5], loc;
+    const double *vals;
+    size_t op;
+    int i, j, written;
+
+    initOptTape(out, in);
+
+    memset(&values, 0, sizeof(OptValues));
+    values.locNum = (size_t *)calloc(in->numLives + 1, sizeof(size_t));
+    values.locGen = (size_t *)calloc(in->numLives + 1, sizeof(size_t));
+    if (values.locNum == NULL || values.locGen == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    values.generation = 1;
+    newNumber(&values, 0, 0, 0.0);              /* 0 marks empty slots */
+
+    for (op = 0; op < in->numOps; ++op) {
+        opLayout(in->ops[op], &layout);
+        memcpy(locs, in->locs + in->locStart[op],
+               layout.numLocs * sizeof(locint));
+        vals = in->vals + in->valStart[op];
+        if (layout.kind == OPT_BARRIER)
+            ++values.generation;
+        else if (in->ops[op] == take_stock_op)
+            for (loc = 0; loc < locs[0]; ++loc)
+                defineLoc(&values, locs[1] + loc,
+                          newNumber(&values, locs[1] + loc, 0, 0.0));
+        if (layout.kind == OPT_BARRIER || layout.kind == OPT_NEUTRAL ||
+                in->ops[op] == take_stock_op) {
+            appendOp(out, in->ops[op], locs, vals);
+            continue;
+        }
+        /* read arguments where they have been computed first, the seeds
+         * of the dependents stay at their locations */
+        if (in->ops[op] != assign_dep)
+            for (i = 0; i < layout.numLocs; ++i) {
+                if (!(layout.reads & OPT_LOC(i)) ||
+                        (layout.writes & OPT_LOC(i)))
+                    continue;
+                loc = homeOf(&values, locs[i]);
+                written = 0;
+                for (j = 0; j < layout.numLocs; ++j)
+                    if ((layout.writes & OPT_LOC(j)) && locs[j] == loc)
+                        written = 1;
+                if (!written) locs[i] = loc;
+            }
+        if (layout.kind == OPT_PURE &&
+                foldOp(&values, out, in->ops[op], locs, vals))
+            continue;
+        appendOp(out, in->ops[op], locs, vals);
+        for (i = 0; i < layout.numLocs; ++i)
+            if (layout.writes & OPT_LOC(i))
+                defineLoc(&values, locs[i],
+                          newNumber(&values, locs[i], 0, 0.0));
+    }
+
+    free(values.locNum);
+    free(values.locGen);
+    free(values.home);
+    free(values.isConst);
+    free(values.constVal);
+    free(values.exprs);
+}
+
+/* records the kept operations of "in" into "out" */
+static void compactOptTape(const OptTape *in, const char *keep, OptTape *out) {
+    size_t op;
+
+    initOptTape(out, in);
+    for (op = 0; op < in->numOps; ++op)
+        if (keep[op])
+            appendOp(out, in->ops[op], in->locs + in->locStart[op],
+                     in->vals + in->valStart[op]);
+}
+
+/****************************************************************************/
+/* Renumbering of the store locations. A value occupies a location from the */
+/* operation computing it up to its last use. The values get new locations */
+/* in the order of their definition, reusing the locations of dead values   */
+/* first, which needs no more locations than values are live at the same    */
+/* time. Results never share a location with an argument of the same        */
+/* operation. Tapes with barriers keep their locations, the vector and      */
+/* reference operations compute locations from values.                      */
+/****************************************************************************/
+
+#define OPT_NO_LOC ((locint)-1)
+
+typedef struct {
+    locint *map;               /* new location of the value in a location */
+    locint *free;                        /* stack of unused new locations */
+    size_t numFree, maxFree;
+    size_t numNew;                        /* # of new locations handed out */
+} OptLocations;
+
+static locint newLocation(OptLocations *locations) {
+    if (locations->numFree > 0)
+        return locations->free[--locations->numFree];
+    return (locint)locations->numNew++;
+}
+
+/* the location of "loc" dies with the value it holds */
+static void freeLocation(OptLocations *locations, locint loc) {
+    if (locations->map[loc] == OPT_NO_LOC) return;
+    locations->free = (locint *)growArray(locations->free,
+            &locations->maxFree, locations->numFree + 1, sizeof(locint));
+    locations->free[locations->numFree++] = locations->map[loc];
+    locations->map[loc] = OPT_NO_LOC;
+}
+
+/* new location of the value read from "loc", values read without being
+ * defined on the tape get a location of their own */
+static locint mapLocation(OptLocations *locations, locint loc) {
+    if (locations->map[loc] == OPT_NO_LOC)
+        locations->map[loc] = newLocation(locations);
+    return locations->map[loc];
+}
+
+/* marks the locations stored with the operations of "tape" whose value is
+ * not used after the operation, "stockLive" marks the locations set by
+ * take_stock_op that are used later, barriers may use any location */
+static void markLastUses(const OptTape *tape, char *dies, char *stockLive) {
+    OptOpLayout layout;
+    const locint *locs;
+    char *live;
+    size_t op, start;
+    locint l;
+    int i, j;
+
+    live = (char *)calloc(tape->numLives + 1, sizeof(char));
+    if (live == NULL) fail(ADOLC_MALLOC_FAILED);
+    for (op = tape->numOps; op-- > 0; ) {
+        opLayout(tape->ops[op], &layout);
+        start = tape->locStart[op];
+        locs = tape->locs + start;
+        if (tape->ops[op] == take_stock_op) {
+            for (l = 0; l < locs[0]; ++l) {
+                stockLive[locs[1] + l] = live[locs[1] + l];
+                live[locs[1] + l] = 0;
+            }
+            continue;
+        }
+        if (layout.kind == OPT_BARRIER) {
+            memset(live, 1, tape->numLives + 1);
+            continue;
+        }
+        for (i = 0; i < layout.numLocs; ++i) {
+            if (!((layout.reads | layout.writes) & OPT_LOC(i))) continue;
+            dies[start + i] = (char)!live[locs[i]];
+            /* an argument overwritten by a new result of the operation */
+            if (!(layout.writes & OPT_LOC(i)))
+                for (j = 0; j < layout.numLocs; ++j)
+                    if ((layout.writes & OPT_LOC(j)) &&
+                            !(layout.reads & OPT_LOC(j)) && locs[j] == locs[i])
+                        dies[start + i] = 1;
+        }
+        for (i = 0; i < layout.numLocs; ++i)
+            if (layout.writes & OPT_LOC(i))
+                live[locs[i]] = 0;
+        for (i = 0; i < layout.numLocs; ++i)
+            if (layout.reads & OPT_LOC(i))
+                live[locs[i]] = 1;
+    }
+    free(live);
+}
+
+/* records the operations of "in" into "out" with renumbered locations,
+ * returns 0 if "in" has to keep its locations or needs no less of them */
+static int renumberOptTape(const OptTape *in, OptTape *out) {
+    OptLocations locations;
+    OptOpLayout layout;
+    char *dies, *stockLive;
+    const locint *locs;
+    locint newLocs[5], l, first;
+    double *stockVals;
+    size_t op, start, numStock;
+    int i, done = 1;
+
+    for (op = 0; op < in->numOps; ++op) {
+        opLayout(in->ops[op], &layout);
+        /* death_not ends the tape, see keep_stock */
+        if (layout.kind == OPT_BARRIER ||
+                (in->ops[op] == death_not && op + 1 < in->numOps))
+            return 0;
+    }
+
+    initOptTape(out, in);
+    out->numLives = 0;
+    memset(&locations, 0, sizeof(OptLocations));
+    locations.map = (locint *)malloc((in->numLives + 1) * sizeof(locint));
+    dies = (char *)calloc(in->numLocs + 1, sizeof(char));
+    stockLive = (char *)calloc(in->numLives + 1, sizeof(char));
+    stockVals = (double *)malloc((in->numLives + 1) * sizeof(double));
+    if (locations.map == NULL || dies == NULL || stockLive == NULL ||
+            stockVals == NULL)
+        fail(ADOLC_MALLOC_FAILED);
+    for (l = 0; l <= in->numLives; ++l)
+        locations.map[l] = OPT_NO_LOC;
+    markLastUses(in, dies, stockLive);
+
+    for (op = 0; op < in->numOps && done; ++op) {
+        opLayout(in->ops[op], &layout);
+        start = in->locStart[op];
+        locs = in->locs + start;
+        if (in->ops[op] == take_stock_op) {
+            /* only the used values, handed out first such that they stay
+             * contiguous */
+            numStock = 0;
+            first = (locint)locations.numNew;
+            for (l = 0; l < locs[0]; ++l) {
+                if (!stockLive[locs[1] + l]) continue;
+                if (mapLocation(&locations, locs[1] + l) != first + numStock)
+                    done = 0;
+                stockVals[numStock++] = in->vals[in->valStart[op] + l];
+            }
+            if (numStock > 0) {
+                newLocs[0] = (locint)numStock;
+                newLocs[1] = first;
+                appendOp(out, take_stock_op, newLocs, stockVals);
+            }
+            continue;
+        }
+        if (in->ops[op] == death_not) {
+            newLocs[0] = 0;
+            newLocs[1] = (locations.numNew > 0) ?
+                         (locint)locations.numNew - 1 : 0;
+            appendOp(out, death_not, newLocs, NULL);
+            continue;
+        }
+        for (i = 0; i < layout.numLocs; ++i) {
+            newLocs[i] = locs[i];
+            if (layout.reads & OPT_LOC(i))
+                newLocs[i] = mapLocation(&locations, locs[i]);
+        }
+        /* results get their locations while the arguments still hold
+         * theirs */
+        for (i = 0; i < layout.numLocs; ++i)
+            if ((layout.writes & OPT_LOC(i)) && !(layout.reads & OPT_LOC(i)))
+                newLocs[i] = newLocation(&locations);
+        appendOp(out, in->ops[op], newLocs, in->vals + in->valStart[op]);
+        for (i = 0; i < layout.numLocs; ++i)
+            if ((layout.reads & OPT_LOC(i)) && !(layout.writes & OPT_LOC(i)) &&
+                    dies[start + i])
+                freeLocation(&locations, locs[i]);
+        for (i = 0; i < layout.numLocs; ++i)
+            if ((layout.writes & OPT_LOC(i)) && !(layout.reads & OPT_LOC(i)))
+                locations.map[locs[i]] = newLocs[i];
+        for (i = 0; i < layout.numLocs; ++i)
+            if ((layout.writes & OPT_LOC(i)) && dies[start + i])
+                freeLocation(&locations, locs[i]);
+    }
+    if (locations.numNew == 0) locations.numNew = 1;
+    out->stats[NUM_MAX_LIVES] = locations.numNew;
+    if (locations.numNew >= in->stats[NUM_MAX_LIVES]) done = 0;
+
+    free(locations.map);
+    free(locations.free);
+    free(dies);
+    free(stockLive);
+    free(stockVals);
+    if (!done) freeOptTape(out);
+    return done;
+}
+
+/****************************************************************************/
+/* Fusion of adjacent operations. A product, a multiple or a sum that is    */
+/* only used by the next operation to be added to or subtracted from        */
+/* another value is computed by one operation (eq_plus_prod, eq_min_prod,   */
+/* axpy_d_a, plus_a_a_a), which saves a dispatch in every sweep and the     */
+/* locations of the intermediate value. The values are the same as those of */
+/* the separate operations. Only pairs are fused, so a sum of more than     */
+/* three terms stays a chain of plus_a_a_a and plus_a_a operations: every   */
+/* sweep reads a fixed number of locations per operation.                   */
+/****************************************************************************/
+
+/* records the fusion of the operations "op" and "op + 1" of "in" into
+ * "out" and returns 1 if they can be fused */
+static int fuseOps(const OptTape *in, size_t op, const char *dies,
+                   OptTape *out) {
+    const locint *first, *second;
+    locint t, y, res, locs[4];
+    double coval;
+    size_t start;
+    int sign;
+
+    first = in->locs + in->locStart[op];
+    start = in->locStart[op + 1];
+    second = in->locs + start;
+    switch (in->ops[op]) {
+        case mult_a_a:
+        case plus_a_a:
+            t = first[2];
+            break;
+        case mult_d_a:
+            t = first[1];
+            break;
+        default:
+            return 0;
+    }
+
+    /* the second operation computes res = y + sign * t and t dies there */
+    switch (in->ops[op + 1]) {
+        case eq_plus_a:
+        case eq_min_a:
+            if (second[0] != t || second[1] == t || !dies[start]) return 0;
+            y = res = second[1];
+            sign = (in->ops[op + 1] == eq_plus_a) ? 1 : -1;
+            break;
+        case plus_a_a:
+            if (second[0] == t && second[1] != t && dies[start])
+                y = second[1];
+            else if (second[1] == t && second[0] != t && dies[start + 1])
+                y = second[0];
+            else
+                return 0;
+            res = second[2];
+            sign = 1;
+            break;
+        case min_a_a:
+            if (second[1] != t || second[0] == t || !dies[start + 1])
+                return 0;
+            y = second[0];
+            res = second[2];
+            sign = -1;
+            break;
+        default:
+            return 0;
+    }
+
+    switch (in->ops[op]) {
+        case mult_a_a:
+            /* eq_*_prod recomputes the old value of res in reverse */
+            if (res != y || res == first[0] || res == first[1]) return 0;
+            locs[0] = first[0];
+            locs[1] = first[1];
+            locs[2] = res;
+            appendOp(out, (sign > 0) ? eq_plus_prod : eq_min_prod, locs, NULL);
+            ++out->stats[NUM_EQ_PROD];
+            return 1;
+        case mult_d_a:
+            coval = in->vals[in->valStart[op]];
+            if (sign < 0) coval = -coval;
+            locs[0] = first[0];
+            locs[1] = y;
+            locs[2] = res;
+            appendOp(out, axpy_d_a, locs, &coval);
+            return 1;
+        default:
+            if (sign < 0) return 0;
+            locs[0] = first[0];
+            locs[1] = first[1];
+            locs[2] = y;
+            locs[3] = res;
+            appendOp(out, plus_a_a_a, locs, NULL);
+            ++out->stats[NUM_EQ_PROD];
+            return 1;
+    }
+}
+
+/* records the operations of "in" into "out" with adjacent operations fused
+ * where possible, returns the number of saved operations */
+static size_t fuseOptTape(const OptTape *in, OptTape *out) {
+    char *dies, *stockLive;
+    size_t op;
+
+    initOptTape(out, in);
+    dies = (char *)calloc(in->numLocs + 1, sizeof(char));
+    stockLive = (char *)calloc(in->numLives + 1, sizeof(char));
+    if (dies == NULL || stockLive == NULL) fail(ADOLC_MALLOC_FAILED);
+    markLastUses(in, dies, stockLive);
+    for (op = 0; op < in->numOps; ++op) {
+        if (op + 1 < in->numOps && fuseOps(in, op, dies, out)) {
+            ++op;
+            continue;
+        }
+        appendOp(out, in->ops[op], in->locs + in->locStart[op],
+                 in->vals + in->valStart[op]);
+    }
+    free(dies);
+    free(stockLive);
+    return in->numOps - out->numOps;
+}
+
+/* records the operations of "tape" as a new version of tape "tag" */
+static void writeOptTape(short tag, const OptTape *tape) {
+    OptOpLayout layout;
+    const size_t *stats = tape->stats;
+    size_t op, numVals, numTays = 0;
+    const locint *locs;
+    const double *vals;
+    locint space_left, loc;
+    int i;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    initNewTape(tag);
+    freeTapeResources(&ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] = stats[OP_BUFFER_SIZE];
+    ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] = stats[LOC_BUFFER_SIZE];
+    ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] = stats[VAL_BUFFER_SIZE];
+    ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE] = stats[TAY_BUFFER_SIZE];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NO_MIN_MAX] = stats[NO_MIN_MAX];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM] = stats[NUM_PARAM];
+    ADOLC_CURRENT_TAPE_INFOS.keepTaylors = 0;
+    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.keepTape = tape->keepTape;
+    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.skipFileCleanup =
+        tape->skipFileCleanup;
+    start_trace();
+
+    for (op = 0; op < tape->numOps; ++op) {
+        locs = tape->locs + tape->locStart[op];
+        vals = tape->vals + tape->valStart[op];
+        if (tape->ops[op] == take_stock_op) {
+            /* split as in take_stock for the new block boundaries */
+            numVals = locs[0];
+            loc = locs[1];
+            space_left = get_val_space();
+            while (space_left < numVals) {
+                put_op(take_stock_op);
+                ADOLC_PUT_LOCINT(space_left);
+                ADOLC_PUT_LOCINT(loc);
+                put_vals_writeBlock((double *)vals, space_left);
+                vals += space_left;
+                numVals -= space_left;
+                loc += space_left;
+                space_left = get_val_space();
+            }
+            if (numVals > 0) {
+                put_op(take_stock_op);
+                ADOLC_PUT_LOCINT(numVals);
+                ADOLC_PUT_LOCINT(loc);
+                put_vals_notWriteBlock((double *)vals, numVals);
+            }
+            continue;
+        }
+        opLayout(tape->ops[op], &layout);
+        put_op(tape->ops[op]);
+        for (i = 0; i < layout.numLocs; ++i) {
+            ADOLC_PUT_LOCINT(locs[i]);
+            if (layout.writes & OPT_LOC(i)) ++numTays;
+        }
+        if (tape->ops[op] == death_not) numTays += locs[1] - locs[0] + 1;
+        for (i = 0; i < layout.numVals; ++i)
+            ADOLC_PUT_VAL(vals[i]);
+    }
+
+    /* as stop_trace, the interface of the tape is unchanged */
+    put_op(end_of_tape);
+    put_params();
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_INDEPENDENTS] = stats[NUM_INDEPENDENTS];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_DEPENDENTS] = stats[NUM_DEPENDENTS];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES] = stats[NUM_MAX_LIVES];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_EQ_PROD] = stats[NUM_EQ_PROD];
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_SWITCHES] = stats[NUM_SWITCHES];
+    ADOLC_CURRENT_TAPE_INFOS.stats[TAY_STACK_SIZE] = numTays;
+    ADOLC_CURRENT_TAPE_INFOS.numInds = stats[NUM_INDEPENDENTS];
+    ADOLC_CURRENT_TAPE_INFOS.numDeps = stats[NUM_DEPENDENTS];
+    ADOLC_CURRENT_TAPE_INFOS.traceFlag = 0;
+    close_tape(tape->keepTape);
+    ADOLC_CURRENT_TAPE_INFOS.tapingComplete = 1;
+    ADOLC_CURRENT_TAPE_INFOS.workMode = ADOLC_NO_MODE;
+    releaseTape();
+}
+
+/****************************************************************************/
+/* Removes all operations from tape "tag" whose results are not needed for  */
+/* the dependents, folds operations on constants and replaces recomputed    */
+/* expressions by copies of earlier results, fuses pairs of adjacent        */
+/* operations (sums into at most three terms) and renumbers the locations   */
+/* to lower NUM_MAX_LIVES. The values of the dependents, their derivatives  */
+/* (up to rounding), the recorded comparisons and abs branches are not      */
+/* changed. Returns the number of removed operations or -1 if the tape      */
+/* could not be optimized.                                                  */
+/****************************************************************************/
+int optimize_tape(short tag) {
+    OptTape tape, folded, kept, fused, renumbered;
+    TapeInfos *tapeInfos;
+    char *keep, *keepFolded;
+    size_t numKept, numKeptFolded;
+    int removed = -1;
+
+    tapeInfos = getTapeInfos(tag);
+    if (tapeInfos->inUse != 0 && tapeInfos->tapingComplete == 0)
+        return -1;                                 /* still being recorded */
+
+    if (readOptTape(tag, &tape)) {
+        foldOptTape(&tape, &folded);
+        keep = (char *)malloc(tape.numOps + 1);
+        keepFolded = (char *)malloc(folded.numOps + 1);
+        if (keep == NULL || keepFolded == NULL) fail(ADOLC_MALLOC_FAILED);
+        numKept = markDeadOps(&tape, keep);
+        numKeptFolded = markDeadOps(&folded, keepFolded);
+        /* copies of the folded version may survive and cost more than
+         * they save */
+        if (numKeptFolded < numKept) {
+            removed = (int)(tape.numOps - numKeptFolded);
+            compactOptTape(&folded, keepFolded, &kept);
+        } else {
+            removed = (int)(tape.numOps - numKept);
+            compactOptTape(&tape, keep, &kept);
+        }
+        removed += (int)fuseOptTape(&kept, &fused);
+        if (renumberOptTape(&fused, &renumbered)) {
+            writeOptTape(tag, &renumbered);
+            freeOptTape(&renumbered);
+        } else if (removed > 0)
+            writeOptTape(tag, &fused);
+        free(keep);
+        free(keepFolded);
+        freeOptTape(&kept);
+        freeOptTape(&fused);
+        freeOptTape(&folded);
+    }
+    freeOptTape(&tape);
+    return removed;
+}
@@ -0,0 +1,450 @@
+/*----------------------------------------------------------------------------
+ ADOL-C -- Automatic Differentiation by Overloading in C++
+ File:     tape_rules.h
+ Revision: $Id$
+ Contents: first order rules of the operations of decoded tapes, shared by
+           the decoded sweeps (tape_decode_for.c, tape_decode_rev.c), the
+           batched sweeps (tape_batch.c) and the code generator
+           (tape_codegen.c)
+
+ This file is part of ADOL-C. This software is provided as open source.
+ Any use, reproduction, or distribution of the software constitutes
+ recipient's acceptance of the terms of the accompanying license file.
+
+----------------------------------------------------------------------------*/
+
+#if !defined(ADOLC_TAPE_RULES_H)
+#define ADOLC_TAPE_RULES_H 1
+
+/****************************************************************************/
+/* FOR_<op> and REV_<op> are the statements of operation <op> in a forward  */
+/* and a reverse sweep. They refer to the operands res, arg, arg1 and arg2, */
+/* the constant or parameter coval and the indices indexi and indexd of the */
+/* independent and dependent, and leave everything else to the macros of    */
+/* the sweep they are expanded in. take_stock_op is stated for the single   */
+/* location res, the sweeps apply it to each of its locations.             */
+/*                                                                          */
+/* Forward sweeps define                                                    */
+/*   TV(x), TD(x)      value and tangent (of the current direction) of x   */
+/*   XV(i), XD(i)      value and tangent of independent i                   */
+/*   YV(i), YD(i)      value and tangent of dependent i, written if         */
+/*                     HAS_YV respectively HAS_YD                           */
+/*   VALUE(s)          statement s on the values                            */
+/*   SCALAR(s)         statement s computing scalars the tangents need,    */
+/*                     empty without tangents                               */
+/*   TANGENT(s)        statement s for each direction, vectorized           */
+/*   TANGENT_SERIAL(s) as TANGENT for statements carrying values from one   */
+/*                     direction to the next                                */
+/*   TANGENT_BRANCH(c, s, t)  TANGENT_SERIAL(s) if c holds, else TANGENT(t) */
+/*   KEEPING, KEEP(x)  whether and how the old value of x is kept           */
+/*   RESTORE_THREAD    after calls into the math library                    */
+/* and the scalars j, r0 and r_0.                                           */
+/*                                                                          */
+/* Reverse sweeps define                                                    */
+/*   RV(x), RA(x)      value and adjoint (of the current direction) of x    */
+/*   AREAL             the type of the adjoints                             */
+/*   PARTIAL(s)        statement s on the values, computing the partial     */
+/*                     derivatives P0 and P1                                */
+/*   ADJOINT(s)        statement s for each direction, vectorized           */
+/*   RESTORE(x)        restores the old value of x                          */
+/*   RESTORE_LINEAR(x) same for the results of linear operations            */
+/*   RESULT(i), RESULT_NESTED(i)  adjoint of independent i, overwritten,    */
+/*                     respectively incremented in a nested context         */
+/*   LAGRANGE(d), LAGRANGE_NESTED(d), LAGRANGE_CLEAR(d)  weight of          */
+/*                     dependent d, cleared when read in a nested context   */
+/* and the scalars j and nested.                                            */
+/*                                                                          */
+/* The statements are those of the stream sweeps (uni5_for.c, fo_rev.c),    */
+/* the values are thus the same in all sweeps.                              */
+/****************************************************************************/
+
+/****************************************************************************/
+/*                                                                  FORWARD */
+
+#define FOR_death_not \
+    if (KEEPING) { \
+        for (j = arg2 + 1; j-- > arg1;) { \
+            KEEP(j) \
+        } \
+    }
+#define FOR_take_stock_op \
+    VALUE(TV(res) = coval) \
+    TANGENT(TD(res) = 0)
+#define FOR_assign_ind \
+    KEEP(res) \
+    VALUE(TV(res) = XV(indexi)) \
+    TANGENT(TD(res) = XD(indexi))
+#define FOR_assign_dep \
+    if (HAS_YV) { \
+        VALUE(YV(indexd) = TV(res)) \
+    } \
+    if (HAS_YD) { \
+        TANGENT(YD(indexd) = TD(res)) \
+    }
+#define FOR_assign_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg)) \
+    TANGENT(TD(res) = TD(arg))
+#define FOR_assign_d \
+    KEEP(res) \
+    VALUE(TV(res) = coval) \
+    TANGENT(TD(res) = 0)
+#define FOR_assign_p FOR_assign_d
+#define FOR_neg_sign_p \
+    KEEP(res) \
+    VALUE(TV(res) = -coval) \
+    TANGENT(TD(res) = 0)
+#define FOR_recipr_p \
+    KEEP(res) \
+    VALUE(TV(res) = 1.0 / coval) \
+    TANGENT(TD(res) = 0)
+#define FOR_assign_d_zero \
+    KEEP(res) \
+    VALUE(TV(res) = 0.0) \
+    TANGENT(TD(res) = 0)
+#define FOR_assign_d_one \
+    KEEP(res) \
+    VALUE(TV(res) = 1.0) \
+    TANGENT(TD(res) = 0)
+#define FOR_eq_plus_d \
+    KEEP(res) \
+    VALUE(TV(res) += coval)
+#define FOR_eq_plus_p FOR_eq_plus_d
+#define FOR_eq_plus_a \
+    KEEP(res) \
+    VALUE(TV(res) += TV(arg)) \
+    TANGENT(TD(res) += TD(arg))
+#define FOR_eq_min_d \
+    KEEP(res) \
+    VALUE(TV(res) -= coval)
+#define FOR_eq_min_p FOR_eq_min_d
+#define FOR_eq_min_a \
+    KEEP(res) \
+    VALUE(TV(res) -= TV(arg)) \
+    TANGENT(TD(res) -= TD(arg))
+#define FOR_eq_mult_d \
+    KEEP(res) \
+    VALUE(TV(res) *= coval) \
+    TANGENT(TD(res) *= coval)
+#define FOR_eq_mult_p FOR_eq_mult_d
+#define FOR_eq_mult_a \
+    KEEP(res) \
+    TANGENT(TD(res) = TV(res) * TD(arg) + TD(res) * TV(arg)) \
+    VALUE(TV(res) *= TV(arg))
+#define FOR_incr_a \
+    KEEP(res) \
+    VALUE(TV(res)++)
+#define FOR_decr_a \
+    KEEP(res) \
+    VALUE(TV(res)--)
+#define FOR_plus_a_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg1) + TV(arg2)) \
+    TANGENT(TD(res) = TD(arg1) + TD(arg2))
+#define FOR_plus_a_a_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg1) + TV(arg2) + TV(arg)) \
+    TANGENT(TD(res) = TD(arg1) + TD(arg2) + TD(arg))
+#define FOR_plus_d_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg) + coval) \
+    TANGENT(TD(res) = TD(arg))
+#define FOR_plus_a_p FOR_plus_d_a
+#define FOR_min_a_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg1) - TV(arg2)) \
+    TANGENT(TD(res) = TD(arg1) - TD(arg2))
+#define FOR_min_d_a \
+    KEEP(res) \
+    VALUE(TV(res) = coval - TV(arg)) \
+    TANGENT(TD(res) = -TD(arg))
+#define FOR_min_a_p \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg) - coval) \
+    TANGENT(TD(res) = TD(arg))
+#define FOR_mult_a_a \
+    KEEP(res) \
+    TANGENT(TD(res) = TV(arg1) * TD(arg2) + TD(arg1) * TV(arg2)) \
+    VALUE(TV(res) = TV(arg1) * TV(arg2))
+#define FOR_eq_plus_prod \
+    TANGENT(TD(res) += TV(arg1) * TD(arg2) + TD(arg1) * TV(arg2)) \
+    VALUE(TV(res) += TV(arg1) * TV(arg2))
+#define FOR_eq_min_prod \
+    TANGENT(TD(res) -= TV(arg1) * TD(arg2) + TD(arg1) * TV(arg2)) \
+    VALUE(TV(res) -= TV(arg1) * TV(arg2))
+#define FOR_mult_d_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg) * coval) \
+    TANGENT(TD(res) = TD(arg) * coval)
+#define FOR_mult_a_p FOR_mult_d_a
+#define FOR_axpy_d_a \
+    KEEP(res) \
+    VALUE(TV(res) = TV(arg1) * coval + TV(arg2)) \
+    TANGENT(TD(res) = TD(arg1) * coval + TD(arg2))
+#define FOR_div_a_a \
+    KEEP(res) \
+    SCALAR(r0 = 1.0 / TV(arg2)) \
+    VALUE(TV(res) = TV(arg1) / TV(arg2)) \
+    TANGENT(TD(res) = TD(arg1) * r0 + TV(res) * (-TD(arg2) * r0))
+#define FOR_div_d_a \
+    KEEP(res) \
+    SCALAR(r0 = 1.0 / TV(arg)) \
+    VALUE(TV(res) = coval / TV(arg)) \
+    TANGENT(TD(res) = TV(res) * (-TD(arg) * r0))
+#define FOR_div_p_a FOR_div_d_a
+#define FOR_pos_sign_a FOR_assign_a
+#define FOR_neg_sign_a \
+    KEEP(res) \
+    VALUE(TV(res) = -TV(arg)) \
+    TANGENT(TD(res) = -TD(arg))
+#define FOR_exp_op \
+    KEEP(res) \
+    VALUE(TV(res) = exp(TV(arg))) \
+    RESTORE_THREAD \
+    TANGENT(TD(res) = TV(res) * TD(arg))
+#define FOR_sin_op \
+    KEEP(arg2) \
+    KEEP(res) \
+    VALUE(TV(arg2) = cos(TV(arg1))) \
+    VALUE(TV(res) = sin(TV(arg1))) \
+    RESTORE_THREAD \
+    TANGENT(TD(arg2) = -TV(res) * TD(arg1); \
+            TD(res) = TV(arg2) * TD(arg1))
+#define FOR_cos_op \
+    KEEP(arg2) \
+    KEEP(res) \
+    VALUE(TV(arg2) = sin(TV(arg1))) \
+    VALUE(TV(res) = cos(TV(arg1))) \
+    RESTORE_THREAD \
+    TANGENT(TD(arg2) = TV(res) * TD(arg1); \
+            TD(res) = -TV(arg2) * TD(arg1))
+#define FOR_log_op \
+    KEEP(res) \
+    SCALAR(r0 = 1.0 / TV(arg)) \
+    TANGENT_SERIAL(if (TV(arg) == 0.0 && TD(arg) < 0.0) \
+                       r0 = make_nan(); \
+                   TD(res) = TD(arg) * r0) \
+    VALUE(TV(res) = log(TV(arg))) \
+    RESTORE_THREAD
+#define FOR_pow_op \
+    KEEP(res) \
+    if (arg == res) { \
+        KEEP(arg) \
+    } \
+    SCALAR(r_0 = TV(arg)) \
+    VALUE(TV(res) = pow(TV(arg), coval)) \
+    RESTORE_THREAD \
+    TANGENT_BRANCH(r_0 == 0.0, FOR_pow_op_zero, \
+                   TD(res) = TV(res) * TD(arg) * coval * (1.0 / r_0))
+/* tangent of pow_op at zero */
+#define FOR_pow_op_zero \
+    if (coval <= 0.0) \
+        TD(res) = make_nan(); \
+    else if (coval - floor(coval) != 0) { \
+        if (coval > 1) \
+            TD(res) = 0; \
+        if (coval < 1) \
+            TD(res) = make_inf(); \
+    } else if (coval == 1) \
+        TD(res) = TD(arg); \
+    else \
+        TD(res) = 0
+#define FOR_sqrt_op \
+    KEEP(res) \
+    VALUE(TV(res) = sqrt(TV(arg))) \
+    RESTORE_THREAD \
+    TANGENT_SERIAL(if (TV(arg) == 0.0) { \
+                       r0 = 0.0; \
+                       if (TD(arg) > 0.0) \
+                           r0 = make_inf(); \
+                       else if (TD(arg) < 0.0) \
+                           r0 = make_nan(); \
+                   } else \
+                       r0 = 0.5 / TV(res); \
+                   TD(res) = r0 * TD(arg))
+
+/****************************************************************************/
+/*                                                                  REVERSE */
+
+#define REV_death_not \
+    for (j = arg1; j <= arg2; j++) { \
+        ADJOINT(RA(j) = 0.0) \
+    } \
+    for (j = arg1; j <= arg2; j++) { \
+        RESTORE(j) \
+    }
+#define REV_take_stock_op \
+    ADJOINT(RA(res) = 0.0)
+#define REV_assign_ind \
+    if (nested) { \
+        ADJOINT(RESULT_NESTED(indexi) += RA(res)) \
+    } else { \
+        ADJOINT(RESULT(indexi) = RA(res)) \
+    } \
+    RESTORE_LINEAR(res)
+#define REV_assign_dep \
+    if (nested) { \
+        ADJOINT(RA(res) = LAGRANGE_NESTED(indexd); \
+                LAGRANGE_CLEAR(indexd)) \
+    } else { \
+        ADJOINT(RA(res) = LAGRANGE(indexd)) \
+    }
+#define REV_assign_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_assign_d \
+    ADJOINT(RA(res) = 0.0) \
+    RESTORE_LINEAR(res)
+#define REV_assign_p REV_assign_d
+#define REV_neg_sign_p REV_assign_d
+#define REV_recipr_p REV_assign_d
+#define REV_assign_d_zero REV_assign_d
+#define REV_assign_d_one REV_assign_d
+#define REV_eq_plus_d \
+    RESTORE_LINEAR(res)
+#define REV_eq_plus_p REV_eq_plus_d
+#define REV_eq_plus_a \
+    ADJOINT(RA(arg) += RA(res)) \
+    RESTORE_LINEAR(res)
+#define REV_eq_min_d REV_eq_plus_d
+#define REV_eq_min_p REV_eq_plus_d
+#define REV_eq_min_a \
+    ADJOINT(RA(arg) -= RA(res)) \
+    RESTORE_LINEAR(res)
+#define REV_eq_mult_d \
+    ADJOINT(RA(res) *= coval) \
+    RESTORE_LINEAR(res)
+#define REV_eq_mult_p REV_eq_mult_d
+#define REV_eq_mult_a \
+    RESTORE(res) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = (aTmp == 0) ? 0 : (aTmp * RV(arg)); \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * RV(res)))
+#define REV_incr_a REV_eq_plus_d
+#define REV_decr_a REV_eq_plus_d
+#define REV_plus_a_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += aTmp; \
+            RA(arg2) += aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_plus_a_a_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += aTmp; \
+            RA(arg2) += aTmp; \
+            RA(arg) += aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_plus_d_a REV_assign_a
+#define REV_plus_a_p REV_assign_a
+#define REV_min_a_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += aTmp; \
+            RA(arg2) -= aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_min_d_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) -= aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_min_a_p REV_assign_a
+#define REV_mult_a_a \
+    RESTORE(res) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg2) += (aTmp == 0) ? 0 : (aTmp * RV(arg1)); \
+            RA(arg1) += (aTmp == 0) ? 0 : (aTmp * RV(arg2)))
+#define REV_eq_plus_prod \
+    PARTIAL(RV(res) -= RV(arg1) * RV(arg2)) \
+    ADJOINT(RA(arg2) += RA(res) * RV(arg1); \
+            RA(arg1) += RA(res) * RV(arg2))
+#define REV_eq_min_prod \
+    PARTIAL(RV(res) += RV(arg1) * RV(arg2)) \
+    ADJOINT(RA(arg2) -= RA(res) * RV(arg1); \
+            RA(arg1) -= RA(res) * RV(arg2))
+#define REV_mult_d_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (coval * aTmp)) \
+    RESTORE_LINEAR(res)
+#define REV_mult_a_p REV_mult_d_a
+#define REV_axpy_d_a \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += (aTmp == 0) ? 0 : (coval * aTmp); \
+            RA(arg2) += aTmp) \
+    RESTORE_LINEAR(res)
+#define REV_div_a_a \
+    PARTIAL(P1 = -RV(res)) \
+    RESTORE(res) \
+    PARTIAL(P0 = 1.0 / RV(arg2); \
+            P1 *= P0) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += (aTmp == 0) ? 0 : (aTmp * P0); \
+            RA(arg2) += (aTmp == 0) ? 0 : (aTmp * P1))
+#define REV_div_d_a \
+    PARTIAL(P0 = -RV(res)) \
+    if (arg == res) { \
+        RESTORE(arg) \
+    } \
+    PARTIAL(P0 /= RV(arg)) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * P0)) \
+    if (arg != res) { \
+        RESTORE(res) \
+    }
+#define REV_div_p_a REV_div_d_a
+#define REV_pos_sign_a REV_assign_a
+#define REV_neg_sign_a REV_min_d_a
+#define REV_exp_op \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * RV(res))) \
+    RESTORE(res)
+#define REV_sin_op \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) += (aTmp == 0) ? 0 : (aTmp * RV(arg2))) \
+    RESTORE(res) \
+    RESTORE(arg2)
+#define REV_cos_op \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg1) -= (aTmp == 0) ? 0 : (aTmp * RV(arg2))) \
+    RESTORE(res) \
+    RESTORE(arg2)
+#define REV_log_op \
+    RESTORE(res) \
+    PARTIAL(P0 = 1.0 / RV(arg)) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * P0))
+#define REV_pow_op \
+    PARTIAL(P0 = RV(res)) \
+    if (arg == res) { \
+        RESTORE(arg) \
+    } \
+    PARTIAL(if (RV(arg) == 0.0) \
+                P0 = 0.0; \
+            else \
+                P0 *= coval / RV(arg)) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * P0)) \
+    RESTORE(res)
+#define REV_sqrt_op \
+    PARTIAL(if (RV(res) == 0.0) \
+                P0 = 0.0; \
+            else \
+                P0 = 0.5 / RV(res)) \
+    ADJOINT(AREAL aTmp = RA(res); \
+            RA(res) = 0.0; \
+            RA(arg) += (aTmp == 0) ? 0 : (aTmp * P0)) \
+    RESTORE(res)
+
+#endif
@@ -632,6 +632,26 @@ void tape_doc(short tnum,         /* tape id */
                 filewrite(operation,"plus a a",3,loc_a,val_a,0,cst_d);
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case plus_a_a_a:         /* Add three adoubles, fused      plus_a_a_a */
+                arg1  = get_locint_f();
+                arg2  = get_locint_f();
+                arg   = get_locint_f();
+                res   = get_locint_f();
+                loc_a[0]=arg1;
+                loc_a[1]=arg2;
+                loc_a[2]=arg;
+                loc_a[3]=res;
+#ifdef ADOLC_TAPE_DOC_VALUES
+                val_a[0]=dp_T0[arg1];
+                val_a[1]=dp_T0[arg2];
+                val_a[2]=dp_T0[arg];
+                dp_T0[res]=dp_T0[arg1]+dp_T0[arg2]+dp_T0[arg];
+                val_a[3]=dp_T0[res];
+#endif
+                filewrite(operation,"plus a a a",4,loc_a,val_a,0,cst_d);
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case plus_d_a:             /* Add an adouble and a double    plus_d_a */
                 /* (+) */
@@ -718,6 +738,26 @@ void tape_doc(short tnum,         /* tape id */
                 filewrite(operation,"mult d a",2,loc_a,val_a,1,cst_d);
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case axpy_d_a:     /* Add a multiple of an adouble to     axpy_d_a */
+                /* an adouble, fused (* +) */
+                arg1  = get_locint_f();
+                arg2  = get_locint_f();
+                res   = get_locint_f();
+                coval = get_val_f();
+                loc_a[0] = arg1;
+                loc_a[1] = arg2;
+                loc_a[2] = res;
+                cst_d[0] = coval;
+#ifdef ADOLC_TAPE_DOC_VALUES
+                val_a[0] = dp_T0[arg1];
+                val_a[1] = dp_T0[arg2];
+                dp_T0[res] = dp_T0[arg1] * coval + dp_T0[arg2];
+                val_a[2] = dp_T0[res];
+#endif
+                filewrite(operation,"axpy d a",3,loc_a,val_a,1,cst_d);
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case div_a_a:           /* Divide an adouble by an adouble    div_a_a */
                 /* (/) */
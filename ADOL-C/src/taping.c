@@ -15,6 +15,10 @@
  
 ----------------------------------------------------------------------------*/
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE 1                                       /* for O_DIRECT */
+#endif
+
 #include <math.h>
 #include <string.h>
 
@@ -42,6 +46,23 @@
 #define S_ISDIR(m) (((m) & S_IFMT) == S_IFDIR)
 #endif
 
+#if defined(HAVE_UNISTD_H) && !defined(_WINDOWS)
+#include <unistd.h>
+#if defined(_POSIX_MAPPED_FILES) && _POSIX_MAPPED_FILES > 0
+#include <fcntl.h>
+#include <sys/mman.h>
+#define ADOLC_HAVE_MMAP 1
+#endif
+#if defined(_XOPEN_VERSION) || _POSIX_VERSION >= 200809L
+#include <fcntl.h>
+#define ADOLC_HAVE_PREAD 1
+#endif
+#endif
+
+#if defined(ADOLC_HAVE_PTHREAD)
+#include <pthread.h>
+#endif
+
 /*--------------------------------------------------------------------------*/
 /* Tape identification (ADOLC & version check) */
 ADOLC_ID adolc_id;
@@ -354,11 +375,11 @@ void printError() {
 }
 
 /* the base names of every tape type */
-char *tapeBaseNames[4]={0,0,0,0};
+char *tapeBaseNames[5]={0,0,0,0,0};
 
 void clearTapeBaseNames() {
     int i;
-    for(i=0;i<4;i++) {
+    for(i=0;i<5;i++) {
 	if (tapeBaseNames[i]) {
 	    free(tapeBaseNames[i]);
 	    tapeBaseNames[i]=0;
@@ -373,9 +394,10 @@ void clearTapeBaseNames() {
 /****************************************************************************/
 char *createFileName(short tapeID, int tapeType) {
     char *numberString, *fileName, *extension = ".tap", *currPos;
-#if defined(_OPENMP)
+#if defined(_OPENMP) || defined(ADOLC_THREADLOCAL)
     char *threadName = "thread-", *threadNumberString = NULL;
     int threadNumber, threadNumberStringLength = 0, threadNameLength = 0;
+    int threadPrefix;
 #endif /* _OPENMP */
     int tapeBaseNameLength, numberStringLength, fileNameLength;
     ADOLC_OPENMP_THREAD_NUMBER;
@@ -392,10 +414,17 @@ char *createFileName(short tapeID, int tapeType) {
     if (numberString == NULL) fail(ADOLC_MALLOC_FAILED);
     sprintf(numberString, "%d", tapeID);
 #if defined(_OPENMP)
+    threadPrefix = ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 1;
+    threadNumber = threadPrefix ? omp_get_thread_num() : 0;
+#elif defined(ADOLC_THREADLOCAL)
+    /* files of the thread that loaded the library keep their names */
+    threadPrefix = ADOLC_threadIndex != 0;
+    threadNumber = ADOLC_threadIndex;
+#endif
+#if defined(_OPENMP) || defined(ADOLC_THREADLOCAL)
     /* determine length of the thread number string */
-    if (ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 1) {
+    if (threadPrefix) {
         threadNameLength = strlen(threadName);
-        threadNumber = omp_get_thread_num();
         if (threadNumber != 0)
             threadNumberStringLength = (int)log10((double)threadNumber);
         else threadNumberStringLength = 0;
@@ -412,8 +441,8 @@ char *createFileName(short tapeID, int tapeType) {
 
     /* malloc and create */
     fileNameLength = tapeBaseNameLength + numberStringLength + 5;
-#if defined(_OPENMP)
-    if (ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 1)
+#if defined(_OPENMP) || defined(ADOLC_THREADLOCAL)
+    if (threadPrefix)
         fileNameLength += threadNameLength + threadNumberStringLength;
 #endif /* _OPENMP */
     fileName = (char *)malloc(sizeof(char) * fileNameLength);
@@ -421,8 +450,8 @@ char *createFileName(short tapeID, int tapeType) {
     currPos = fileName;
     strncpy(currPos, tapeBaseNames[tapeType], tapeBaseNameLength);
     currPos += tapeBaseNameLength;
-#if defined(_OPENMP)
-    if (ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 1) {
+#if defined(_OPENMP) || defined(ADOLC_THREADLOCAL)
+    if (threadPrefix) {
         strncpy(currPos, threadName, threadNameLength);
         currPos += threadNameLength;
         strncpy(currPos, threadNumberString, threadNumberStringLength);
@@ -436,8 +465,8 @@ char *createFileName(short tapeID, int tapeType) {
     *currPos = 0;
 
     free(numberString);
-#if defined(_OPENMP)
-    if (ADOLC_GLOBAL_TAPE_VARS.inParallelRegion == 1)
+#if defined(_OPENMP) || defined(ADOLC_THREADLOCAL)
+    if (threadPrefix)
         free(threadNumberString);
 #endif /* _OPENMP */
 
@@ -471,6 +500,8 @@ void readConfigFile() {
 	TAPE_DIR PATHSEPARATOR ADOLC_OPERATIONS_NAME);
     tapeBaseNames[3] = duplicatestr(
 	TAPE_DIR PATHSEPARATOR ADOLC_TAYLORS_NAME);
+    tapeBaseNames[4] = duplicatestr(
+	TAPE_DIR PATHSEPARATOR ADOLC_CONTAINER_NAME);
 
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
@@ -480,6 +511,16 @@ void readConfigFile() {
     ADOLC_GLOBAL_TAPE_VARS.valueBufferSize = VBUFSIZE;
     ADOLC_GLOBAL_TAPE_VARS.taylorBufferSize = TBUFSIZE;
     ADOLC_GLOBAL_TAPE_VARS.maxNumberTaylorBuffers = TBUFNUM;
+    ADOLC_GLOBAL_TAPE_VARS.mmapTapes = 0;
+    ADOLC_GLOBAL_TAPE_VARS.locFileFormat = ADOLC_LOC_PLAIN;
+    ADOLC_GLOBAL_TAPE_VARS.tapeContainer = 0;
+    ADOLC_GLOBAL_TAPE_VARS.numIOBuffers = IOBUFNUM;
+    ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize = TAPECACHESIZE;
+    ADOLC_GLOBAL_TAPE_VARS.tayCodec = TAYLORCODEC;
+    ADOLC_GLOBAL_TAPE_VARS.selectiveTaylors = 0;
+    ADOLC_GLOBAL_TAPE_VARS.tapeIOMode = TAPEIOMODE;
+    ADOLC_GLOBAL_TAPE_VARS.optimizeTapes = 0;
+    ADOLC_GLOBAL_TAPE_VARS.decodeTapes = DECODETAPES;
     if ((configFile = fopen(".adolcrc", "r")) != NULL) {
         fprintf(DIAG_OUT, "\nFile .adolcrc found! => Try to parse it!\n");
         fprintf(DIAG_OUT, "****************************************\n");
@@ -527,14 +568,14 @@ void readConfigFile() {
 			path = pos3 + 1;
 			err = stat(path,&st);
 			if (err == 0 && S_ISDIR(st.st_mode)) {
-			    int pathlen, pathseplen, namelen[4];
+			    int pathlen, pathseplen, namelen[5];
 			    int i;
 			    pathlen=strlen(path);
 			    pathseplen=strlen(PATHSEPARATOR);
-			    for(i = 0; i < 4; i++)
+			    for(i = 0; i < 5; i++)
 				namelen[i] = strlen(tapeBaseNames[i]);
 			    clearTapeBaseNames();
-			    for(i = 0; i < 4; i++) {
+			    for(i = 0; i < 5; i++) {
 				char *currpos;
 				int fnamelen;
 				tapeBaseNames[i] = (char*)calloc(namelen[i] - defdirsize + pathlen + pathseplen + 1, sizeof(char));
@@ -560,6 +601,10 @@ void readConfigFile() {
 				    fnamelen = strlen(ADOLC_TAYLORS_NAME);
 				    strncpy(currpos,ADOLC_TAYLORS_NAME,fnamelen);
 				    break;
+				case 4:
+				    fnamelen = strlen(ADOLC_CONTAINER_NAME);
+				    memcpy(currpos,ADOLC_CONTAINER_NAME,fnamelen);
+				    break;
 				}
 				currpos += fnamelen;
 				*currpos = '\0';
@@ -599,6 +644,68 @@ void readConfigFile() {
                         fprintf(DIAG_OUT, "Found initial live variable store size : %u\n",
                                 (locint)number);
                         checkInitialStoreSize(&ADOLC_GLOBAL_TAPE_VARS);
+                    } else if (strcmp(pos1 + 1, "IOBUFNUM") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.numIOBuffers = (int)number;
+                        fprintf(DIAG_OUT, "Found number of tape buffers for "
+                                "asynchronous writing: %d\n", (int)number);
+#if !defined(ADOLC_HAVE_PTHREAD)
+                        if (number > 1)
+                            fprintf(DIAG_OUT, "ADOL-C warning: Asynchronous "
+                                    "tape writing not supported on this "
+                                    "platform!\n");
+#endif
+                    } else if (strcmp(pos1 + 1, "LOCFILEFORMAT") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.locFileFormat =
+                            (number > 0) ? ADOLC_LOC_DELTA : ADOLC_LOC_PLAIN;
+                        fprintf(DIAG_OUT, "Found locations file format: %d\n",
+                                ADOLC_GLOBAL_TAPE_VARS.locFileFormat);
+                    } else if (strcmp(pos1 + 1, "TAPECONTAINER") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.tapeContainer = (number != 0);
+                        fprintf(DIAG_OUT, "Found single file tape container: "
+                                "%d\n", (int)(number != 0));
+                    } else if (strcmp(pos1 + 1, "TAPECACHESIZE") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize = (size_t)number;
+                        fprintf(DIAG_OUT, "Found memory for in-core tapes: "
+                                "%zu\n", (size_t)number);
+                    } else if (strcmp(pos1 + 1, "TAYLORCODEC") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.tayCodec =
+                            (number > ADOLC_TAY_FLOAT) ? ADOLC_TAY_FLOAT :
+                            (char)number;
+                        fprintf(DIAG_OUT, "Found taylor stack encoding: %d\n",
+                                (int)ADOLC_GLOBAL_TAPE_VARS.tayCodec);
+                    } else if (strcmp(pos1 + 1, "SELECTIVETAYLORS") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.selectiveTaylors = (number != 0);
+                        fprintf(DIAG_OUT, "Found selective taylor recording: "
+                                "%d\n", (int)(number != 0));
+                    } else if (strcmp(pos1 + 1, "TAPEIOMODE") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.tapeIOMode =
+                            (number > ADOLC_IO_DIRECT) ? ADOLC_IO_DIRECT :
+                            (char)number;
+                        fprintf(DIAG_OUT, "Found tape file access mode: %d\n",
+                                (int)ADOLC_GLOBAL_TAPE_VARS.tapeIOMode);
+#if !defined(ADOLC_HAVE_PREAD)
+                        if (number != 0)
+                            fprintf(DIAG_OUT, "ADOL-C warning: Unbuffered "
+                                    "tape access not supported on this "
+                                    "platform!\n");
+#endif
+                    } else if (strcmp(pos1 + 1, "OPTIMIZETAPES") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.optimizeTapes = (number != 0);
+                        fprintf(DIAG_OUT, "Found tape optimization after "
+                                "taping: %d\n", (int)(number != 0));
+                    } else if (strcmp(pos1 + 1, "DECODETAPES") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.decodeTapes = (number != 0);
+                        fprintf(DIAG_OUT, "Found decoded sweeps over in-core "
+                                "tapes: %d\n", (int)(number != 0));
+                    } else if (strcmp(pos1 + 1, "MMAPTAPE") == 0) {
+                        ADOLC_GLOBAL_TAPE_VARS.mmapTapes = (number != 0);
+                        fprintf(DIAG_OUT, "Found memory mapped tape reading: "
+                                "%d\n", (int)(number != 0));
+#if !defined(ADOLC_HAVE_MMAP)
+                        if (number != 0)
+                            fprintf(DIAG_OUT, "ADOL-C warning: Memory mapped "
+                                    "files not supported on this platform!\n");
+#endif
                     } else {
                         fprintf(DIAG_OUT, "ADOL-C warning: Unable to parse "
                                 "parameter name in .adolcrc!\n");
@@ -612,13 +719,750 @@ void readConfigFile() {
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
 }
 
+/****************************************************************************/
+/****************************************************************************/
+/* TAPE FILE ACCESS                                                         */
+/****************************************************************************/
+/****************************************************************************/
+
+/* With TAPEIOMODE 1 or 2 (.adolcrc) the tape files are not buffered by     */
+/* stdio. Blocks are transferred with pread/pwrite from page aligned tape   */
+/* buffers and their pages are dropped from the page cache afterwards, so   */
+/* that streaming large tapes does not displace the data of the program.    */
+/* Mode 2 bypasses the cache with O_DIRECT for all blocks whose address,    */
+/* size and file offset are multiples of ADOLC_IO_ALIGNMENT. Other blocks   */
+/* (file headers, encoded locations and taylors, container blocks) are      */
+/* transferred as in mode 1.                                                */
+
+/* returns the tape file access mode (TapeIOModes) */
+static int tapeIOMode() {
+#if defined(ADOLC_HAVE_PREAD)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    return ADOLC_GLOBAL_TAPE_VARS.tapeIOMode;
+#else
+    return ADOLC_IO_STDIO;
+#endif
+}
+
+/* opens a tape file like fopen, without stdio buffer for TAPEIOMODE > 0 */
+static FILE *openTapeStream(const char *fileName, const char *mode) {
+    FILE *file = fopen(fileName, mode);
+
+    if (file != NULL && tapeIOMode() != ADOLC_IO_STDIO)
+        setvbuf(file, NULL, _IONBF, 0);
+    return file;
+}
+
+/* allocates a tape buffer, page aligned for TAPEIOMODE > 0, for free() */
+static void *allocTapeBuffer(size_t size) {
+#if defined(ADOLC_HAVE_PREAD)
+    void *buffer;
+
+    if (tapeIOMode() != ADOLC_IO_STDIO)
+        return posix_memalign(&buffer, ADOLC_IO_ALIGNMENT, size) == 0 ?
+            buffer : NULL;
+#endif
+    return malloc(size);
+}
+
+#if defined(ADOLC_HAVE_PREAD)
+#if defined(ADOLC_HAVE_PTHREAD)
+/* serializes transfers that change the O_DIRECT flag of a shared file */
+static pthread_mutex_t directMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+/* pread or pwrite of "size" bytes at "offset", returns 1 on success */
+static int transferFileData(int fd, void *data, size_t size, size_t offset,
+                            int write) {
+    ssize_t done;
+
+    while (size > 0) {
+        if (write)
+            done = pwrite(fd, data, MIN_ADOLC(size, ADOLC_IO_CHUNK_SIZE),
+                          offset);
+        else
+            done = pread(fd, data, MIN_ADOLC(size, ADOLC_IO_CHUNK_SIZE),
+                         offset);
+        if (done <= 0) return 0;
+        data = (char *)data + done;
+        size -= done;
+        offset += done;
+    }
+    return 1;
+}
+
+/****************************************************************************/
+/* Reads (write == 0) or writes "size" bytes at "offset" of the file "fd"   */
+/* in the access mode "mode" (TapeIOModes), returns 1 on success.           */
+/****************************************************************************/
+static int transferTapeData(int mode, int fd, void *data, size_t size,
+                            size_t offset, int write) {
+    int ok = 0;
+#if defined(O_DIRECT)
+    int flags;
+#endif
+
+    if (mode == ADOLC_IO_STDIO)
+        return transferFileData(fd, data, size, offset, write);
+#if defined(ADOLC_HAVE_PTHREAD)
+    if (mode == ADOLC_IO_DIRECT) pthread_mutex_lock(&directMutex);
+#endif
+#if defined(O_DIRECT)
+    if (mode == ADOLC_IO_DIRECT && size > 0 &&
+            (size_t)data % ADOLC_IO_ALIGNMENT == 0 &&
+            size % ADOLC_IO_ALIGNMENT == 0 &&
+            offset % ADOLC_IO_ALIGNMENT == 0 &&
+            (flags = fcntl(fd, F_GETFL)) != -1 &&
+            fcntl(fd, F_SETFL, flags | O_DIRECT) == 0) {
+        /* file systems without O_DIRECT fail, retried below */
+        ok = transferFileData(fd, data, size, offset, write);
+        fcntl(fd, F_SETFL, flags);
+    }
+#endif
+    if (!ok && (ok = transferFileData(fd, data, size, offset, write))) {
+#if defined(POSIX_FADV_DONTNEED)
+        /* dirty pages are not dropped */
+        if (write) fdatasync(fd);
+        posix_fadvise(fd, offset, size, POSIX_FADV_DONTNEED);
+#endif
+    }
+#if defined(ADOLC_HAVE_PTHREAD)
+    if (mode == ADOLC_IO_DIRECT) pthread_mutex_unlock(&directMutex);
+#endif
+    return ok;
+}
+#endif
+
+/****************************************************************************/
+/* Replacements of fread and fwrite for tape streams. For TAPEIOMODE > 0    */
+/* the data is transferred at the position of the stream, which is moved    */
+/* behind it.                                                               */
+/****************************************************************************/
+static size_t readTapeData(void *data, size_t size, size_t n, FILE *file) {
+#if defined(ADOLC_HAVE_PREAD)
+    int mode = tapeIOMode();
+    off_t pos;
+
+    if (mode != ADOLC_IO_STDIO)
+        return (fflush(file) == 0 && (pos = ftello(file)) != -1 &&
+                transferTapeData(mode, fileno(file), data, size * n, pos, 0) &&
+                fseeko(file, pos + size * n, SEEK_SET) == 0) ? n : 0;
+#endif
+    return fread(data, size, n, file);
+}
+
+/* as writeTapeData in the access mode "mode", for the I/O thread, which
+ * has no ADOL-C environment of its own */
+static size_t writeTapeDataIn(int mode, const void *data, size_t size,
+                              size_t n, FILE *file) {
+#if defined(ADOLC_HAVE_PREAD)
+    off_t pos;
+
+    if (mode != ADOLC_IO_STDIO)
+        return (fflush(file) == 0 && (pos = ftello(file)) != -1 &&
+                transferTapeData(mode, fileno(file), (void *)data, size * n,
+                                 pos, 1) &&
+                fseeko(file, pos + size * n, SEEK_SET) == 0) ? n : 0;
+#endif
+    return fwrite(data, size, n, file);
+}
+
+static size_t writeTapeData(const void *data, size_t size, size_t n,
+                            FILE *file) {
+    return writeTapeDataIn(tapeIOMode(), data, size, n, file);
+}
+
+/****************************************************************************/
+/* Reads "size" bytes at "offset" of "file", returns 1 on success. With     */
+/* pread the stdio position of the file is neither used nor changed, such   */
+/* that the I/O thread and the streams of a container tape can share it.    */
+/* Pending stdio output (taylor stack) is flushed to the descriptor first.  */
+/* "mode" is the access mode (TapeIOModes) of the reading thread.           */
+/****************************************************************************/
+static int readFileAt(int mode, FILE *file, void *data, size_t size,
+                      size_t offset) {
+#if defined(ADOLC_HAVE_PREAD)
+    if (fflush(file) != 0) return 0;
+    return transferTapeData(mode, fileno(file), data, size, offset, 0);
+#else
+    size_t i, chunks = size / ADOLC_IO_CHUNK_SIZE;
+    size_t remain = size % ADOLC_IO_CHUNK_SIZE;
+
+    if (fseek(file, offset, SEEK_SET) != 0) return 0;
+    for (i = 0; i < chunks; ++i)
+        if (fread((char *)data + i * ADOLC_IO_CHUNK_SIZE,
+                  ADOLC_IO_CHUNK_SIZE, 1, file) != 1)
+            return 0;
+    if (remain != 0 &&
+            fread((char *)data + chunks * ADOLC_IO_CHUNK_SIZE, remain, 1,
+                  file) != 1)
+        return 0;
+    return 1;
+#endif
+}
+
+/****************************************************************************/
+/****************************************************************************/
+/* ASYNCHRONOUS TAPE I/O                                                    */
+/****************************************************************************/
+/****************************************************************************/
+
+/* With IOBUFNUM > 1 (.adolcrc) filled tape buffers are not written by the  */
+/* taping thread itself. put_*_block hands the buffer over to a background  */
+/* I/O thread and continues with one of up to IOBUFNUM-1 further buffers    */
+/* of the same size. Taping thus only waits if all of them are in flight.   */
+/* Buffers are plain malloc'ed blocks, so whichever of them is currently    */
+/* attached to the tape can be released with free() as before. All writes  */
+/* are done in order by a single thread. Each stream is flushed before its  */
+/* file is read, repositioned or closed.                                    */
+/* In the same way sweeps over disk based tapes let the I/O thread read the */
+/* block needed next (the following one in forward, the preceding one in   */
+/* reverse sweeps) while the current block is interpreted. get_*_block_*   */
+/* then only swap the buffers.                                              */
+typedef struct TapeWriterStream {
+    void **freeBuffers;        /* buffers returned by the writer thread */
+    int numFree;
+    int numAllocated;       /* including the one attached to the tape */
+    int maxBuffers;
+    int pending;                               /* blocks not yet written */
+    int error;                          /* set by the writer on failure */
+} TapeWriterStream;
+
+typedef struct TapeReadAhead {
+    void *buffer;                       /* the block being read in advance */
+    int issued;                        /* a read has been queued */
+    int pending;                                  /* ... and is not done */
+    int error;                        /* set by the I/O thread on failure */
+} TapeReadAhead;
+
+#if defined(ADOLC_HAVE_PTHREAD)
+typedef struct TapeIOJob {
+    FILE *file;
+    void *data;
+    size_t size;                                              /* in bytes */
+    size_t offset;                          /* file position for reading */
+    int ioMode;                /* TAPEIOMODE of the thread queuing the job */
+    TapeWriterStream *stream;                       /* set for writing */
+    TapeReadAhead *reader;                          /* set for reading */
+    struct TapeIOJob *next;
+} TapeIOJob;
+
+static pthread_mutex_t ioMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ioWork = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t ioDone = PTHREAD_COND_INITIALIZER;
+static pthread_once_t ioOnce = PTHREAD_ONCE_INIT;
+static TapeIOJob *ioHead = NULL, *ioTail = NULL;
+static int ioThreadRunning = 0;       /* set once the I/O thread started */
+
+static void *tapeIOMain(void *arg) {
+    TapeIOJob *job;
+    size_t i, chunks, remain;
+    int ok;
+
+    pthread_mutex_lock(&ioMutex);
+    for (;;) {
+        while (ioHead == NULL)
+            pthread_cond_wait(&ioWork, &ioMutex);
+        job = ioHead;
+        ioHead = job->next;
+        if (ioHead == NULL) ioTail = NULL;
+        pthread_mutex_unlock(&ioMutex);
+
+        ok = 1;
+        chunks = job->size / ADOLC_IO_CHUNK_SIZE;
+        remain = job->size % ADOLC_IO_CHUNK_SIZE;
+        if (job->reader != NULL) {
+            ok = readFileAt(job->ioMode, job->file, job->data, job->size,
+                            job->offset);
+        } else {
+            for (i = 0; i < chunks && ok; ++i)
+                ok = writeTapeDataIn(job->ioMode, (char *)job->data +
+                            i * ADOLC_IO_CHUNK_SIZE, ADOLC_IO_CHUNK_SIZE, 1,
+                            job->file) == 1;
+            if (remain != 0 && ok)
+                ok = writeTapeDataIn(job->ioMode, (char *)job->data +
+                            chunks * ADOLC_IO_CHUNK_SIZE, remain, 1,
+                            job->file) == 1;
+        }
+
+        pthread_mutex_lock(&ioMutex);
+        if (job->reader != NULL) {
+            if (!ok) job->reader->error = 1;
+            job->reader->pending = 0;
+        } else {
+            if (!ok) job->stream->error = 1;
+            job->stream->freeBuffers[job->stream->numFree++] = job->data;
+            --job->stream->pending;
+        }
+        pthread_cond_broadcast(&ioDone);
+        free(job);
+    }
+    return arg;
+}
+
+static void startTapeIOThread() {
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, tapeIOMain, NULL) == 0) {
+        pthread_detach(thread);
+        ioThreadRunning = 1;
+    } else
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to start the tape writer "
+                "thread, tapes are written synchronously!\n");
+}
+#endif
+
+/* returns 1 if the next block of the given stream will be written in the
+ * background, starting the I/O thread on first use; without it the tapes
+ * are written synchronously */
+static int asyncTapeIO() {
+#if defined(ADOLC_HAVE_PTHREAD)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (ADOLC_GLOBAL_TAPE_VARS.numIOBuffers <= 1)
+        return 0;
+    pthread_once(&ioOnce, startTapeIOThread);
+    return ioThreadRunning;
+#else
+    return 0;
+#endif
+}
+
+/****************************************************************************/
+/* Hands "size" bytes of "buffer" over to the writer thread and returns a   */
+/* free buffer of "capacity" bytes to continue taping with.                 */
+/****************************************************************************/
+static void *queueTapeBlock(TapeWriterStream **streamPtr, FILE *file,
+                            void *buffer, size_t size, size_t capacity) {
+    void *next = NULL;
+#if defined(ADOLC_HAVE_PTHREAD)
+    TapeWriterStream *stream = *streamPtr;
+    TapeIOJob *job;
+    int error;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    pthread_once(&ioOnce, startTapeIOThread);
+    if (stream == NULL) {
+        stream = (TapeWriterStream *)calloc(1, sizeof(TapeWriterStream));
+        if (stream == NULL) fail(ADOLC_MALLOC_FAILED);
+        stream->maxBuffers = ADOLC_GLOBAL_TAPE_VARS.numIOBuffers;
+        stream->freeBuffers = (void **)malloc(stream->maxBuffers *
+                                              sizeof(void *));
+        if (stream->freeBuffers == NULL) fail(ADOLC_MALLOC_FAILED);
+        stream->numAllocated = 1;
+        *streamPtr = stream;
+    }
+    job = (TapeIOJob *)malloc(sizeof(TapeIOJob));
+    if (job == NULL) fail(ADOLC_MALLOC_FAILED);
+    job->file = file;
+    job->data = buffer;
+    job->size = size;
+    job->offset = 0;
+    job->ioMode = tapeIOMode();
+    job->stream = stream;
+    job->reader = NULL;
+    job->next = NULL;
+
+    pthread_mutex_lock(&ioMutex);
+    if (ioTail != NULL) ioTail->next = job;
+    else ioHead = job;
+    ioTail = job;
+    ++stream->pending;
+    pthread_cond_signal(&ioWork);
+    while (stream->numFree == 0 &&
+            stream->numAllocated >= stream->maxBuffers)
+        pthread_cond_wait(&ioDone, &ioMutex);
+    if (stream->numFree > 0)
+        next = stream->freeBuffers[--stream->numFree];
+    else
+        ++stream->numAllocated;
+    error = stream->error;
+    pthread_mutex_unlock(&ioMutex);
+
+    if (error != 0) fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    if (next == NULL) {
+        next = allocTapeBuffer(capacity);
+        if (next == NULL) fail(ADOLC_TAPING_BUFFER_ALLOCATION_FAILED);
+    }
+#endif
+    return next;
+}
+
+/****************************************************************************/
+/* Waits until all blocks of a stream have been written and releases the    */
+/* spare buffers of the stream. Returns 0 if all writes succeeded.          */
+/****************************************************************************/
+static int flushTapeWriter(TapeWriterStream **streamPtr) {
+    int error = 0;
+#if defined(ADOLC_HAVE_PTHREAD)
+    TapeWriterStream *stream = *streamPtr;
+    int i;
+
+    if (stream == NULL) return 0;
+    pthread_mutex_lock(&ioMutex);
+    while (stream->pending > 0)
+        pthread_cond_wait(&ioDone, &ioMutex);
+    pthread_mutex_unlock(&ioMutex);
+    error = stream->error;
+    for (i = 0; i < stream->numFree; ++i)
+        free(stream->freeBuffers[i]);
+    free(stream->freeBuffers);
+    free(stream);
+    *streamPtr = NULL;
+#endif
+    return error;
+}
+
+/****************************************************************************/
+/* Lets the I/O thread read "size" bytes at "offset" of "file" into the     */
+/* read-ahead buffer of a stream, which is allocated with "capacity" bytes. */
+/****************************************************************************/
+static void prefetchTapeBlock(TapeReadAhead **readerPtr, FILE *file,
+                              size_t offset, size_t size, size_t capacity) {
+#if defined(ADOLC_HAVE_PTHREAD)
+    TapeReadAhead *reader = *readerPtr;
+    TapeIOJob *job;
+
+    pthread_once(&ioOnce, startTapeIOThread);
+    if (reader == NULL) {
+        reader = (TapeReadAhead *)calloc(1, sizeof(TapeReadAhead));
+        if (reader == NULL) fail(ADOLC_MALLOC_FAILED);
+        reader->buffer = allocTapeBuffer(capacity);
+        if (reader->buffer == NULL) fail(ADOLC_MALLOC_FAILED);
+        *readerPtr = reader;
+    }
+    job = (TapeIOJob *)malloc(sizeof(TapeIOJob));
+    if (job == NULL) fail(ADOLC_MALLOC_FAILED);
+    job->file = file;
+    job->data = reader->buffer;
+    job->size = size;
+    job->offset = offset;
+    job->ioMode = tapeIOMode();
+    job->stream = NULL;
+    job->reader = reader;
+    job->next = NULL;
+
+    pthread_mutex_lock(&ioMutex);
+    if (ioTail != NULL) ioTail->next = job;
+    else ioHead = job;
+    ioTail = job;
+    reader->issued = 1;
+    reader->pending = 1;
+    pthread_cond_signal(&ioWork);
+    pthread_mutex_unlock(&ioMutex);
+#endif
+}
+
+/****************************************************************************/
+/* Waits for the block read in advance and returns it. "buffer" takes its   */
+/* place as read-ahead buffer. "error" is reported if the read failed.     */
+/****************************************************************************/
+static void *takeTapeBlock(TapeReadAhead *reader, void *buffer, int error) {
+    void *block = NULL;
+#if defined(ADOLC_HAVE_PTHREAD)
+    if (!reader->issued) fail(error);
+    pthread_mutex_lock(&ioMutex);
+    while (reader->pending)
+        pthread_cond_wait(&ioDone, &ioMutex);
+    pthread_mutex_unlock(&ioMutex);
+    if (reader->error) fail(error);
+    reader->issued = 0;
+    block = reader->buffer;
+    reader->buffer = buffer;
+#endif
+    return block;
+}
+
+/****************************************************************************/
+/* Waits for an outstanding read and releases the read-ahead buffer.        */
+/****************************************************************************/
+static void dropTapeReader(TapeReadAhead **readerPtr) {
+#if defined(ADOLC_HAVE_PTHREAD)
+    TapeReadAhead *reader = *readerPtr;
+
+    if (reader == NULL) return;
+    pthread_mutex_lock(&ioMutex);
+    while (reader->pending)
+        pthread_cond_wait(&ioDone, &ioMutex);
+    pthread_mutex_unlock(&ioMutex);
+    free(reader->buffer);
+    free(reader);
+    *readerPtr = NULL;
+#endif
+}
+
+static void writeTayBlock(revreal *lastTayP1, int async);
+
+/****************************************************************************/
+/* Completes all pending writes and reads of a tape and releases the       */
+/* buffers used for them (errors are ignored, used for cleaning up only).   */
+/****************************************************************************/
+void finish_tape_io(TapeInfos *tapeInfos) {
+    dropTapeReader(&tapeInfos->opReader);
+    dropTapeReader(&tapeInfos->locReader);
+    dropTapeReader(&tapeInfos->valReader);
+    dropTapeReader(&tapeInfos->tayReader);
+    flushTapeWriter(&tapeInfos->opWriter);
+    flushTapeWriter(&tapeInfos->locWriter);
+    flushTapeWriter(&tapeInfos->valWriter);
+    flushTapeWriter(&tapeInfos->tayWriter);
+}
+
+/****************************************************************************/
+/****************************************************************************/
+/* SINGLE FILE TAPE CONTAINER                                               */
+/****************************************************************************/
+/****************************************************************************/
+
+/* With TAPECONTAINER (.adolcrc) operations, locations and values of a new  */
+/* tape go to the single file ADOLC-Tape_<tag>.tap instead of three files.  */
+/* It starts with a fixed header (ADOLC_ID, stats, position of the index),  */
+/* followed by the blocks of the three streams in the order they have been */
+/* written and the block index. For every stream the index lists its       */
+/* blocks with their position within the stream and within the file, such  */
+/* that any part of a stream is found by a binary search and read with a    */
+/* single pread. The streams of a sweep share one file descriptor. Stream   */
+/* positions are those of the separate files, so blocks, prefetching and    */
+/* encoded locations work as before. A container tape is either completely */
+/* in core or completely on disk.                                           */
+typedef struct TapeContainerHeader {
+    char magic[8];
+    ADOLC_ID id;
+    size_t stats[TAPE_STAT_SIZE];
+    size_t indexOffset;                        /* position of the index */
+    size_t numBlocks[3];        /* index entries per stream (TAPENAMES) */
+} TapeContainerHeader;
+
+static const char containerMagic[8] = "ADOLCTC";
+
+/****************************************************************************/
+/* Creates the container file of the current tape when the first block of  */
+/* any of its streams is written. Old tape files of this tag are removed.  */
+/****************************************************************************/
+static void createContainer() {
+    TapeContainerHeader header;
+    FILE *file;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    remove(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName);
+    remove(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName);
+    remove(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName);
+    file = openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.container_fileName,
+                          "wb");
+    if (file == NULL) fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    /* the header is completed by finishContainer */
+    memset(&header, 0, sizeof(TapeContainerHeader));
+    if (fwrite(&header, sizeof(TapeContainerHeader), 1, file) != 1)
+        fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    free_block_index(&ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.containerSize = sizeof(TapeContainerHeader);
+    ADOLC_CURRENT_TAPE_INFOS.op_file = file;
+    ADOLC_CURRENT_TAPE_INFOS.loc_file = file;
+    ADOLC_CURRENT_TAPE_INFOS.val_file = file;
+}
+
+/****************************************************************************/
+/* Registers the next block of "size" bytes of "stream" (TAPENAMES), which  */
+/* is written next to the container.                                        */
+/****************************************************************************/
+static void addContainerBlock(int stream, size_t size) {
+    TapeBlock *block;
+    size_t num;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    num = ADOLC_CURRENT_TAPE_INFOS.numBlocks[stream];
+    if (num == ADOLC_CURRENT_TAPE_INFOS.maxBlocks[stream]) {
+        ADOLC_CURRENT_TAPE_INFOS.maxBlocks[stream] = (num > 0) ? 2 * num : 64;
+        block = (TapeBlock *)realloc(ADOLC_CURRENT_TAPE_INFOS.blockIndex[stream],
+                ADOLC_CURRENT_TAPE_INFOS.maxBlocks[stream] * sizeof(TapeBlock));
+        if (block == NULL) fail(ADOLC_MALLOC_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.blockIndex[stream] = block;
+    }
+    block = ADOLC_CURRENT_TAPE_INFOS.blockIndex[stream] + num;
+    block->streamOffset = (num > 0) ? block[-1].streamOffset + block[-1].size
+                                    : 0;
+    block->fileOffset = ADOLC_CURRENT_TAPE_INFOS.containerSize;
+    block->size = size;
+    ADOLC_CURRENT_TAPE_INFOS.containerSize += size;
+    ++ADOLC_CURRENT_TAPE_INFOS.numBlocks[stream];
+}
+
+/****************************************************************************/
+/* Appends the block index and writes the header of the container, all     */
+/* blocks must have been written.                                           */
+/****************************************************************************/
+static void finishContainer() {
+    TapeContainerHeader header;
+    FILE *file;
+    int i;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    file = ADOLC_CURRENT_TAPE_INFOS.loc_file;
+    memset(&header, 0, sizeof(TapeContainerHeader));
+    memcpy(header.magic, containerMagic, sizeof(header.magic));
+    header.id = adolc_id;
+    memcpy(header.stats, ADOLC_CURRENT_TAPE_INFOS.stats,
+           TAPE_STAT_SIZE * sizeof(size_t));
+    header.indexOffset = ADOLC_CURRENT_TAPE_INFOS.containerSize;
+    if (fseek(file, header.indexOffset, SEEK_SET) != 0)
+        fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    for (i = 0; i < 3; ++i) {
+        header.numBlocks[i] = ADOLC_CURRENT_TAPE_INFOS.numBlocks[i];
+        if (header.numBlocks[i] > 0 &&
+                fwrite(ADOLC_CURRENT_TAPE_INFOS.blockIndex[i],
+                       header.numBlocks[i] * sizeof(TapeBlock), 1, file) != 1)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    }
+    if (fseek(file, 0, SEEK_SET) != 0 ||
+            fwrite(&header, sizeof(TapeContainerHeader), 1, file) != 1)
+        fail(ADOLC_TAPING_FATAL_IO_ERROR);
+}
+
+/****************************************************************************/
+/* Reads the header of a container file, returns 0 if it is incomplete.     */
+/****************************************************************************/
+static int readContainerHeader(FILE *file, TapeContainerHeader *header) {
+    return fread(header, sizeof(TapeContainerHeader), 1, file) == 1 &&
+        memcmp(header->magic, containerMagic, sizeof(header->magic)) == 0;
+}
+
+/****************************************************************************/
+/* Reads the block index of a container file described by "header".        */
+/****************************************************************************/
+static void readBlockIndex(TapeInfos *tapeInfos, FILE *file,
+                           const TapeContainerHeader *header) {
+    int i;
+
+    free_block_index(tapeInfos);
+    if (fseek(file, header->indexOffset, SEEK_SET) != 0)
+        fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+    for (i = 0; i < 3; ++i) {
+        if (header->numBlocks[i] == 0) continue;
+        tapeInfos->blockIndex[i] =
+            (TapeBlock *)malloc(header->numBlocks[i] * sizeof(TapeBlock));
+        if (tapeInfos->blockIndex[i] == NULL) fail(ADOLC_MALLOC_FAILED);
+        if (fread(tapeInfos->blockIndex[i],
+                  header->numBlocks[i] * sizeof(TapeBlock), 1, file) != 1)
+            fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+        tapeInfos->numBlocks[i] = header->numBlocks[i];
+        tapeInfos->maxBlocks[i] = header->numBlocks[i];
+    }
+}
+
+void free_block_index(TapeInfos *tapeInfos) {
+    int i;
+
+    for (i = 0; i < 3; ++i) {
+        free(tapeInfos->blockIndex[i]);
+        tapeInfos->blockIndex[i] = NULL;
+        tapeInfos->numBlocks[i] = 0;
+        tapeInfos->maxBlocks[i] = 0;
+    }
+}
+
+/* returns the block of "stream" holding byte "pos" of it or NULL */
+static const TapeBlock *findTapeBlock(const TapeInfos *tapeInfos, int stream,
+                                      size_t pos) {
+    const TapeBlock *blocks = tapeInfos->blockIndex[stream];
+    size_t low = 0, high = tapeInfos->numBlocks[stream], mid;
+
+    if (high == 0) return NULL;
+    while (high - low > 1) {
+        mid = low + (high - low) / 2;
+        if (blocks[mid].streamOffset <= pos) low = mid;
+        else high = mid;
+    }
+    if (pos < blocks[low].streamOffset ||
+            pos >= blocks[low].streamOffset + blocks[low].size)
+        return NULL;
+    return blocks + low;
+}
+
+/****************************************************************************/
+/* Reads "size" bytes at position "pos" of a stream (TAPENAMES) of a tape   */
+/* from "file", its own file or the container. Returns 1 on success.       */
+/****************************************************************************/
+static int readTapeStream(const TapeInfos *tapeInfos, FILE *file, int stream,
+                          size_t pos, void *data, size_t size) {
+    const TapeBlock *block;
+    size_t number;
+
+    if (!tapeInfos->containerTape)
+        return readFileAt(tapeIOMode(), file, data, size, pos);
+    while (size > 0) {
+        if ((block = findTapeBlock(tapeInfos, stream, pos)) == NULL)
+            return 0;
+        number = MIN_ADOLC(size, block->streamOffset + block->size - pos);
+        if (!readFileAt(tapeIOMode(), file, data, number,
+                    block->fileOffset + pos - block->streamOffset))
+            return 0;
+        data = (char *)data + number;
+        pos += number;
+        size -= number;
+    }
+    return 1;
+}
+
+/* size of a stream of a container tape in bytes */
+static size_t containerStreamSize(int stream) {
+    const TapeBlock *last;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_CURRENT_TAPE_INFOS.numBlocks[stream] == 0) return 0;
+    last = ADOLC_CURRENT_TAPE_INFOS.blockIndex[stream] +
+        ADOLC_CURRENT_TAPE_INFOS.numBlocks[stream] - 1;
+    return last->streamOffset + last->size;
+}
+
+/****************************************************************************/
+/* Opens the file "fileName" of a stream of the current tape for reading.   */
+/* The streams of a container tape share the container file.               */
+/****************************************************************************/
+static FILE *openTapeFile(const char *fileName) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (!ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        return openTapeStream(fileName, "rb");
+    if (ADOLC_CURRENT_TAPE_INFOS.op_file != NULL)
+        return ADOLC_CURRENT_TAPE_INFOS.op_file;
+    if (ADOLC_CURRENT_TAPE_INFOS.loc_file != NULL)
+        return ADOLC_CURRENT_TAPE_INFOS.loc_file;
+    if (ADOLC_CURRENT_TAPE_INFOS.val_file != NULL)
+        return ADOLC_CURRENT_TAPE_INFOS.val_file;
+    return openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.container_fileName,
+                          "rb");
+}
+
+/****************************************************************************/
+/* Closes the op/loc/val files of a tape, a shared container only once.     */
+/****************************************************************************/
+void close_tape_files(TapeInfos *tapeInfos) {
+    FILE *op_file = tapeInfos->op_file, *loc_file = tapeInfos->loc_file;
+    FILE *val_file = tapeInfos->val_file;
+
+    if (loc_file == op_file) loc_file = NULL;
+    if (val_file == op_file || val_file == loc_file) val_file = NULL;
+    if (op_file != NULL) fclose(op_file);
+    if (loc_file != NULL) fclose(loc_file);
+    if (val_file != NULL) fclose(val_file);
+    tapeInfos->op_file = NULL;
+    tapeInfos->loc_file = NULL;
+    tapeInfos->val_file = NULL;
+}
+
 /****************************************************************************/
 /****************************************************************************/
 /* VALUE STACK FUNCTIONS                                                    */
 /****************************************************************************/
 /****************************************************************************/
 
-static unsigned int numTBuffersInUse = 0;
+static ADOLC_THREAD_LOCAL unsigned int numTBuffersInUse = 0;
 
 /* record all existing adoubles on the tape
  * - intended to be used in start_trace only */
@@ -689,6 +1533,160 @@ locint keep_stock() {
 }
 
 
+/****************************************************************************/
+/****************************************************************************/
+/* TAYLOR STACK CODEC                                                       */
+/****************************************************************************/
+/****************************************************************************/
+/* With TAYLORCODEC > 0 each block spilled to the taylor file is stored as  */
+/* a bitmap with one bit per value, set if the value repeats the value      */
+/* before it bit by bit, followed by all other values (as float for         */
+/* ADOLC_TAY_FLOAT). Locations are unknown at this level, repeats are thus  */
+/* detected between neighbouring stack entries only. A block that does not */
+/* get smaller is stored unchanged, both forms are told apart by the size  */
+/* recorded in tayBlockEnd.                                                 */
+/****************************************************************************/
+
+/* Encodes "number" values into "code", returns 0 if not worth it */
+static size_t encodeTayBlock(const revreal *values, size_t number,
+                             unsigned char *code, char codec) {
+    size_t i, size, mapSize = (number + 7) / 8;
+    size_t width = (codec == ADOLC_TAY_FLOAT) ? sizeof(float) : sizeof(revreal);
+    unsigned char *literal;
+    float single;
+
+    size = mapSize + width;
+    for (i = 1; i < number; ++i)
+        if (memcmp(values + i, values + i - 1, sizeof(revreal)) != 0)
+            size += width;
+    if (size >= number * sizeof(revreal)) return 0;
+
+    memset(code, 0, mapSize);
+    literal = code + mapSize;
+    for (i = 0; i < number; ++i) {
+        if (i > 0 && memcmp(values + i, values + i - 1, sizeof(revreal)) == 0) {
+            code[i / 8] |= (unsigned char)(1 << (i % 8));
+            continue;
+        }
+        if (codec == ADOLC_TAY_FLOAT) {
+            single = (float)values[i];
+            memcpy(literal, &single, width);
+        } else
+            memcpy(literal, values + i, width);
+        literal += width;
+    }
+    return size;
+}
+
+static void decodeTayBlock(const unsigned char *code, size_t number,
+                           revreal *values, char codec) {
+    size_t i, mapSize = (number + 7) / 8;
+    size_t width = (codec == ADOLC_TAY_FLOAT) ? sizeof(float) : sizeof(revreal);
+    const unsigned char *literal = code + mapSize;
+    float single;
+
+    for (i = 0; i < number; ++i) {
+        if (code[i / 8] & (1 << (i % 8))) {
+            values[i] = values[i - 1];
+            continue;
+        }
+        if (codec == ADOLC_TAY_FLOAT) {
+            memcpy(&single, literal, width);
+            values[i] = (revreal)single;
+        } else
+            memcpy(values + i, literal, width);
+        literal += width;
+    }
+}
+
+/* records a block of "size" bytes appended to the taylor file */
+static void appendTayBlock(size_t size) {
+    size_t start, newMax, *blockEnd;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_CURRENT_TAPE_INFOS.numTayBlocks ==
+            ADOLC_CURRENT_TAPE_INFOS.maxTayBlocks) {
+        newMax = (ADOLC_CURRENT_TAPE_INFOS.maxTayBlocks == 0) ? 64 :
+            2 * ADOLC_CURRENT_TAPE_INFOS.maxTayBlocks;
+        blockEnd = (size_t *)realloc(ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd,
+                                     newMax * sizeof(size_t));
+        if (blockEnd == NULL) fail(ADOLC_MALLOC_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd = blockEnd;
+        ADOLC_CURRENT_TAPE_INFOS.maxTayBlocks = newMax;
+    }
+    start = (ADOLC_CURRENT_TAPE_INFOS.numTayBlocks == 0) ? 0 :
+        ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd[
+            ADOLC_CURRENT_TAPE_INFOS.numTayBlocks - 1];
+    ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd[
+        ADOLC_CURRENT_TAPE_INFOS.numTayBlocks++] = start + size;
+}
+
+/* returns the size in the taylor file of block "block" holding "number"
+ * values and sets "offset" to its position */
+static size_t tayBlockLocation(int block, size_t number, size_t *offset) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (ADOLC_CURRENT_TAPE_INFOS.tayCodec == ADOLC_TAY_PLAIN) {
+        *offset = sizeof(revreal) * block *
+            ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE];
+        return number * sizeof(revreal);
+    }
+    *offset = (block == 0) ? 0 : ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd[block - 1];
+    return ADOLC_CURRENT_TAPE_INFOS.tayBlockEnd[block] - *offset;
+}
+
+/* decodes the block of "size" bytes just placed in the taylor buffer */
+static void unpackTayBlock(size_t size, size_t number) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (size == number * sizeof(revreal)) return;
+    memcpy(ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer,
+           ADOLC_CURRENT_TAPE_INFOS.tayBuffer, size);
+    decodeTayBlock(ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer, number,
+                   ADOLC_CURRENT_TAPE_INFOS.tayBuffer,
+                   ADOLC_CURRENT_TAPE_INFOS.tayCodec);
+}
+
+/* reads block "block" holding "number" values into the taylor buffer */
+static void readTayBlock(int block, size_t number) {
+    size_t offset, size, done, chunk;
+    unsigned char *data;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    size = tayBlockLocation(block, number, &offset);
+    data = (size == number * sizeof(revreal)) ?
+        (unsigned char *)ADOLC_CURRENT_TAPE_INFOS.tayBuffer :
+        ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer;
+    if (fseek(ADOLC_CURRENT_TAPE_INFOS.tay_file, offset, SEEK_SET) == -1)
+        fail(ADOLC_EVAL_SEEK_VALUE_STACK);
+    for (done = 0; done < size; done += chunk) {
+        chunk = MIN_ADOLC(size - done, ADOLC_IO_CHUNK_SIZE);
+        if ((failAdditionalInfo1 = readTapeData(data + done, chunk, 1,
+                        ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    }
+    if (data != (unsigned char *)ADOLC_CURRENT_TAPE_INFOS.tayBuffer)
+        decodeTayBlock(data, number, ADOLC_CURRENT_TAPE_INFOS.tayBuffer,
+                       ADOLC_CURRENT_TAPE_INFOS.tayCodec);
+}
+
+void free_tay_index(TapeInfos *tapeInfos) {
+    free(tapeInfos->tayBlockEnd);
+    tapeInfos->tayBlockEnd = NULL;
+    tapeInfos->numTayBlocks = 0;
+    tapeInfos->maxTayBlocks = 0;
+    free(tapeInfos->tayCodecBuffer);
+    tapeInfos->tayCodecBuffer = NULL;
+    free(tapeInfos->tayKeepBits);
+    tapeInfos->tayKeepBits = NULL;
+    tapeInfos->numTayKeepBits = 0;
+    tapeInfos->maxTayKeepBytes = 0;
+}
+
 /****************************************************************************/
 /* Set up statics for writing taylor data                                   */
 /****************************************************************************/
@@ -715,9 +1713,21 @@ void taylor_begin(uint bufferSize, int degreeSave) {
     if (ADOLC_CURRENT_TAPE_INFOS.tayBuffer != NULL)
         free(ADOLC_CURRENT_TAPE_INFOS.tayBuffer);
     ADOLC_CURRENT_TAPE_INFOS.tayBuffer = (revreal *)
-            malloc(sizeof(revreal) * bufferSize);
+            allocTapeBuffer(sizeof(revreal) * bufferSize);
     if (ADOLC_CURRENT_TAPE_INFOS.tayBuffer == NULL)
         fail(ADOLC_TAPING_TBUFFER_ALLOCATION_FAILED);
+    free_tay_index(&ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.tayKeepSelective = 0;
+    ADOLC_CURRENT_TAPE_INFOS.tayCodec = ADOLC_GLOBAL_TAPE_VARS.tayCodec;
+    if (ADOLC_CURRENT_TAPE_INFOS.tayCodec == ADOLC_TAY_FLOAT &&
+            sizeof(revreal) <= sizeof(float))
+        ADOLC_CURRENT_TAPE_INFOS.tayCodec = ADOLC_TAY_REPEATS;
+    if (ADOLC_CURRENT_TAPE_INFOS.tayCodec != ADOLC_TAY_PLAIN) {
+        ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer = (unsigned char *)
+            allocTapeBuffer(sizeof(revreal) * bufferSize);
+        if (ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer == NULL)
+            fail(ADOLC_TAPING_TBUFFER_ALLOCATION_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.deg_save = degreeSave;
     if (degreeSave >= 0 ) ADOLC_CURRENT_TAPE_INFOS.keepTaylors = 1;
     ADOLC_CURRENT_TAPE_INFOS.currTay = ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
@@ -737,17 +1747,23 @@ void taylor_close(uint buffer) {
     if (buffer == 0) {
         /* enforces failure of reverse => retaping */
         ADOLC_CURRENT_TAPE_INFOS.deg_save = -1;
+        flushTapeWriter(&ADOLC_CURRENT_TAPE_INFOS.tayWriter);
         if (ADOLC_CURRENT_TAPE_INFOS.tay_file != NULL) {
             fclose(ADOLC_CURRENT_TAPE_INFOS.tay_file);
             remove(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.tay_fileName);
             ADOLC_CURRENT_TAPE_INFOS.tay_file = NULL;
         }
+        free_tay_index(&ADOLC_CURRENT_TAPE_INFOS);
         return;
     }
 
     if (ADOLC_CURRENT_TAPE_INFOS.tay_file != NULL) {
+        /* the last block stays in core for the reverse sweep and is thus
+         * written synchronously after all pending blocks */
+        if (flushTapeWriter(&ADOLC_CURRENT_TAPE_INFOS.tayWriter) != 0)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
         if (ADOLC_CURRENT_TAPE_INFOS.keepTaylors)
-            put_tay_block(ADOLC_CURRENT_TAPE_INFOS.currTay);
+            writeTayBlock(ADOLC_CURRENT_TAPE_INFOS.currTay, 0);
     } else {
         ADOLC_CURRENT_TAPE_INFOS.numTays_Tape =
             ADOLC_CURRENT_TAPE_INFOS.currTay -
@@ -775,12 +1791,27 @@ void taylor_close(uint buffer) {
     #endif
 }
 
+/* Read-ahead (IOBUFNUM > 1) of the taylor block needed next in reverse */
+static void prefetchTayBlock() {
+    size_t offset, size;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!asyncTapeIO() || ADOLC_CURRENT_TAPE_INFOS.tay_file == NULL ||
+            ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber < 0)
+        return;
+    size = tayBlockLocation(ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber,
+            ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE], &offset);
+    prefetchTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.tayReader,
+            ADOLC_CURRENT_TAPE_INFOS.tay_file, offset, size, sizeof(revreal) *
+            (ADOLC_CURRENT_TAPE_INFOS.lastTayP1 -
+             ADOLC_CURRENT_TAPE_INFOS.tayBuffer));
+}
+
 /****************************************************************************/
 /* Initializes a reverse sweep.                                             */
 /****************************************************************************/
 void taylor_back (short tag, int* dep, int* ind, int* degree) {
-    int i, chunks;
-    size_t number, remain, chunkSize;
+    size_t number;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
@@ -792,6 +1823,7 @@ void taylor_back (short tag, int* dep, int* ind, int* degree) {
 
     if (ADOLC_CURRENT_TAPE_INFOS.tayBuffer == NULL)
         fail(ADOLC_REVERSE_NO_TAYLOR_STACK);
+    dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.tayReader);
     ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber =
         ADOLC_CURRENT_TAPE_INFOS.numTays_Tape /
         ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE];
@@ -799,30 +1831,12 @@ void taylor_back (short tag, int* dep, int* ind, int* degree) {
            ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE];
     ADOLC_CURRENT_TAPE_INFOS.currTay =
         ADOLC_CURRENT_TAPE_INFOS.tayBuffer + number;
-    if (ADOLC_CURRENT_TAPE_INFOS.lastTayBlockInCore != 1) {
-        if ( fseek(ADOLC_CURRENT_TAPE_INFOS.tay_file,
-                sizeof(revreal) *
-                ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber *
-                ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE],
-                SEEK_SET)
-                == -1 ) fail(ADOLC_EVAL_SEEK_VALUE_STACK);
-        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(revreal);
-        chunks = number / chunkSize;
-        for (i = 0; i < chunks; ++i)
-            if ((failAdditionalInfo1 =
-                        fread(ADOLC_CURRENT_TAPE_INFOS.tayBuffer +
-                            i * chunkSize, chunkSize * sizeof(revreal), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
-                fail(ADOLC_TAPING_FATAL_IO_ERROR);
-        remain = number % chunkSize;
-        if (remain != 0)
-            if ((failAdditionalInfo1 =
-                        fread(ADOLC_CURRENT_TAPE_INFOS.tayBuffer +
-                            chunks * chunkSize, remain * sizeof(revreal), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
-                fail(ADOLC_TAPING_FATAL_IO_ERROR);
-    }
+    if (ADOLC_CURRENT_TAPE_INFOS.lastTayBlockInCore != 1 && number != 0)
+        readTayBlock(ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber, number);
+    ADOLC_CURRENT_TAPE_INFOS.tayKeepBitPos =
+        ADOLC_CURRENT_TAPE_INFOS.numTayKeepBits;
     --ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber;
+    prefetchTayBlock();
 }
 
 /****************************************************************************/
@@ -917,43 +1931,108 @@ void write_scaylors(revreal *x, uint size) {
 }
 
 /****************************************************************************/
-/* Writes the value stack buffer onto hard disk.                            */
+/* Writes the value stack buffer onto hard disk. With "async" set, the      */
+/* buffer is handed over to the writer thread and replaced by a free one.   */
 /****************************************************************************/
-void put_tay_block(revreal *lastTayP1) {
-    int i, chunks;
-    size_t number, remain, chunkSize;
+static void writeTayBlock(revreal *lastTayP1, int async) {
+    size_t number, size, encoded, done, chunk, bufferSize;
+    unsigned char *data;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
     if (ADOLC_CURRENT_TAPE_INFOS.tay_file == NULL) {
         ADOLC_CURRENT_TAPE_INFOS.tay_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.tay_fileName, "w+b");
+            openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.tay_fileName,
+                           "w+b");
         if (ADOLC_CURRENT_TAPE_INFOS.tay_file == NULL)
             fail(ADOLC_TAPING_TAYLOR_OPEN_FAILED);
     }
     number = lastTayP1 - ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
     if (number != 0) {
-        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(revreal);
-        chunks = number / chunkSize;
-        for (i = 0; i < chunks; ++i)
-            if ((failAdditionalInfo1 =
-                    fwrite(ADOLC_CURRENT_TAPE_INFOS.tayBuffer + i *
-                            chunkSize, chunkSize * sizeof(revreal), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.tay_file) ) != 1)
-                fail(ADOLC_TAPING_FATAL_IO_ERROR);
-        remain = number % chunkSize;
-        if (remain != 0)
-            if ((failAdditionalInfo1 =
-                    fwrite(ADOLC_CURRENT_TAPE_INFOS.tayBuffer + chunks *
-                            chunkSize, remain * sizeof(revreal), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.tay_file) ) != 1)
-                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        size = number * sizeof(revreal);
+        data = (unsigned char *)ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
+        if (ADOLC_CURRENT_TAPE_INFOS.tayCodec != ADOLC_TAY_PLAIN) {
+            encoded = encodeTayBlock(ADOLC_CURRENT_TAPE_INFOS.tayBuffer,
+                    number, ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer,
+                    ADOLC_CURRENT_TAPE_INFOS.tayCodec);
+            if (encoded != 0) {
+                size = encoded;
+                data = ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer;
+            }
+            appendTayBlock(size);
+        }
+        if (async) {
+            bufferSize = ADOLC_CURRENT_TAPE_INFOS.lastTayP1 -
+                ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
+            if (data == ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer) {
+                /* the taylor buffer is reused right away */
+                ADOLC_CURRENT_TAPE_INFOS.tayCodecBuffer = (unsigned char *)
+                    queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.tayWriter,
+                                   ADOLC_CURRENT_TAPE_INFOS.tay_file, data,
+                                   size, bufferSize * sizeof(revreal));
+            } else {
+                ADOLC_CURRENT_TAPE_INFOS.tayBuffer = (revreal *)
+                    queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.tayWriter,
+                                   ADOLC_CURRENT_TAPE_INFOS.tay_file, data,
+                                   size, bufferSize * sizeof(revreal));
+                ADOLC_CURRENT_TAPE_INFOS.lastTayP1 =
+                    ADOLC_CURRENT_TAPE_INFOS.tayBuffer + bufferSize;
+            }
+        } else {
+            for (done = 0; done < size; done += chunk) {
+                chunk = MIN_ADOLC(size - done, ADOLC_IO_CHUNK_SIZE);
+                if ((failAdditionalInfo1 = writeTapeData(data + done, chunk, 1,
+                                ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
+                    fail(ADOLC_TAPING_FATAL_IO_ERROR);
+            }
+        }
         ADOLC_CURRENT_TAPE_INFOS.numTays_Tape += number;
     }
     ADOLC_CURRENT_TAPE_INFOS.currTay = ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
 }
 
+void put_tay_block(revreal *lastTayP1) {
+    writeTayBlock(lastTayP1, asyncTapeIO());
+}
+
+/****************************************************************************/
+/* Selective taylor recording (SELECTIVETAYLORS): zos_forward leaves out   */
+/* the old result values of linear operations that no reverse rule reads.  */
+/* One bit per such operation tells the reverse sweep whether to pop.      */
+/****************************************************************************/
+void put_tay_keep_bit(int kept) {
+    size_t byte, newMax;
+    unsigned char *bits;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    byte = ADOLC_CURRENT_TAPE_INFOS.numTayKeepBits / 8;
+    if (byte == ADOLC_CURRENT_TAPE_INFOS.maxTayKeepBytes) {
+        newMax = (byte == 0) ? 4096 : 2 * byte;
+        bits = (unsigned char *)realloc(ADOLC_CURRENT_TAPE_INFOS.tayKeepBits,
+                                        newMax);
+        if (bits == NULL) fail(ADOLC_MALLOC_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.tayKeepBits = bits;
+        ADOLC_CURRENT_TAPE_INFOS.maxTayKeepBytes = newMax;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.numTayKeepBits % 8 == 0)
+        ADOLC_CURRENT_TAPE_INFOS.tayKeepBits[byte] = 0;
+    if (kept)
+        ADOLC_CURRENT_TAPE_INFOS.tayKeepBits[byte] |= (unsigned char)
+            (1 << (ADOLC_CURRENT_TAPE_INFOS.numTayKeepBits % 8));
+    ++ADOLC_CURRENT_TAPE_INFOS.numTayKeepBits;
+}
+
+int get_tay_keep_bit() {
+    size_t pos;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    pos = --ADOLC_CURRENT_TAPE_INFOS.tayKeepBitPos;
+    return (ADOLC_CURRENT_TAPE_INFOS.tayKeepBits[pos / 8] >> (pos % 8)) & 1;
+}
+
 /****************************************************************************/
 /* Puts a block of taylor coefficients from the value stack buffer to the   */
 /* taylor buffer. --- Higher Order Scalar                                   */
@@ -1025,30 +2104,30 @@ void get_taylors_p(locint loc, int degree, int numDir) {
 /* Gets the next (previous block) of the value stack                        */
 /****************************************************************************/
 void get_tay_block_r() {
-    int i, chunks;
-    size_t number, remain, chunkSize;
+    size_t number, offset, size;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
     ADOLC_CURRENT_TAPE_INFOS.lastTayBlockInCore = 0;
     number = ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE];
-    if ( fseek(ADOLC_CURRENT_TAPE_INFOS.tay_file, sizeof(revreal) *
-                ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber * number, SEEK_SET)
-            == -1 )
-        fail(ADOLC_EVAL_SEEK_VALUE_STACK);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(revreal);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if ((failAdditionalInfo1 = fread(ADOLC_CURRENT_TAPE_INFOS.tayBuffer +
-                        i * chunkSize, chunkSize * sizeof(revreal), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if ((failAdditionalInfo1 = fread(ADOLC_CURRENT_TAPE_INFOS.tayBuffer +
-                        chunks * chunkSize, remain * sizeof(revreal), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.tay_file)) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    if (ADOLC_CURRENT_TAPE_INFOS.tayReader != NULL) {
+        size_t bufferSize = ADOLC_CURRENT_TAPE_INFOS.lastTayP1 -
+            ADOLC_CURRENT_TAPE_INFOS.tayBuffer;
+        ADOLC_CURRENT_TAPE_INFOS.tayBuffer = (revreal *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.tayReader,
+                    ADOLC_CURRENT_TAPE_INFOS.tayBuffer,
+                    ADOLC_TAPING_FATAL_IO_ERROR);
+        ADOLC_CURRENT_TAPE_INFOS.lastTayP1 =
+            ADOLC_CURRENT_TAPE_INFOS.tayBuffer + bufferSize;
+        size = tayBlockLocation(ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber,
+                number, &offset);
+        unpackTayBlock(size, number);
+        ADOLC_CURRENT_TAPE_INFOS.currTay = ADOLC_CURRENT_TAPE_INFOS.lastTayP1;
+        --ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber;
+        prefetchTayBlock();
+        return;
+    }
+    readTayBlock(ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber, number);
     ADOLC_CURRENT_TAPE_INFOS.currTay = ADOLC_CURRENT_TAPE_INFOS.lastTayP1;
     --ADOLC_CURRENT_TAPE_INFOS.nextBufferNumber;
 }
@@ -1066,14 +2145,16 @@ void initTapeBuffers() {
 
     if (ADOLC_CURRENT_TAPE_INFOS.opBuffer == NULL)
         ADOLC_CURRENT_TAPE_INFOS.opBuffer = (unsigned char *)
-                malloc(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] *
-                       sizeof(unsigned char));
+                allocTapeBuffer(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] *
+                                sizeof(unsigned char));
     if (ADOLC_CURRENT_TAPE_INFOS.locBuffer == NULL)
         ADOLC_CURRENT_TAPE_INFOS.locBuffer = (locint *)
-                malloc(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] * sizeof(locint));
+                allocTapeBuffer(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] *
+                                sizeof(locint));
     if (ADOLC_CURRENT_TAPE_INFOS.valBuffer == NULL)
         ADOLC_CURRENT_TAPE_INFOS.valBuffer = (double *)
-                malloc(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] * sizeof(double));
+                allocTapeBuffer(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] *
+                                sizeof(double));
     if ( ADOLC_CURRENT_TAPE_INFOS.opBuffer  == NULL ||
             ADOLC_CURRENT_TAPE_INFOS.locBuffer == NULL ||
             ADOLC_CURRENT_TAPE_INFOS.valBuffer == NULL )
@@ -1108,7 +2189,7 @@ void start_trace() {
     put_op(start_of_tape);
 
     /* Leave space for the stats */
-    space = STAT_SIZE * sizeof(size_t) + sizeof(ADOLC_ID);
+    space = TAPE_STAT_SIZE * sizeof(size_t) + sizeof(ADOLC_ID);
     if (space > statSpace * sizeof(locint))
         fail(ADOLC_MORE_STAT_SPACE_REQUIRED);
     for (i = 0; i < statSpace; ++i) ADOLC_PUT_LOCINT(0);
@@ -1121,23 +2202,13 @@ void start_trace() {
     markNewTape();
 }
 
-static void save_params() {
+/* writes the parameters of the current tape behind its end_of_tape */
+void put_params() {
     size_t np;
     size_t ip, avail, remain, chunk;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
-    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM] =
-        ADOLC_GLOBAL_TAPE_VARS.numparam;
-    if (ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore != NULL)
-	free(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore);
-
-    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore =
-            malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM]*sizeof(double));
-    memcpy(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore,
-           ADOLC_GLOBAL_TAPE_VARS.pStore,
-           ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM]*sizeof(double));
-    free_all_taping_params();
     if (ADOLC_CURRENT_TAPE_INFOS.currVal +
         ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM] <
         ADOLC_CURRENT_TAPE_INFOS.lastValP1)
@@ -1158,6 +2229,24 @@ static void save_params() {
     }
 }
 
+static void save_params() {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM] =
+        ADOLC_GLOBAL_TAPE_VARS.numparam;
+    if (ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore != NULL)
+	free(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore);
+
+    ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore =
+            malloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM]*sizeof(double));
+    memcpy(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore,
+           ADOLC_GLOBAL_TAPE_VARS.pStore,
+           ADOLC_CURRENT_TAPE_INFOS.stats[NUM_PARAM]*sizeof(double));
+    free_all_taping_params();
+    put_params();
+}
+
 /****************************************************************************/
 /* Stop Tracing.  Clean up, and turn off trace_flag.                        */
 /****************************************************************************/
@@ -1214,7 +2303,11 @@ void close_tape(int flag) {
         {
             put_op_block(ADOLC_CURRENT_TAPE_INFOS.currOp);
         }
-        if (ADOLC_CURRENT_TAPE_INFOS.op_file != NULL)
+        if (flushTapeWriter(&ADOLC_CURRENT_TAPE_INFOS.opWriter) != 0)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        /* a container is closed with the locations */
+        if (ADOLC_CURRENT_TAPE_INFOS.op_file != NULL &&
+                !ADOLC_CURRENT_TAPE_INFOS.containerTape)
             fclose(ADOLC_CURRENT_TAPE_INFOS.op_file);
         ADOLC_CURRENT_TAPE_INFOS.op_file = NULL;
         ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] = 1;
@@ -1234,7 +2327,10 @@ void close_tape(int flag) {
         {
             put_val_block(ADOLC_CURRENT_TAPE_INFOS.currVal);
         }
-        if (ADOLC_CURRENT_TAPE_INFOS.val_file != NULL) 
+        if (flushTapeWriter(&ADOLC_CURRENT_TAPE_INFOS.valWriter) != 0)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        if (ADOLC_CURRENT_TAPE_INFOS.val_file != NULL &&
+                !ADOLC_CURRENT_TAPE_INFOS.containerTape)
             fclose(ADOLC_CURRENT_TAPE_INFOS.val_file);
         ADOLC_CURRENT_TAPE_INFOS.val_file = NULL;
         ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] = 1;
@@ -1257,16 +2353,27 @@ void close_tape(int flag) {
         ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] =
             ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape;
         ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] = 1;
+        if (flushTapeWriter(&ADOLC_CURRENT_TAPE_INFOS.locWriter) != 0)
+            fail(ADOLC_TAPING_FATAL_IO_ERROR);
         /* write tape stats */
-        fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file, 0, 0);
-        fwrite(&adolc_id, sizeof(ADOLC_ID), 1,
-                ADOLC_CURRENT_TAPE_INFOS.loc_file);
-        fwrite(ADOLC_CURRENT_TAPE_INFOS.stats, STAT_SIZE * sizeof(size_t), 1,
-               ADOLC_CURRENT_TAPE_INFOS.loc_file);
+        if (ADOLC_CURRENT_TAPE_INFOS.containerTape)
+            finishContainer();
+        else {
+            fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file, 0, 0);
+            fwrite(&adolc_id, sizeof(ADOLC_ID), 1,
+                    ADOLC_CURRENT_TAPE_INFOS.loc_file);
+            fwrite(ADOLC_CURRENT_TAPE_INFOS.stats,
+                   TAPE_STAT_SIZE * sizeof(size_t), 1,
+                   ADOLC_CURRENT_TAPE_INFOS.loc_file);
+            /* would be found first by read_tape_stats */
+            remove(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.container_fileName);
+        }
         fclose(ADOLC_CURRENT_TAPE_INFOS.loc_file);
         ADOLC_CURRENT_TAPE_INFOS.loc_file = NULL;
         free(ADOLC_CURRENT_TAPE_INFOS.locBuffer);
         ADOLC_CURRENT_TAPE_INFOS.locBuffer = NULL;
+        free(ADOLC_CURRENT_TAPE_INFOS.locFrame);
+        ADOLC_CURRENT_TAPE_INFOS.locFrame = NULL;
     } else {
 	ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape  =
 	    ADOLC_CURRENT_TAPE_INFOS.currLoc - ADOLC_CURRENT_TAPE_INFOS.locBuffer;
@@ -1279,10 +2386,22 @@ void close_tape(int flag) {
 /* Free all resources used by a tape before overwriting the tape.           */
 /****************************************************************************/
 void freeTapeResources(TapeInfos *tapeInfos) {
+    if (tapeInfos->sharedTape != NULL) {
+        /* the buffers of a view belong to the serial tape */
+        tapeInfos->opBuffer = NULL;
+        tapeInfos->locBuffer = NULL;
+        tapeInfos->valBuffer = NULL;
+        tapeInfos->decodedTape = NULL;
+        tapeInfos->sharedTape = NULL;
+    }
+    unmap_tape_files(tapeInfos);
+    finish_tape_io(tapeInfos);
     free(tapeInfos->opBuffer);
     tapeInfos->opBuffer = NULL;
     free(tapeInfos->locBuffer);
     tapeInfos->locBuffer = NULL;
+    free(tapeInfos->locFrame);
+    tapeInfos->locFrame = NULL;
     free(tapeInfos->valBuffer);
     tapeInfos->valBuffer = NULL;
     if (tapeInfos->tayBuffer != NULL) {
@@ -1290,18 +2409,11 @@ void freeTapeResources(TapeInfos *tapeInfos) {
         tapeInfos->tayBuffer = NULL;
         --numTBuffersInUse;
     }
-    if (tapeInfos->op_file != NULL) {
-        fclose(tapeInfos->op_file);
-        tapeInfos->op_file = NULL;
-    }
-    if (tapeInfos->loc_file != NULL) {
-        fclose(tapeInfos->loc_file);
-        tapeInfos->loc_file = NULL;
-    }
-    if (tapeInfos->val_file != NULL) {
-        fclose(tapeInfos->val_file);
-        tapeInfos->val_file = NULL;
-    }
+    free_block_index(tapeInfos);
+    free_tay_index(tapeInfos);
+    free_decoded_tape(tapeInfos);
+    free_compiled_tape(tapeInfos);
+    close_tape_files(tapeInfos);
     if (tapeInfos->tay_file != NULL) {
         fclose(tapeInfos->tay_file);
         tapeInfos->tay_file = NULL;
@@ -1356,6 +2468,8 @@ void printTapeStats(FILE *stream, short tag) {
     fprintf(stream, "Operation file written: %10zu\n", stats[OP_FILE_ACCESS]);
     fprintf(stream, "Location file written:  %10zu\n", stats[LOC_FILE_ACCESS]);
     fprintf(stream, "Value file written:     %10zu\n", stats[VAL_FILE_ACCESS]);
+    fprintf(stream, "Location file format:   %10zu\n",
+            getTapeInfos(tag)->stats[LOC_FILE_FORMAT]);
     fprintf(stream, "\n");
     fprintf(stream, "Operation buffer size:  %10zu\n", stats[OP_BUFFER_SIZE]);
     fprintf(stream, "Location buffer size:   %10zu\n", stats[LOC_BUFFER_SIZE]);
@@ -1384,8 +2498,8 @@ size_t get_num_param(short tag) {
 /****************************************************************************/
 static void read_params(TapeInfos* tapeInfos) {
     FILE* val_file;
-    int i, chunks;
-    size_t number, remain, chunkSize, nVT;
+    int i;
+    size_t number, nVT;
     double *valBuffer = NULL, *currVal = NULL, *lastValP1 = NULL;
     size_t np, ip, avail, rsize;
     if (tapeInfos->pTapeInfos.paramstore == NULL)
@@ -1394,27 +2508,15 @@ static void read_params(TapeInfos* tapeInfos) {
     valBuffer = (double*)
         malloc(tapeInfos->stats[VAL_BUFFER_SIZE] *sizeof(double));
     lastValP1 = valBuffer + tapeInfos->stats[VAL_BUFFER_SIZE];
-    if ((val_file = fopen(tapeInfos->pTapeInfos.val_fileName, "rb")) == NULL)
+    if ((val_file = fopen(tapeInfos->containerTape ?
+                    tapeInfos->pTapeInfos.container_fileName :
+                    tapeInfos->pTapeInfos.val_fileName, "rb")) == NULL)
         fail(ADOLC_VALUE_TAPE_FOPEN_FAILED);
-    number = (tapeInfos->stats[NUM_VALUES] /
-              tapeInfos->stats[VAL_BUFFER_SIZE]) *
-        tapeInfos->stats[VAL_BUFFER_SIZE];
-    fseek(val_file, number * sizeof(double), SEEK_SET);
     number = tapeInfos->stats[NUM_VALUES] % tapeInfos->stats[VAL_BUFFER_SIZE];
-    if (number != 0) {
-        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-        chunks = number / chunkSize;
-        for (i = 0; i < chunks; ++i)
-            if (fread(valBuffer + i * chunkSize, chunkSize * sizeof(double), 1,
-                      val_file) != 1 )
-                fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
-        remain = number % chunkSize;
-        if (remain != 0)
-            if (fread(valBuffer + chunks * chunkSize, remain * sizeof(double), 1,
-                      val_file) != 1)
-                fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
-    }
     nVT = tapeInfos->stats[NUM_VALUES] - number;
+    if (number != 0 && !readTapeStream(tapeInfos, val_file, VALUES_TAPE,
+                nVT * sizeof(double), valBuffer, number * sizeof(double)))
+        fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
     currVal = valBuffer + number;
     np = tapeInfos->stats[NUM_PARAM];
     ip = np;
@@ -1425,18 +2527,10 @@ static void read_params(TapeInfos* tapeInfos) {
             tapeInfos->pTapeInfos.paramstore[--ip] = *--currVal;
         if (ip > 0) {
             number = tapeInfos->stats[VAL_BUFFER_SIZE];
-            fseek(val_file, sizeof(double)*(nVT - number), SEEK_SET);
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(valBuffer + i * chunkSize, chunkSize * sizeof(double), 1,
-                          val_file) != 1 )
-                    fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(valBuffer + chunks * chunkSize, remain * sizeof(double), 1,
-                          val_file) != 1)
-                    fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
+            if (!readTapeStream(tapeInfos, val_file, VALUES_TAPE,
+                        (nVT - number) * sizeof(double), valBuffer,
+                        number * sizeof(double)))
+                fail(ADOLC_VALUE_TAPE_FREAD_FAILED);
             nVT -= number;
             currVal = lastValP1;
         }
@@ -1484,6 +2578,7 @@ void read_tape_stats(TapeInfos *tapeInfos) {
     FILE *loc_file;
     int tapeVersion, limitVersion;
     ADOLC_ID tape_ADOLC_ID;
+    TapeContainerHeader header;
 
     if (tapeInfos->inUse != 0 && tapeInfos->tapingComplete == 0) return;
 
@@ -1491,12 +2586,26 @@ void read_tape_stats(TapeInfos *tapeInfos) {
             10 * ADOLC_NEW_TAPE_SUBVERSION +
             1  * ADOLC_NEW_TAPE_PATCHLEVEL ;
 
-    if ((loc_file = fopen(tapeInfos->pTapeInfos.loc_fileName, "rb")) == NULL)
-        fail(ADOLC_INTEGER_TAPE_FOPEN_FAILED);
-    if (fread(&tape_ADOLC_ID, sizeof(ADOLC_ID), 1, loc_file) != 1)
-        fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
-    if (fread(tapeInfos->stats, STAT_SIZE * sizeof(size_t), 1, loc_file) != 1)
-        fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+    if ((loc_file = fopen(tapeInfos->pTapeInfos.container_fileName, "rb"))
+            != NULL) {
+        /* single file container */
+        if (!readContainerHeader(loc_file, &header))
+            fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+        tape_ADOLC_ID = header.id;
+        memcpy(tapeInfos->stats, header.stats,
+               TAPE_STAT_SIZE * sizeof(size_t));
+        tapeInfos->containerTape = 1;
+    } else {
+        if ((loc_file = fopen(tapeInfos->pTapeInfos.loc_fileName, "rb"))
+                == NULL)
+            fail(ADOLC_INTEGER_TAPE_FOPEN_FAILED);
+        if (fread(&tape_ADOLC_ID, sizeof(ADOLC_ID), 1, loc_file) != 1)
+            fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+        if (fread(tapeInfos->stats, TAPE_STAT_SIZE * sizeof(size_t), 1,
+                  loc_file) != 1)
+            fail(ADOLC_INTEGER_TAPE_FREAD_FAILED);
+        tapeInfos->containerTape = 0;
+    }
 
     failAdditionalInfo1 = tapeInfos->tapeID;
     tapeVersion = 100 * tape_ADOLC_ID.adolc_ver +
@@ -1517,6 +2626,8 @@ void read_tape_stats(TapeInfos *tapeInfos) {
         fail(ADOLC_WRONG_LOCINT_SIZE);
     }
 
+    if (tapeInfos->containerTape)
+        readBlockIndex(tapeInfos, loc_file, &header);
     fclose(loc_file);
     tapeInfos->tapingComplete = 1;
     if (tapeInfos->stats[NUM_PARAM] > 0)
@@ -1528,261 +2639,1059 @@ void skip_tracefile_cleanup(short tnum) {
     tinfo->pTapeInfos.skipFileCleanup = 1;
 }
 
-/****************************************************************************/
-/* Initialize a forward sweep. Get stats, open tapes, fill buffers, ...     */
-/****************************************************************************/
-void init_for_sweep(short tag) {
-    int i = 0, chunks, numLocsForStats;
-    size_t number, remain, chunkSize;
-    ADOLC_OPENMP_THREAD_NUMBER;
-    ADOLC_OPENMP_GET_THREAD_NUMBER;
-
-    /* mark possible (hard disk) tape creation */
-    markNewTape();
+void set_tape_mmap(short tnum, int flag) {
+    TapeInfos *tinfo = getTapeInfos(tnum);
+    tinfo->pTapeInfos.mmapTape = (flag != 0) ? 1 : -1;
+}
 
-    /* make room for tapeInfos and read tape stats if necessary, keep value
-     * stack information */
-    openTape(tag, ADOLC_FORWARD);
-    initTapeBuffers();
+void set_tape_decoding(short tnum, int flag) {
+    TapeInfos *tinfo = getTapeInfos(tnum);
+    tinfo->pTapeInfos.decodeTape = (flag != 0) ? 1 : -1;
+}
 
-    /* init operations */
-    number = 0;
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.op_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "rb");
-        /* how much to read ? */
-        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
-                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS]);
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
-                            chunkSize * sizeof(unsigned char), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
-                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks *
-                            chunkSize, remain * sizeof(unsigned char), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
-                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-        }
-        /* how much remains ? */
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] - number;
-    }
-    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape = number;
-    ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+/****************************************************************************/
+/****************************************************************************/
+/* PERSISTENT TAPE STORE                                                    */
+/****************************************************************************/
+/****************************************************************************/
 
-    /* init locations */
-    number = 0;
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.loc_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "rb");
-        /* how much to read ? */
-        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
-                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS]);
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
-                            chunkSize * sizeof(locint), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
-                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-            if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
-                        remain * sizeof(locint), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
-                fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
-        }
-        /* how much remains ? */
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] - number;
+/* save_tape copies the files of a complete tape into a single store file,  */
+/* load_tape copies them back to the tape files of a (possibly different)   */
+/* tag in a later run. The store starts with a header holding its version,  */
+/* the ADOLC_ID of the library that wrote it, the tape stats, the sizes of  */
+/* the files and a FNV-1a hash over the header and the files. A store is    */
+/* only loaded by a library with the same pointer, locint and revreal size  */
+/* that accepts the tape version, and only if the hash matches.             */
+#define ADOLC_TAPE_STORE_VERSION 1
+#define ADOLC_STORE_CHUNK_SIZE 1048576
+
+typedef struct TapeStoreHeader {
+    char magic[8];
+    unsigned int version;
+    ADOLC_ID id;
+    size_t stats[TAPE_STAT_SIZE];
+    size_t fileSize[3];            /* op, loc, val file or the container */
+    unsigned long long hash;       /* computed with hash == 0 */
+    char containerTape;
+} TapeStoreHeader;
+
+static const char storeMagic[8] = "ADOLCTS";
+
+unsigned long long hashBytes(unsigned long long hash, const void *data,
+                             size_t size) {
+    const unsigned char *p = (const unsigned char *)data;
+    while (size-- > 0) {
+        hash ^= *p++;
+        hash *= 1099511628211ULL;
     }
-    ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape = number;
+    return hash;
+}
 
-    /* skip stats */
-    numLocsForStats = statSpace;
-    while (numLocsForStats >= ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE])
-    {
-        get_loc_block_f();
-        numLocsForStats -= ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+/* names of the files of a tape in the order they are stored */
+static int tapeStoreFiles(const TapeInfos *tapeInfos, const char **names) {
+    if (tapeInfos->containerTape) {
+        names[0] = tapeInfos->pTapeInfos.container_fileName;
+        return 1;
     }
-    ADOLC_CURRENT_TAPE_INFOS.currLoc =
-        ADOLC_CURRENT_TAPE_INFOS.locBuffer + numLocsForStats;
+    names[0] = tapeInfos->pTapeInfos.op_fileName;
+    names[1] = tapeInfos->pTapeInfos.loc_fileName;
+    names[2] = tapeInfos->pTapeInfos.val_fileName;
+    return 3;
+}
 
-    /* init constants */
-    number = 0;
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.val_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "rb");
-        /* how much to read ? */
-        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
-                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES]);
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
-                            chunkSize * sizeof(double), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
-                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks *
-                            chunkSize, remain * sizeof(double), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
-                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+/* copies "size" bytes from "from" to "to" (if not NULL) and adds them to
+ * "hash", returns 1 on success */
+static int copyStoreData(FILE *from, FILE *to, size_t size,
+                         unsigned long long *hash) {
+    size_t number;
+    char *chunk = (char *)malloc(ADOLC_STORE_CHUNK_SIZE);
+
+    if (chunk == NULL) fail(ADOLC_MALLOC_FAILED);
+    while (size > 0) {
+        number = MIN_ADOLC(size, ADOLC_STORE_CHUNK_SIZE);
+        if (fread(chunk, number, 1, from) != 1 ||
+                (to != NULL && fwrite(chunk, number, 1, to) != 1)) {
+            free(chunk);
+            return 0;
         }
-        /* how much remains ? */
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] - number;
+        *hash = hashBytes(*hash, chunk, number);
+        size -= number;
     }
-    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape = number;
-    ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
-#ifdef ADOLC_AMPI_SUPPORT
-    TAPE_AMPI_resetBottom();
-#endif
+    free(chunk);
+    return 1;
 }
 
 /****************************************************************************/
-/* Initialize a reverse sweep. Get stats, open tapes, fill buffers, ...     */
+/* Saves the tape "tag" to the store file "path", streams of the tape that  */
+/* are kept in core are written to the tape files before.                   */
 /****************************************************************************/
-void init_rev_sweep(short tag) {
-    int i, chunks;
-    size_t number, remain, chunkSize;
+int save_tape(short tag, const char *path) {
+    TapeInfos *tapeInfos;
+    TapeStoreHeader header;
+    const char *names[3];
+    FILE *store, *file;
+    unsigned long long hash;
+    int i, numFiles, ok = 1;
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
-    /* mark possible (hard disk) tape creation */
-    markNewTape();
-
-    /* make room for tapeInfos and read tape stats if necessary, keep value
-     * stack information */
-    openTape(tag, ADOLC_REVERSE);
-    initTapeBuffers();
-
-    /* init operations */
-    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS];
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.op_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "rb");
-        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] /
-                ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE]) *
-                ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
-        fseek(ADOLC_CURRENT_TAPE_INFOS.op_file,
-                number * sizeof(unsigned char), SEEK_SET);
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] %
-                ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] ;
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
-                            chunkSize * sizeof(unsigned char), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
-                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks *
-                            chunkSize, remain * sizeof(unsigned char), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
-                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+    tapeInfos = getTapeInfos(tag);
+    if (tapeInfos->inUse != 0 && tapeInfos->tapingComplete == 0) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Tape %d is being recorded and "
+                "cannot be saved!\n", tag);
+        return -1;
+    }
+    if (tapeInfos->sharedTape != NULL) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Tape %d is shared with the serial "
+                "part and cannot be saved in a parallel region!\n", tag);
+        return -1;
+    }
+    if (tapeInfos->stats[OP_FILE_ACCESS] == 0 ||
+            tapeInfos->stats[LOC_FILE_ACCESS] == 0 ||
+            tapeInfos->stats[VAL_FILE_ACCESS] == 0) {
+        if (ADOLC_GLOBAL_TAPE_VARS.currentTapeInfosPtr != NULL) {
+            fprintf(DIAG_OUT, "ADOL-C warning: Tape %d is kept in core and "
+                    "cannot be saved while a tape is active!\n", tag);
+            return -1;
         }
+        write_tape_files(tapeInfos);
     }
-    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape =
-        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] - number;
-    ADOLC_CURRENT_TAPE_INFOS.currOp =
-        ADOLC_CURRENT_TAPE_INFOS.opBuffer + number;
 
-    /* init locations */
-    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS];
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.loc_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "rb");
-        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] /
-                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE]) *
-                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
-        fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file,
-                number * sizeof(locint), SEEK_SET);
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] %
-                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
-                            chunkSize * sizeof(locint), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
-                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks *
-                            chunkSize, remain * sizeof(locint), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
-                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    memset(&header, 0, sizeof(TapeStoreHeader));
+    memcpy(header.magic, storeMagic, sizeof(storeMagic));
+    header.version = ADOLC_TAPE_STORE_VERSION;
+    header.id = adolc_id;
+    memcpy(header.stats, tapeInfos->stats, TAPE_STAT_SIZE * sizeof(size_t));
+    header.containerTape = tapeInfos->containerTape;
+    numFiles = tapeStoreFiles(tapeInfos, names);
+    for (i = 0; i < numFiles; ++i)
+        if ((file = fopen(names[i], "rb")) != NULL) {
+            fseek(file, 0, SEEK_END);
+            header.fileSize[i] = ftell(file);
+            fclose(file);
         }
-    }
-    ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape =
-        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] - number;
-    ADOLC_CURRENT_TAPE_INFOS.currLoc =
-        ADOLC_CURRENT_TAPE_INFOS.locBuffer + number;
 
-    /* init constants */
-    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES];
-    if (ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 1) {
-        ADOLC_CURRENT_TAPE_INFOS.val_file =
-            fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "rb");
-        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] /
-                ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE]) *
-                ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
-        fseek(ADOLC_CURRENT_TAPE_INFOS.val_file,
-                number * sizeof(double), SEEK_SET);
-        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] %
-                ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
-        if (number != 0) {
-            chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-            chunks = number / chunkSize;
-            for (i = 0; i < chunks; ++i)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
-                            chunkSize * sizeof(double), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
-                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
-            remain = number % chunkSize;
-            if (remain != 0)
-                if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks *
-                            chunkSize, remain * sizeof(double), 1,
-                            ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
-                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    if ((store = fopen(path, "wb")) == NULL) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to create tape store "
+                "%s!\n", path);
+        return -1;
+    }
+    hash = hashBytes(ADOLC_HASH_INIT, &header, sizeof(TapeStoreHeader));
+    ok = fwrite(&header, sizeof(TapeStoreHeader), 1, store) == 1;
+    for (i = 0; i < numFiles && ok; ++i) {
+        if (header.fileSize[i] == 0) continue;
+        if ((file = fopen(names[i], "rb")) == NULL) {
+            ok = 0;
+            break;
         }
+        ok = copyStoreData(file, store, header.fileSize[i], &hash);
+        fclose(file);
     }
-    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape =
-        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] - number;
-    ADOLC_CURRENT_TAPE_INFOS.currVal =
-        ADOLC_CURRENT_TAPE_INFOS.valBuffer + number;
-#ifdef ADOLC_AMPI_SUPPORT
-    TAPE_AMPI_resetTop();
-#endif
+    header.hash = hash;
+    if (ok) {
+        fseek(store, 0, SEEK_SET);
+        ok = fwrite(&header, sizeof(TapeStoreHeader), 1, store) == 1;
+    }
+    if (fclose(store) != 0) ok = 0;
+    if (!ok) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to write tape store "
+                "%s!\n", path);
+        remove(path);
+        return -1;
+    }
+    return 0;
 }
 
 /****************************************************************************/
-/* Finish a forward or reverse sweep.                                       */
+/* Restores tape "tag" from the store file "path" written by save_tape.     */
+/* Returns 0 on success, -1 if the store cannot be read or the tape is in   */
+/* use, -2 if the store is incompatible with this library and -3 if its    */
+/* content does not match the hash. The store is checked completely before */
+/* the tape files are replaced.                                             */
 /****************************************************************************/
-void end_sweep() {
-    ADOLC_OPENMP_THREAD_NUMBER;
+int load_tape(short tag, const char *path) {
+    TapeStoreHeader header;
+    const char *names[3];
+    FILE *store, *file;
+    unsigned long long hash, storedHash;
+    size_t total = 0;
+    int i, numFiles, ok = 1, tapeVersion, limitVersion;
+
+    if ((store = fopen(path, "rb")) == NULL) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to open tape store %s!\n",
+                path);
+        return -1;
+    }
+    if (fread(&header, sizeof(TapeStoreHeader), 1, store) != 1 ||
+            memcmp(header.magic, storeMagic, sizeof(storeMagic)) != 0) {
+        fprintf(DIAG_OUT, "ADOL-C warning: %s is not a tape store!\n", path);
+        fclose(store);
+        return -1;
+    }
+    limitVersion = 100 * ADOLC_NEW_TAPE_VERSION    +
+            10 * ADOLC_NEW_TAPE_SUBVERSION +
+            1  * ADOLC_NEW_TAPE_PATCHLEVEL ;
+    tapeVersion = 100 * header.id.adolc_ver +
+            10 * header.id.adolc_sub +
+            1  * header.id.adolc_lvl ;
+    if (header.version != ADOLC_TAPE_STORE_VERSION ||
+            tapeVersion < limitVersion ||
+            header.id.address_size != adolc_id.address_size ||
+            header.id.locint_size != adolc_id.locint_size ||
+            header.id.revreal_size != adolc_id.revreal_size) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Tape store %s (format %u, ADOL-C "
+                "%d.%d.%d, sizes %d/%d/%d) is incompatible with this library "
+                "(format %u, sizes %d/%d/%d of pointer/locint/revreal)!\n",
+                path, header.version, header.id.adolc_ver,
+                header.id.adolc_sub, header.id.adolc_lvl,
+                header.id.address_size, header.id.locint_size,
+                header.id.revreal_size, ADOLC_TAPE_STORE_VERSION,
+                adolc_id.address_size, adolc_id.locint_size,
+                adolc_id.revreal_size);
+        fclose(store);
+        return -2;
+    }
+
+    /* verify the content before anything is replaced */
+    storedHash = header.hash;
+    header.hash = 0;
+    hash = hashBytes(ADOLC_HASH_INIT, &header, sizeof(TapeStoreHeader));
+    numFiles = header.containerTape ? 1 : 3;
+    for (i = 0; i < numFiles; ++i) total += header.fileSize[i];
+    if (!copyStoreData(store, NULL, total, &hash) || hash != storedHash) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Tape store %s is corrupted!\n",
+                path);
+        fclose(store);
+        return -3;
+    }
+
+    if (removeTape(tag, ADOLC_REMOVE_COMPLETELY) != 0) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Tape %d is being recorded and "
+                "cannot be loaded!\n", tag);
+        fclose(store);
+        return -1;
+    }
+    if (header.containerTape)
+        names[0] = createFileName(tag, CONTAINER_TAPE);
+    else {
+        names[0] = createFileName(tag, OPERATIONS_TAPE);
+        names[1] = createFileName(tag, LOCATIONS_TAPE);
+        names[2] = createFileName(tag, VALUES_TAPE);
+    }
+    fseek(store, sizeof(TapeStoreHeader), SEEK_SET);
+    hash = ADOLC_HASH_INIT;
+    for (i = 0; i < numFiles; ++i) {
+        if (ok && header.fileSize[i] != 0) {
+            if ((file = fopen(names[i], "wb")) == NULL) ok = 0;
+            else {
+                ok = copyStoreData(store, file, header.fileSize[i], &hash);
+                if (fclose(file) != 0) ok = 0;
+            }
+        }
+        if (!ok) remove(names[i]);
+    }
+    for (i = 0; i < numFiles; ++i) free((char *)names[i]);
+    fclose(store);
+    if (!ok) {
+        fprintf(DIAG_OUT, "ADOL-C warning: Unable to write the files of tape "
+                "%d!\n", tag);
+        return -1;
+    }
+
+    /* register the tape as if it was written by this run */
+    getTapeInfos(tag);
+    return 0;
+}
+
+/****************************************************************************/
+/* Memory mapped tape files. If enabled, the disk based op/loc/val files    */
+/* are mapped read-only for the duration of a sweep. Instead of copying     */
+/* every block with fread, the buffer pointers are moved block by block     */
+/* through the mapped file, such that block boundaries, end_of_* markers    */
+/* and remainder counts are handled exactly as for buffered reading.        */
+/****************************************************************************/
+#if defined(ADOLC_HAVE_MMAP)
+static int useTapeMmap() {
+    ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
-    if (ADOLC_CURRENT_TAPE_INFOS.op_file != NULL) {
-        fclose(ADOLC_CURRENT_TAPE_INFOS.op_file);
-        ADOLC_CURRENT_TAPE_INFOS.op_file = NULL;
+    /* blocks of a container are not aligned to their elements */
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) return 0;
+    if (ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.mmapTape != 0)
+        return ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.mmapTape > 0;
+    return ADOLC_GLOBAL_TAPE_VARS.mmapTapes;
+}
+
+/* maps a complete tape file read-only, returns NULL if this is not possible
+ * or the file is shorter than expected */
+static void *mapTapeFile(const char *fileName, size_t expected,
+                         size_t *size, char mode) {
+    int fd;
+    struct stat st;
+    void *map;
+
+    if ((fd = open(fileName, O_RDONLY)) == -1) return NULL;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 ||
+            (size_t)st.st_size < expected) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+    /* forward sweeps stream through the file, reverse sweeps walk it
+     * backwards block by block and ask for each block in advance */
+    madvise(map, st.st_size,
+            mode == ADOLC_FORWARD ? MADV_SEQUENTIAL : MADV_RANDOM);
+    *size = st.st_size;
+    return map;
+}
+#endif
+
+/* reverse sweeps: ask for the block preceding element "first" of a mapping */
+static void advisePrevBlock(void *map, size_t first, size_t blockSize,
+                            size_t elemSize) {
+#if defined(ADOLC_HAVE_MMAP)
+    size_t from, pageSize = sysconf(_SC_PAGESIZE);
+    if (first == 0) return;
+    from = (first > blockSize) ? (first - blockSize) * elemSize : 0;
+    from -= from % pageSize;
+    madvise((char *)map + from, first * elemSize - from, MADV_WILLNEED);
+#endif
+}
+
+static int mapOpTape(char mode) {
+#if defined(ADOLC_HAVE_MMAP)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!useTapeMmap()) return 0;
+    ADOLC_CURRENT_TAPE_INFOS.opMap = (unsigned char *)
+        mapTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName,
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] *
+                sizeof(unsigned char),
+                &ADOLC_CURRENT_TAPE_INFOS.opMapSize, mode);
+    if (ADOLC_CURRENT_TAPE_INFOS.opMap == NULL) return 0;
+    ADOLC_CURRENT_TAPE_INFOS.opBufferSave = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static int mapLocTape(char mode) {
+#if defined(ADOLC_HAVE_MMAP)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!useTapeMmap() || ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] !=
+            ADOLC_LOC_PLAIN)
+        return 0;
+    ADOLC_CURRENT_TAPE_INFOS.locMap = (locint *)
+        mapTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName,
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] *
+                sizeof(locint),
+                &ADOLC_CURRENT_TAPE_INFOS.locMapSize, mode);
+    if (ADOLC_CURRENT_TAPE_INFOS.locMap == NULL) return 0;
+    ADOLC_CURRENT_TAPE_INFOS.locBufferSave = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static int mapValTape(char mode) {
+#if defined(ADOLC_HAVE_MMAP)
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!useTapeMmap()) return 0;
+    ADOLC_CURRENT_TAPE_INFOS.valMap = (double *)
+        mapTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName,
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] * sizeof(double),
+                &ADOLC_CURRENT_TAPE_INFOS.valMapSize, mode);
+    if (ADOLC_CURRENT_TAPE_INFOS.valMap == NULL) return 0;
+    ADOLC_CURRENT_TAPE_INFOS.valBufferSave = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/* let the buffers point to the block starting at element "first" */
+static void setOpWindow(size_t first) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    ADOLC_CURRENT_TAPE_INFOS.opBuffer = ADOLC_CURRENT_TAPE_INFOS.opMap + first;
+    ADOLC_CURRENT_TAPE_INFOS.lastOpP1 = ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+        ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+}
+
+static void setLocWindow(size_t first) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    ADOLC_CURRENT_TAPE_INFOS.locBuffer = ADOLC_CURRENT_TAPE_INFOS.locMap + first;
+    ADOLC_CURRENT_TAPE_INFOS.lastLocP1 = ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+        ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+}
+
+static void setValWindow(size_t first) {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    ADOLC_CURRENT_TAPE_INFOS.valBuffer = ADOLC_CURRENT_TAPE_INFOS.valMap + first;
+    ADOLC_CURRENT_TAPE_INFOS.lastValP1 = ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+        ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+}
+
+static void readLocFrame(char mode, size_t expected);
+
+/* file position of "size" bytes at "*offset" of a stream, for containers
+ * only if they are part of one block, returns 0 otherwise */
+static int tapeFileOffset(int stream, size_t *offset, size_t size) {
+    const TapeBlock *block;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (!ADOLC_CURRENT_TAPE_INFOS.containerTape) return 1;
+    block = findTapeBlock(&ADOLC_CURRENT_TAPE_INFOS, stream, *offset);
+    if (block == NULL ||
+            *offset + size > block->streamOffset + block->size)
+        return 0;
+    *offset = block->fileOffset + *offset - block->streamOffset;
+    return 1;
+}
+
+/* Read-ahead (IOBUFNUM > 1) for files that are read with stdio: queue the
+ * block following (forward) or preceding (reverse) the current one. Blocks
+ * not stored contiguously in a container are read when needed. */
+static void prefetchOpBlock(char mode) {
+    size_t number, first, offset;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!asyncTapeIO() || ADOLC_CURRENT_TAPE_INFOS.op_file == NULL ||
+            ADOLC_CURRENT_TAPE_INFOS.numOps_Tape == 0)
+        return;
+    if (mode == ADOLC_FORWARD) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numOps_Tape);
+        first = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] -
+            ADOLC_CURRENT_TAPE_INFOS.numOps_Tape;
+    } else {
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+        first = ADOLC_CURRENT_TAPE_INFOS.numOps_Tape - number;
+    }
+    offset = first * sizeof(unsigned char);
+    if (!tapeFileOffset(OPERATIONS_TAPE, &offset, number * sizeof(unsigned char))) {
+        dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.opReader);
+        return;
+    }
+    prefetchTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.opReader,
+            ADOLC_CURRENT_TAPE_INFOS.op_file, offset, number * sizeof(unsigned char),
+            ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] * sizeof(unsigned char));
+}
+
+static void prefetchLocBlock(char mode) {
+    size_t number, first, offset;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!asyncTapeIO() || ADOLC_CURRENT_TAPE_INFOS.loc_file == NULL ||
+            ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape == 0 ||
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] != ADOLC_LOC_PLAIN)
+        return;
+    if (mode == ADOLC_FORWARD) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape);
+        first = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] -
+            ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape;
+    } else {
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+        first = ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape - number;
+    }
+    offset = first * sizeof(locint);
+    if (!tapeFileOffset(LOCATIONS_TAPE, &offset, number * sizeof(locint))) {
+        dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.locReader);
+        return;
+    }
+    prefetchTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.locReader,
+            ADOLC_CURRENT_TAPE_INFOS.loc_file, offset, number * sizeof(locint),
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] * sizeof(locint));
+}
+
+static void prefetchValBlock(char mode) {
+    size_t number, first, offset;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    if (!asyncTapeIO() || ADOLC_CURRENT_TAPE_INFOS.val_file == NULL ||
+            ADOLC_CURRENT_TAPE_INFOS.numVals_Tape == 0)
+        return;
+    if (mode == ADOLC_FORWARD) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
+        first = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] -
+            ADOLC_CURRENT_TAPE_INFOS.numVals_Tape;
+    } else {
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+        first = ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number;
+    }
+    offset = first * sizeof(double);
+    if (!tapeFileOffset(VALUES_TAPE, &offset, number * sizeof(double))) {
+        dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.valReader);
+        return;
+    }
+    prefetchTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.valReader,
+            ADOLC_CURRENT_TAPE_INFOS.val_file, offset, number * sizeof(double),
+            ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] * sizeof(double));
+}
+
+/****************************************************************************/
+/* Releases the mappings of a tape and restores the allocated buffers.      */
+/****************************************************************************/
+void unmap_tape_files(TapeInfos *tapeInfos) {
+#if defined(ADOLC_HAVE_MMAP)
+    if (tapeInfos->opMap != NULL) {
+        munmap(tapeInfos->opMap, tapeInfos->opMapSize);
+        tapeInfos->opMap = NULL;
+        tapeInfos->opBuffer = tapeInfos->opBufferSave;
+        tapeInfos->opBufferSave = NULL;
+        tapeInfos->currOp = tapeInfos->opBuffer;
+        tapeInfos->lastOpP1 = tapeInfos->opBuffer +
+            tapeInfos->stats[OP_BUFFER_SIZE];
+    }
+    if (tapeInfos->locMap != NULL) {
+        munmap(tapeInfos->locMap, tapeInfos->locMapSize);
+        tapeInfos->locMap = NULL;
+        tapeInfos->locBuffer = tapeInfos->locBufferSave;
+        tapeInfos->locBufferSave = NULL;
+        tapeInfos->currLoc = tapeInfos->locBuffer;
+        tapeInfos->lastLocP1 = tapeInfos->locBuffer +
+            tapeInfos->stats[LOC_BUFFER_SIZE];
+    }
+    if (tapeInfos->valMap != NULL) {
+        munmap(tapeInfos->valMap, tapeInfos->valMapSize);
+        tapeInfos->valMap = NULL;
+        tapeInfos->valBuffer = tapeInfos->valBufferSave;
+        tapeInfos->valBufferSave = NULL;
+        tapeInfos->currVal = tapeInfos->valBuffer;
+        tapeInfos->lastValP1 = tapeInfos->valBuffer +
+            tapeInfos->stats[VAL_BUFFER_SIZE];
+    }
+#endif
+}
+
+/****************************************************************************/
+/****************************************************************************/
+/* IN-CORE TAPE CACHE                                                       */
+/****************************************************************************/
+/****************************************************************************/
+
+/* Tapes that fit into their buffers stay in core after taping. With a     */
+/* budget (TAPECACHESIZE, set_tape_cache_size) the least recently used of  */
+/* them are moved to disk whenever no tape is active, and a sweep over     */
+/* such a tape reads it completely back into its buffers, such that it is  */
+/* in core again. The files of an evicted tape stay valid until it is      */
+/* retaped, a second eviction only releases the buffers. Views sharing the */
+/* buffers of a serial tape (see openTape) are no part of the cache.       */
+
+size_t in_core_tape_size(const TapeInfos *tapeInfos) {
+    if (tapeInfos->inUse == 0 || tapeInfos->tapingComplete == 0 ||
+            tapeInfos->sharedTape != NULL ||
+            tapeInfos->stats[OP_FILE_ACCESS] != 0 ||
+            tapeInfos->stats[LOC_FILE_ACCESS] != 0 ||
+            tapeInfos->stats[VAL_FILE_ACCESS] != 0 ||
+            tapeInfos->opBuffer == NULL || tapeInfos->locBuffer == NULL ||
+            tapeInfos->valBuffer == NULL)
+        return 0;
+    return tapeInfos->stats[OP_BUFFER_SIZE] * sizeof(unsigned char) +
+        tapeInfos->stats[LOC_BUFFER_SIZE] * sizeof(locint) +
+        tapeInfos->stats[VAL_BUFFER_SIZE] * sizeof(double);
+}
+
+/****************************************************************************/
+/* Writes the in-core streams of the current tape to disk and releases its  */
+/* buffers. Only tapes that were completely in core are reloaded later.     */
+/****************************************************************************/
+void evict_tape() {
+    char inCore;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    inCore = in_core_tape_size(&ADOLC_CURRENT_TAPE_INFOS) != 0;
+    free_decoded_tape(&ADOLC_CURRENT_TAPE_INFOS);
+    if (ADOLC_CURRENT_TAPE_INFOS.cacheOnDisk) {
+        free(ADOLC_CURRENT_TAPE_INFOS.opBuffer);
+        ADOLC_CURRENT_TAPE_INFOS.opBuffer = NULL;
+        free(ADOLC_CURRENT_TAPE_INFOS.locBuffer);
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer = NULL;
+        free(ADOLC_CURRENT_TAPE_INFOS.valBuffer);
+        ADOLC_CURRENT_TAPE_INFOS.valBuffer = NULL;
+        ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] = 1;
+        ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] = 1;
+        ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] = 1;
+    } else {
+        /* as at the end of taping, close_tape writes the buffers of the
+         * streams still in core, those on disk are complete already */
+        ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+        ADOLC_CURRENT_TAPE_INFOS.numOps_Tape =
+            ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS];
+        if (ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] == 0) {
+            ADOLC_CURRENT_TAPE_INFOS.currOp += ADOLC_CURRENT_TAPE_INFOS.numOps_Tape;
+            ADOLC_CURRENT_TAPE_INFOS.numOps_Tape = 0;
+        }
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape =
+            ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS];
+        if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] == 0) {
+            ADOLC_CURRENT_TAPE_INFOS.currLoc += ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape;
+            ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape = 0;
+        } else {
+            /* close_tape updates the stats in front of the locations */
+            ADOLC_CURRENT_TAPE_INFOS.loc_file =
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName,
+                               "r+b");
+            if (ADOLC_CURRENT_TAPE_INFOS.loc_file == NULL)
+                fail(ADOLC_INTEGER_TAPE_FOPEN_FAILED);
+        }
+        ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
+        ADOLC_CURRENT_TAPE_INFOS.numVals_Tape =
+            ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES];
+        if (ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 0) {
+            ADOLC_CURRENT_TAPE_INFOS.currVal += ADOLC_CURRENT_TAPE_INFOS.numVals_Tape;
+            ADOLC_CURRENT_TAPE_INFOS.numVals_Tape = 0;
+        }
+        close_tape(1);
+        ADOLC_CURRENT_TAPE_INFOS.cacheOnDisk = 1;
+    }
+    free(ADOLC_CURRENT_TAPE_INFOS.locFrame);
+    ADOLC_CURRENT_TAPE_INFOS.locFrame = NULL;
+    finish_tape_io(&ADOLC_CURRENT_TAPE_INFOS);
+    ADOLC_CURRENT_TAPE_INFOS.cacheEvicted = inCore;
+}
+
+/****************************************************************************/
+/* Counts the sweep over the current tape for the tape cache and reads an   */
+/* evicted tape back into the (allocated) buffers if it fits the budget.    */
+/****************************************************************************/
+static void reloadCachedTape() {
+    size_t numOps, numLocs, numVals, size;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    if (!ADOLC_CURRENT_TAPE_INFOS.cacheEvicted) {
+        if (in_core_tape_size(&ADOLC_CURRENT_TAPE_INFOS) != 0)
+            ++ADOLC_GLOBAL_TAPE_VARS.tapeCacheHits;
+        return;
+    }
+    ++ADOLC_GLOBAL_TAPE_VARS.tapeCacheMisses;
+    size = ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] *
+        sizeof(unsigned char) +
+        ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] * sizeof(locint) +
+        ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] * sizeof(double);
+    if (ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize != 0 &&
+            size > ADOLC_GLOBAL_TAPE_VARS.tapeCacheSize)
+        return;
+
+    numOps = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS];
+    numLocs = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS];
+    numVals = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES];
+    if (numOps != 0) {
+        ADOLC_CURRENT_TAPE_INFOS.op_file =
+            openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName);
+        if (ADOLC_CURRENT_TAPE_INFOS.op_file == NULL ||
+                !readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.op_file, OPERATIONS_TAPE, 0,
+                    ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                    numOps * sizeof(unsigned char)))
+            fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+    }
+    if (numLocs != 0) {
+        ADOLC_CURRENT_TAPE_INFOS.loc_file =
+            openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName);
+        if (ADOLC_CURRENT_TAPE_INFOS.loc_file == NULL)
+            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] ==
+                ADOLC_LOC_DELTA) {
+            ADOLC_CURRENT_TAPE_INFOS.locFramePos = statSpace * sizeof(locint);
+            readLocFrame(ADOLC_FORWARD, numLocs);
+        } else if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE, 0,
+                    ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                    numLocs * sizeof(locint)))
+            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    }
+    if (numVals != 0) {
+        ADOLC_CURRENT_TAPE_INFOS.val_file =
+            openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName);
+        if (ADOLC_CURRENT_TAPE_INFOS.val_file == NULL ||
+                !readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE, 0,
+                    ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                    numVals * sizeof(double)))
+            fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    }
+    close_tape_files(&ADOLC_CURRENT_TAPE_INFOS);
+    free(ADOLC_CURRENT_TAPE_INFOS.locFrame);
+    ADOLC_CURRENT_TAPE_INFOS.locFrame = NULL;
+    ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] = 0;
+    ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] = 0;
+    ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] = 0;
+    ADOLC_CURRENT_TAPE_INFOS.cacheEvicted = 0;
+}
+
+/****************************************************************************/
+/* Initialize a forward sweep. Get stats, open tapes, fill buffers, ...     */
+/****************************************************************************/
+void init_for_sweep(short tag) {
+    int i = 0, chunks, numLocsForStats;
+    size_t number, remain, chunkSize;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    /* mark possible (hard disk) tape creation */
+    markNewTape();
+
+    /* make room for tapeInfos and read tape stats if necessary, keep value
+     * stack information */
+    openTape(tag, ADOLC_FORWARD);
+    initTapeBuffers();
+    reloadCachedTape();
+
+    /* init operations */
+    number = 0;
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] == 1) {
+        /* how much to read ? */
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS]);
+        if (mapOpTape(ADOLC_FORWARD))
+            setOpWindow(0);
+        else {
+            ADOLC_CURRENT_TAPE_INFOS.op_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName);
+            if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.op_file, OPERATIONS_TAPE,
+                            0, ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                            number * sizeof(unsigned char)))
+                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
+                                chunkSize * sizeof(unsigned char), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
+                        fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks *
+                                chunkSize, remain * sizeof(unsigned char), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
+                        fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+            }
+        }
+        /* how much remains ? */
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] - number;
+    }
+    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape = number;
+    ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+    prefetchOpBlock(ADOLC_FORWARD);
+
+    /* init locations */
+    number = 0;
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] == 1) {
+        /* how much to read ? */
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS]);
+        if (mapLocTape(ADOLC_FORWARD))
+            setLocWindow(0);
+        else {
+            ADOLC_CURRENT_TAPE_INFOS.loc_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName);
+            if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] ==
+                    ADOLC_LOC_DELTA) {
+                ADOLC_CURRENT_TAPE_INFOS.locFramePos =
+                    statSpace * sizeof(locint);
+                if (number != 0) readLocFrame(ADOLC_FORWARD, number);
+            } else if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE,
+                            0, ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                            number * sizeof(locint)))
+                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
+                                chunkSize * sizeof(locint), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
+                        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
+                            remain * sizeof(locint), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
+                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+            }
+        }
+        /* how much remains ? */
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] - number;
+    }
+    ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape = number;
+    prefetchLocBlock(ADOLC_FORWARD);
+
+    /* skip stats */
+    numLocsForStats = statSpace;
+    while (numLocsForStats >= ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE])
+    {
+        get_loc_block_f();
+        numLocsForStats -= ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+    }
+    ADOLC_CURRENT_TAPE_INFOS.currLoc =
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer + numLocsForStats;
+
+    /* init constants */
+    number = 0;
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 1) {
+        /* how much to read ? */
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES]);
+        if (mapValTape(ADOLC_FORWARD))
+            setValWindow(0);
+        else {
+            ADOLC_CURRENT_TAPE_INFOS.val_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName);
+            if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE,
+                            0, ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                            number * sizeof(double)))
+                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
+                                chunkSize * sizeof(double), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
+                        fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks *
+                                chunkSize, remain * sizeof(double), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
+                        fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+            }
+        }
+        /* how much remains ? */
+        number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] - number;
+    }
+    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape = number;
+    ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
+    prefetchValBlock(ADOLC_FORWARD);
+#ifdef ADOLC_AMPI_SUPPORT
+    TAPE_AMPI_resetBottom();
+#endif
+}
+
+/****************************************************************************/
+/* Initialize a reverse sweep. Get stats, open tapes, fill buffers, ...     */
+/****************************************************************************/
+void init_rev_sweep(short tag) {
+    int i, chunks;
+    size_t number, first, remain, chunkSize;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    /* mark possible (hard disk) tape creation */
+    markNewTape();
+
+    /* make room for tapeInfos and read tape stats if necessary, keep value
+     * stack information */
+    openTape(tag, ADOLC_REVERSE);
+    initTapeBuffers();
+    reloadCachedTape();
+
+    /* init operations */
+    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS];
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[OP_FILE_ACCESS] == 1) {
+        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] /
+                ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE]) *
+                ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+        if (mapOpTape(ADOLC_REVERSE)) {
+            setOpWindow(number);
+            advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.opMap, number,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
+                    sizeof(unsigned char));
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] ;
+        } else {
+            ADOLC_CURRENT_TAPE_INFOS.op_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName);
+            fseek(ADOLC_CURRENT_TAPE_INFOS.op_file,
+                    number * sizeof(unsigned char), SEEK_SET);
+            first = number;
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] ;
+            if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.op_file, OPERATIONS_TAPE,
+                            first * sizeof(unsigned char),
+                            ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                            number * sizeof(unsigned char)))
+                    fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
+                                chunkSize * sizeof(unsigned char), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
+                        fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks *
+                                chunkSize, remain * sizeof(unsigned char), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.op_file) != 1 )
+                        fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+            }
+        }
     }
-    if (ADOLC_CURRENT_TAPE_INFOS.loc_file != NULL) {
-        fclose(ADOLC_CURRENT_TAPE_INFOS.loc_file);
-        ADOLC_CURRENT_TAPE_INFOS.loc_file = NULL;
+    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape =
+        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] - number;
+    ADOLC_CURRENT_TAPE_INFOS.currOp =
+        ADOLC_CURRENT_TAPE_INFOS.opBuffer + number;
+    prefetchOpBlock(ADOLC_REVERSE);
+
+    /* init locations */
+    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS];
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_ACCESS] == 1) {
+        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] /
+                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE]) *
+                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+        if (mapLocTape(ADOLC_REVERSE)) {
+            setLocWindow(number);
+            advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.locMap, number,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
+                    sizeof(locint));
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+        } else {
+            ADOLC_CURRENT_TAPE_INFOS.loc_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName);
+            if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] ==
+                    ADOLC_LOC_DELTA) {
+                if (ADOLC_CURRENT_TAPE_INFOS.containerTape)
+                    ADOLC_CURRENT_TAPE_INFOS.locFramePos =
+                        containerStreamSize(LOCATIONS_TAPE);
+                else {
+                    fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file, 0, SEEK_END);
+                    ADOLC_CURRENT_TAPE_INFOS.locFramePos =
+                        ftell(ADOLC_CURRENT_TAPE_INFOS.loc_file);
+                }
+            } else
+                fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file,
+                        number * sizeof(locint), SEEK_SET);
+            first = number;
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+            if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT]
+                    == ADOLC_LOC_DELTA) {
+                readLocFrame(ADOLC_REVERSE, number);
+            } else if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE,
+                            first * sizeof(locint),
+                            ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                            number * sizeof(locint)))
+                    fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
+                                chunkSize * sizeof(locint), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
+                        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks *
+                                chunkSize, remain * sizeof(locint), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1 )
+                        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+            }
+        }
     }
-    if (ADOLC_CURRENT_TAPE_INFOS.val_file != NULL) {
-        fclose(ADOLC_CURRENT_TAPE_INFOS.val_file);
-        ADOLC_CURRENT_TAPE_INFOS.val_file = NULL;
+    ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape =
+        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] - number;
+    ADOLC_CURRENT_TAPE_INFOS.currLoc =
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer + number;
+    prefetchLocBlock(ADOLC_REVERSE);
+
+    /* init constants */
+    number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES];
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[VAL_FILE_ACCESS] == 1) {
+        number = (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] /
+                ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE]) *
+                ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+        if (mapValTape(ADOLC_REVERSE)) {
+            setValWindow(number);
+            advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.valMap, number,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
+                    sizeof(double));
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+        } else {
+            ADOLC_CURRENT_TAPE_INFOS.val_file =
+                openTapeFile(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName);
+            fseek(ADOLC_CURRENT_TAPE_INFOS.val_file,
+                    number * sizeof(double), SEEK_SET);
+            first = number;
+            number = ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] %
+                    ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+            if (number != 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+                if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                            ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE,
+                            first * sizeof(double),
+                            ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                            number * sizeof(double)))
+                    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+            } else if (number != 0) {
+                chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
+                chunks = number / chunkSize;
+                for (i = 0; i < chunks; ++i)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
+                                chunkSize * sizeof(double), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
+                        fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+                remain = number % chunkSize;
+                if (remain != 0)
+                    if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks *
+                                chunkSize, remain * sizeof(double), 1,
+                                ADOLC_CURRENT_TAPE_INFOS.val_file) != 1 )
+                        fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+            }
+        }
     }
+    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape =
+        ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] - number;
+    ADOLC_CURRENT_TAPE_INFOS.currVal =
+        ADOLC_CURRENT_TAPE_INFOS.valBuffer + number;
+    prefetchValBlock(ADOLC_REVERSE);
+#ifdef ADOLC_AMPI_SUPPORT
+    TAPE_AMPI_resetTop();
+#endif
+}
+
+/****************************************************************************/
+/* Finish a forward or reverse sweep.                                       */
+/****************************************************************************/
+void end_sweep() {
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+    dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.opReader);
+    dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.locReader);
+    dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.valReader);
+    dropTapeReader(&ADOLC_CURRENT_TAPE_INFOS.tayReader);
+    close_tape_files(&ADOLC_CURRENT_TAPE_INFOS);
+    free(ADOLC_CURRENT_TAPE_INFOS.locFrame);
+    ADOLC_CURRENT_TAPE_INFOS.locFrame = NULL;
+    unmap_tape_files(&ADOLC_CURRENT_TAPE_INFOS);
     if (ADOLC_CURRENT_TAPE_INFOS.deg_save > 0) releaseTape(); /* keep value stack */
     else releaseTape(); /* no value stack */
 }
@@ -1854,6 +3763,9 @@ void put_op_block(unsigned char *lastOpP1) {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.op_file == NULL &&
+            ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        createContainer();
     if (ADOLC_CURRENT_TAPE_INFOS.op_file == NULL) {
         ADOLC_CURRENT_TAPE_INFOS.op_file =
             fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "rb");
@@ -1868,29 +3780,43 @@ void put_op_block(unsigned char *lastOpP1) {
                 fprintf(DIAG_OUT, "ADOL-C warning: "
                         "Unable to remove old tapefile\n");
             ADOLC_CURRENT_TAPE_INFOS.op_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "wb");
         } else {
             ADOLC_CURRENT_TAPE_INFOS.op_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.op_fileName, "wb");
         }
     }
 
     number = lastOpP1 - ADOLC_CURRENT_TAPE_INFOS.opBuffer;
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.opBuffer +
-                        i * chunkSize, chunkSize *
-                        sizeof(unsigned char), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.op_file) ) != 1 )
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.opBuffer +
-                        chunks * chunkSize, remain *
-                        sizeof(unsigned char), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.op_file) ) != 1 )
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        addContainerBlock(OPERATIONS_TAPE, number * sizeof(unsigned char));
+    if (asyncTapeIO()) {
+        ADOLC_CURRENT_TAPE_INFOS.opBuffer = (unsigned char *)
+            queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.opWriter,
+                           ADOLC_CURRENT_TAPE_INFOS.op_file,
+                           ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                           number * sizeof(unsigned char),
+                           ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE] *
+                           sizeof(unsigned char));
+        ADOLC_CURRENT_TAPE_INFOS.lastOpP1 = ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+                            i * chunkSize, chunkSize *
+                            sizeof(unsigned char), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.op_file) ) != 1 )
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+                            chunks * chunkSize, remain *
+                            sizeof(unsigned char), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.op_file) ) != 1 )
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numOps_Tape += number;
     ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
@@ -1905,22 +3831,54 @@ void get_op_block_f() {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.opMap != NULL) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numOps_Tape);
+        setOpWindow(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] -
+                ADOLC_CURRENT_TAPE_INFOS.numOps_Tape);
+        ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+        return;
+    }
+
     number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE],
             ADOLC_CURRENT_TAPE_INFOS.numOps_Tape);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
-                    chunkSize * sizeof(unsigned char), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
-            fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks * chunkSize,
-                    remain * sizeof(unsigned char), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.opReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.opBuffer = (unsigned char *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.opReader,
+                    ADOLC_CURRENT_TAPE_INFOS.opBuffer, ADOLC_EVAL_OP_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastOpP1 = ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
+        prefetchOpBlock(ADOLC_FORWARD);
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.op_file, OPERATIONS_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_OPERATIONS] -
+                    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape) *
+                    sizeof(unsigned char),
+                    ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                    number * sizeof(unsigned char)))
             fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= remain;
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
+                        chunkSize * sizeof(unsigned char), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+                fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks * chunkSize,
+                        remain * sizeof(unsigned char), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+                fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+    }
+    ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
     ADOLC_CURRENT_TAPE_INFOS.currOp = ADOLC_CURRENT_TAPE_INFOS.opBuffer;
 }
 
@@ -1934,21 +3892,54 @@ void get_op_block_r() {
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
     number = ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
-    fseek(ADOLC_CURRENT_TAPE_INFOS.op_file, sizeof(unsigned char) *
-            (ADOLC_CURRENT_TAPE_INFOS.numOps_Tape - number), SEEK_SET);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
-                    chunkSize * sizeof(unsigned char), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
-            fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks * chunkSize,
-                    remain * sizeof(unsigned char), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.opMap != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
+        setOpWindow(ADOLC_CURRENT_TAPE_INFOS.numOps_Tape);
+        advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.opMap,
+                ADOLC_CURRENT_TAPE_INFOS.numOps_Tape, number,
+                sizeof(unsigned char));
+        ADOLC_CURRENT_TAPE_INFOS.currOp =
+            ADOLC_CURRENT_TAPE_INFOS.opBuffer + number;
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.opReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.opBuffer = (unsigned char *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.opReader,
+                    ADOLC_CURRENT_TAPE_INFOS.opBuffer, ADOLC_EVAL_OP_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastOpP1 = ADOLC_CURRENT_TAPE_INFOS.opBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[OP_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currOp =
+            ADOLC_CURRENT_TAPE_INFOS.opBuffer + number;
+        prefetchOpBlock(ADOLC_REVERSE);
+        return;
+    }
+
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.op_file, OPERATIONS_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.numOps_Tape - number) *
+                    sizeof(unsigned char),
+                    ADOLC_CURRENT_TAPE_INFOS.opBuffer,
+                    number * sizeof(unsigned char)))
             fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+    } else {
+        fseek(ADOLC_CURRENT_TAPE_INFOS.op_file, sizeof(unsigned char) *
+                (ADOLC_CURRENT_TAPE_INFOS.numOps_Tape - number), SEEK_SET);
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(unsigned char);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + i * chunkSize,
+                        chunkSize * sizeof(unsigned char), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+                fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.opBuffer + chunks * chunkSize,
+                        remain * sizeof(unsigned char), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.op_file) != 1)
+                fail(ADOLC_EVAL_OP_TAPE_READ_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numOps_Tape -= number;
     ADOLC_CURRENT_TAPE_INFOS.currOp =
         ADOLC_CURRENT_TAPE_INFOS.opBuffer + number;
@@ -1956,6 +3947,192 @@ void get_op_block_r() {
 
 /* --- Locations --- */
 
+/****************************************************************************/
+/* Encoded locations files (stats[LOC_FILE_FORMAT] == ADOLC_LOC_DELTA).     */
+/* The file starts with statSpace plain locints for ADOLC_ID and the stats. */
+/* Each block follows as a frame: the payload length, the payload and the   */
+/* length once more, so that the file can be walked in both directions.    */
+/* The payload holds varints: the block length n, the range [s, k) of the  */
+/* encoded elements, the zig-zag deltas of these elements to their          */
+/* predecessor and, if k < n, the block remainder kept in element n-1.      */
+/* Elements before s are part of the stats, those in [k, n-1) are unused.   */
+/* Only the files are encoded, the buffers and thus the sweeps are as for  */
+/* plain files.                                                             */
+/****************************************************************************/
+#define LOC_FRAME_SIZE(n) (((n) + 4) * 10 + 2 * sizeof(unsigned int))
+
+static unsigned char *putVarint(unsigned char *p, unsigned long long v) {
+    while (v >= 0x80) {
+        *p++ = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (unsigned char)v;
+    return p;
+}
+
+static const unsigned char *getVarint(const unsigned char *p,
+                                      const unsigned char *end,
+                                      unsigned long long *v) {
+    int shift = 0;
+    *v = 0;
+    do {
+        if (p == end || shift > 63) fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        *v |= (unsigned long long)(*p & 0x7f) << shift;
+        shift += 7;
+    } while (*p++ & 0x80);
+    return p;
+}
+
+/* writes the frame of a block of n locations to "frame", returns its size */
+static size_t encodeLocBlock(unsigned char *frame, const locint *block,
+                             size_t n, size_t s, size_t k) {
+    unsigned char *p = frame + sizeof(unsigned int);
+    unsigned long long z;
+    long long prev = 0, delta;
+    unsigned int len;
+    size_t i;
+
+    p = putVarint(p, n);
+    p = putVarint(p, s);
+    p = putVarint(p, k);
+    for (i = s; i < k; ++i) {
+        delta = (long long)block[i] - prev;
+        z = (delta < 0) ? ~((unsigned long long)delta << 1)
+                        : (unsigned long long)delta << 1;
+        p = putVarint(p, z);
+        prev = block[i];
+    }
+    if (k < n) p = putVarint(p, block[n - 1]);
+    len = p - frame - sizeof(unsigned int);
+    memcpy(frame, &len, sizeof(unsigned int));
+    memcpy(p, &len, sizeof(unsigned int));
+    return len + 2 * sizeof(unsigned int);
+}
+
+/* decodes a payload of "len" bytes into "block", returns the block length */
+static size_t decodeLocBlock(const unsigned char *p, size_t len,
+                             locint *block, size_t size) {
+    const unsigned char *end = p + len;
+    unsigned long long n, s, k, z;
+    long long prev = 0;
+    size_t i;
+
+    p = getVarint(p, end, &n);
+    p = getVarint(p, end, &s);
+    p = getVarint(p, end, &k);
+    if (n > size || s > k || k > n) fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    for (i = s; i < k; ++i) {
+        p = getVarint(p, end, &z);
+        prev += (z & 1) ? -(long long)(z >> 1) - 1 : (long long)(z >> 1);
+        block[i] = (locint)prev;
+    }
+    if (k < n) {
+        p = getVarint(p, end, &z);
+        block[n - 1] = (locint)z;
+    }
+    return n;
+}
+
+/****************************************************************************/
+/* Encodes the locations buffer and writes it as the next frame.            */
+/****************************************************************************/
+static void writeLocFrame(size_t number) {
+    size_t head = 0, first = 0, used, size, capacity;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    capacity = statSpace * sizeof(locint) +
+        LOC_FRAME_SIZE(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE]);
+    if (ADOLC_CURRENT_TAPE_INFOS.locFrame == NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.locFrame =
+            (unsigned char *)allocTapeBuffer(capacity);
+        if (ADOLC_CURRENT_TAPE_INFOS.locFrame == NULL)
+            fail(ADOLC_TAPING_BUFFER_ALLOCATION_FAILED);
+    }
+    /* blocks completed by put_op_reserve end with the remainder, currLoc
+     * points to the unused part in front of it */
+    used = ADOLC_CURRENT_TAPE_INFOS.currLoc -
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+    if (used > number) used = number;
+    if (ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape == 0) {
+        /* room for the stats written by close_tape */
+        head = statSpace * sizeof(locint);
+        memset(ADOLC_CURRENT_TAPE_INFOS.locFrame, 0, head);
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape < statSpace)
+        first = MIN_ADOLC(statSpace - ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape,
+                used);
+    size = head + encodeLocBlock(ADOLC_CURRENT_TAPE_INFOS.locFrame + head,
+            ADOLC_CURRENT_TAPE_INFOS.locBuffer, number, first, used);
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        addContainerBlock(LOCATIONS_TAPE, size);
+    if (asyncTapeIO())
+        ADOLC_CURRENT_TAPE_INFOS.locFrame = (unsigned char *)
+            queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.locWriter,
+                    ADOLC_CURRENT_TAPE_INFOS.loc_file,
+                    ADOLC_CURRENT_TAPE_INFOS.locFrame, size, capacity);
+    else if (writeTapeData(ADOLC_CURRENT_TAPE_INFOS.locFrame, size, 1,
+                ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+        fail(ADOLC_TAPING_FATAL_IO_ERROR);
+}
+
+/****************************************************************************/
+/* Reads the next (forward) or previous (reverse) frame of an encoded       */
+/* locations file into the buffer, "expected" is the length of the block.   */
+/****************************************************************************/
+static void readLocFrame(char mode, size_t expected) {
+    unsigned int len, len2;
+    size_t capacity, pos;
+    ADOLC_OPENMP_THREAD_NUMBER;
+    ADOLC_OPENMP_GET_THREAD_NUMBER;
+
+    capacity = LOC_FRAME_SIZE(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE]);
+    if (ADOLC_CURRENT_TAPE_INFOS.locFrame == NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.locFrame =
+            (unsigned char *)allocTapeBuffer(capacity);
+        if (ADOLC_CURRENT_TAPE_INFOS.locFrame == NULL)
+            fail(ADOLC_MALLOC_FAILED);
+    }
+    /* the length in front of (forward) or behind (reverse) the frame */
+    pos = ADOLC_CURRENT_TAPE_INFOS.locFramePos;
+    if (mode == ADOLC_REVERSE) {
+        if (pos < statSpace * sizeof(locint) + 2 * sizeof(unsigned int))
+            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        pos -= sizeof(unsigned int);
+    }
+    if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE, pos, &len,
+                sizeof(unsigned int)) ||
+            len + 2 * sizeof(unsigned int) > capacity)
+        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    if (mode == ADOLC_REVERSE) {
+        if (ADOLC_CURRENT_TAPE_INFOS.locFramePos <
+                statSpace * sizeof(locint) + len + 2 * sizeof(unsigned int))
+            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.locFramePos -=
+            len + 2 * sizeof(unsigned int);
+    }
+    /* the whole frame with both lengths */
+    if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE,
+                ADOLC_CURRENT_TAPE_INFOS.locFramePos,
+                ADOLC_CURRENT_TAPE_INFOS.locFrame,
+                len + 2 * sizeof(unsigned int)))
+        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    memcpy(&len2, ADOLC_CURRENT_TAPE_INFOS.locFrame, sizeof(unsigned int));
+    if (len2 != len) fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    memcpy(&len2, ADOLC_CURRENT_TAPE_INFOS.locFrame + sizeof(unsigned int) +
+           len, sizeof(unsigned int));
+    if (len2 != len) fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    if (mode == ADOLC_FORWARD)
+        ADOLC_CURRENT_TAPE_INFOS.locFramePos += len + 2 * sizeof(unsigned int);
+    if (decodeLocBlock(ADOLC_CURRENT_TAPE_INFOS.locFrame +
+                sizeof(unsigned int), len,
+                ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE]) != expected)
+        fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+}
+
 /****************************************************************************/
 /* Writes a block of locations onto hard disk and handles file creation,   */
 /* removal, ...                                                             */
@@ -1966,6 +4143,9 @@ void put_loc_block(locint *lastLocP1) {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.loc_file == NULL &&
+            ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        createContainer();
     if (ADOLC_CURRENT_TAPE_INFOS.loc_file == NULL) {
         ADOLC_CURRENT_TAPE_INFOS.loc_file =
             fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "rb");
@@ -1980,27 +4160,45 @@ void put_loc_block(locint *lastLocP1) {
                 fprintf(DIAG_OUT, "ADOL-C warning: "
                         "Unable to remove old tapefile!\n");
             ADOLC_CURRENT_TAPE_INFOS.loc_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "wb");
         } else {
             ADOLC_CURRENT_TAPE_INFOS.loc_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.loc_fileName, "wb");
         }
     }
 
     number = lastLocP1 - ADOLC_CURRENT_TAPE_INFOS.locBuffer;
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.locBuffer +
-                        i * chunkSize, chunkSize * sizeof(locint), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.loc_file) ) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.locBuffer +
-                        chunks * chunkSize, remain * sizeof(locint), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.loc_file) ) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    /* encoded blocks are registered by writeLocFrame */
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape &&
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] != ADOLC_LOC_DELTA)
+        addContainerBlock(LOCATIONS_TAPE, number * sizeof(locint));
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] == ADOLC_LOC_DELTA) {
+        writeLocFrame(number);
+    } else if (asyncTapeIO()) {
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer = (locint *)
+            queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.locWriter,
+                           ADOLC_CURRENT_TAPE_INFOS.loc_file,
+                           ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                           number * sizeof(locint),
+                           ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE] *
+                           sizeof(locint));
+        ADOLC_CURRENT_TAPE_INFOS.lastLocP1 = ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+                            i * chunkSize, chunkSize * sizeof(locint), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.loc_file) ) != 1)
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+                            chunks * chunkSize, remain * sizeof(locint), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.loc_file) ) != 1)
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape += number;
     ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
@@ -2015,21 +4213,59 @@ void get_loc_block_f() {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.locMap != NULL) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape);
+        setLocWindow(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] -
+                ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape);
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+        return;
+    }
+
     number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE],
             ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof (locint);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
-                    chunkSize * sizeof(locint), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
-            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
-                    remain * sizeof(locint), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] == ADOLC_LOC_DELTA) {
+        readLocFrame(ADOLC_FORWARD, number);
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.locReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer = (locint *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.locReader,
+                    ADOLC_CURRENT_TAPE_INFOS.locBuffer, ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastLocP1 = ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
+        prefetchLocBlock(ADOLC_FORWARD);
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_LOCATIONS] -
+                    ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape) *
+                    sizeof(locint),
+                    ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                    number * sizeof(locint)))
             fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof (locint);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
+                        chunkSize * sizeof(locint), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+                fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
+                        remain * sizeof(locint), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+                fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
     ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.locBuffer;
 }
@@ -2044,21 +4280,61 @@ void get_loc_block_r() {
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
     number = ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
-    fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file, sizeof(locint) *
-            (ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape - number), SEEK_SET);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
-                   chunkSize * sizeof(locint), 1,
-                   ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
-            fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
-                   remain * sizeof(locint), 1,
-                   ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.locMap != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        setLocWindow(ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape);
+        advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.locMap,
+                ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape, number,
+                sizeof(locint));
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.lastLocP1 -
+                *(ADOLC_CURRENT_TAPE_INFOS.lastLocP1 - 1);
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.stats[LOC_FILE_FORMAT] == ADOLC_LOC_DELTA) {
+        readLocFrame(ADOLC_REVERSE, number);
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.lastLocP1 -
+                *(ADOLC_CURRENT_TAPE_INFOS.lastLocP1 - 1);
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.locReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.locBuffer = (locint *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.locReader,
+                    ADOLC_CURRENT_TAPE_INFOS.locBuffer, ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastLocP1 = ADOLC_CURRENT_TAPE_INFOS.locBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.lastLocP1 -
+                *(ADOLC_CURRENT_TAPE_INFOS.lastLocP1 - 1);
+        prefetchLocBlock(ADOLC_REVERSE);
+        return;
+    }
+
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.loc_file, LOCATIONS_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape - number) *
+                    sizeof(locint),
+                    ADOLC_CURRENT_TAPE_INFOS.locBuffer,
+                    number * sizeof(locint)))
             fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    } else {
+        fseek(ADOLC_CURRENT_TAPE_INFOS.loc_file, sizeof(locint) *
+                (ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape - number), SEEK_SET);
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(locint);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + i * chunkSize,
+                       chunkSize * sizeof(locint), 1,
+                       ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+                fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.locBuffer + chunks * chunkSize,
+                       remain * sizeof(locint), 1,
+                       ADOLC_CURRENT_TAPE_INFOS.loc_file) != 1)
+                fail(ADOLC_EVAL_LOC_TAPE_READ_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numLocs_Tape -=
         ADOLC_CURRENT_TAPE_INFOS.stats[LOC_BUFFER_SIZE];
     ADOLC_CURRENT_TAPE_INFOS.currLoc = ADOLC_CURRENT_TAPE_INFOS.lastLocP1 -
@@ -2117,6 +4393,9 @@ void put_val_block(double *lastValP1) {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.val_file == NULL &&
+            ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        createContainer();
     if (ADOLC_CURRENT_TAPE_INFOS.val_file == NULL) {
         ADOLC_CURRENT_TAPE_INFOS.val_file =
             fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "rb");
@@ -2131,27 +4410,41 @@ void put_val_block(double *lastValP1) {
                 fprintf(DIAG_OUT, "ADOL-C warning: "
                         "Unable to remove old tapefile\n");
             ADOLC_CURRENT_TAPE_INFOS.val_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "wb");
         } else {
             ADOLC_CURRENT_TAPE_INFOS.val_file =
-                fopen(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "wb");
+                openTapeStream(ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.val_fileName, "wb");
         }
     }
 
     number = lastValP1 - ADOLC_CURRENT_TAPE_INFOS.valBuffer;
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
-                        i * chunkSize, chunkSize * sizeof(double), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.val_file) ) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if ((failAdditionalInfo1 = fwrite(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
-                        chunks * chunkSize, remain * sizeof(double), 1,
-                        ADOLC_CURRENT_TAPE_INFOS.val_file) ) != 1)
-            fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape)
+        addContainerBlock(VALUES_TAPE, number * sizeof(double));
+    if (asyncTapeIO()) {
+        ADOLC_CURRENT_TAPE_INFOS.valBuffer = (double *)
+            queueTapeBlock(&ADOLC_CURRENT_TAPE_INFOS.valWriter,
+                           ADOLC_CURRENT_TAPE_INFOS.val_file,
+                           ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                           number * sizeof(double),
+                           ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE] *
+                           sizeof(double));
+        ADOLC_CURRENT_TAPE_INFOS.lastValP1 = ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+                            i * chunkSize, chunkSize * sizeof(double), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.val_file) ) != 1)
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if ((failAdditionalInfo1 = writeTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+                            chunks * chunkSize, remain * sizeof(double), 1,
+                            ADOLC_CURRENT_TAPE_INFOS.val_file) ) != 1)
+                fail(ADOLC_TAPING_FATAL_IO_ERROR);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numVals_Tape += number;
     ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
     ADOLC_OPENMP_RESTORE_THREAD_NUMBER;
@@ -2166,21 +4459,55 @@ void get_val_block_f() {
     ADOLC_OPENMP_THREAD_NUMBER;
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
+    if (ADOLC_CURRENT_TAPE_INFOS.valMap != NULL) {
+        number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
+                ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
+        setValWindow(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] -
+                ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
+        ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
+        ++ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        return;
+    }
+
     number = MIN_ADOLC(ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE],
             ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof (double);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
-                    chunkSize * sizeof(double), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
-            fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks * chunkSize,
-                    remain * sizeof(double), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.valReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.valBuffer = (double *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.valReader,
+                    ADOLC_CURRENT_TAPE_INFOS.valBuffer, ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastValP1 = ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+        ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
+        ++ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        prefetchValBlock(ADOLC_FORWARD);
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.stats[NUM_VALUES] -
+                    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape) *
+                    sizeof(double),
+                    ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                    number * sizeof(double)))
             fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    } else {
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof (double);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
+                        chunkSize * sizeof(double), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+                fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks * chunkSize,
+                        remain * sizeof(double), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+                fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
     ADOLC_CURRENT_TAPE_INFOS.currVal = ADOLC_CURRENT_TAPE_INFOS.valBuffer;
     /* get_locint_f(); value used in reverse only */
@@ -2198,21 +4525,58 @@ void get_val_block_r() {
     ADOLC_OPENMP_GET_THREAD_NUMBER;
 
     number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
-    fseek(ADOLC_CURRENT_TAPE_INFOS.val_file, sizeof(double) *
-            (ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number), SEEK_SET);
-    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
-    chunks = number / chunkSize;
-    for (i = 0; i < chunks; ++i)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
-                   chunkSize * sizeof(double), 1,
-                   ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
-            fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
-    remain = number % chunkSize;
-    if (remain != 0)
-        if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks * chunkSize,
-                    remain * sizeof(double), 1,
-                    ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+    if (ADOLC_CURRENT_TAPE_INFOS.valMap != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+        setValWindow(ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
+        advisePrevBlock(ADOLC_CURRENT_TAPE_INFOS.valMap,
+                ADOLC_CURRENT_TAPE_INFOS.numVals_Tape, number,
+                sizeof(double));
+        --ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        temp = *ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        ADOLC_CURRENT_TAPE_INFOS.currVal =
+            ADOLC_CURRENT_TAPE_INFOS.lastValP1 - temp;
+        return;
+    }
+    if (ADOLC_CURRENT_TAPE_INFOS.valReader != NULL) {
+        ADOLC_CURRENT_TAPE_INFOS.valBuffer = (double *)
+            takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.valReader,
+                    ADOLC_CURRENT_TAPE_INFOS.valBuffer, ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+        ADOLC_CURRENT_TAPE_INFOS.lastValP1 = ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+            ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+        ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+        --ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        temp = *ADOLC_CURRENT_TAPE_INFOS.currLoc;
+        ADOLC_CURRENT_TAPE_INFOS.currVal =
+            ADOLC_CURRENT_TAPE_INFOS.lastValP1 - temp;
+        prefetchValBlock(ADOLC_REVERSE);
+        return;
+    }
+
+    if (ADOLC_CURRENT_TAPE_INFOS.containerTape) {
+        if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+                    ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE,
+                    (ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number) *
+                    sizeof(double),
+                    ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+                    number * sizeof(double)))
             fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    } else {
+        fseek(ADOLC_CURRENT_TAPE_INFOS.val_file, sizeof(double) *
+                (ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number), SEEK_SET);
+        chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
+        chunks = number / chunkSize;
+        for (i = 0; i < chunks; ++i)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + i * chunkSize,
+                       chunkSize * sizeof(double), 1,
+                       ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+                fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+        remain = number % chunkSize;
+        if (remain != 0)
+            if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer + chunks * chunkSize,
+                        remain * sizeof(double), 1,
+                        ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
+                fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+    }
     ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
     --ADOLC_CURRENT_TAPE_INFOS.currLoc;
     temp = *ADOLC_CURRENT_TAPE_INFOS.currLoc;
@@ -2258,20 +4622,49 @@ void discard_params_r(void) {
 	rsize = (avail<ip)?avail:ip;
 	ip -= rsize;
 	ADOLC_CURRENT_TAPE_INFOS.currVal -= rsize;
-	if ( ip > 0 ) {
+	if ( ip > 0 && ADOLC_CURRENT_TAPE_INFOS.valMap != NULL ) {
+	    number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+	    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+	    setValWindow(ADOLC_CURRENT_TAPE_INFOS.numVals_Tape);
+	    ADOLC_CURRENT_TAPE_INFOS.currVal =
+		ADOLC_CURRENT_TAPE_INFOS.lastValP1;
+	} else if ( ip > 0 && ADOLC_CURRENT_TAPE_INFOS.valReader != NULL ) {
+	    number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+	    ADOLC_CURRENT_TAPE_INFOS.valBuffer = (double *)
+		takeTapeBlock(ADOLC_CURRENT_TAPE_INFOS.valReader,
+			ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+			ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+	    ADOLC_CURRENT_TAPE_INFOS.lastValP1 =
+		ADOLC_CURRENT_TAPE_INFOS.valBuffer + number;
+	    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+	    ADOLC_CURRENT_TAPE_INFOS.currVal =
+		ADOLC_CURRENT_TAPE_INFOS.lastValP1;
+	    prefetchValBlock(ADOLC_REVERSE);
+	} else if ( ip > 0 && ADOLC_CURRENT_TAPE_INFOS.containerTape ) {
+	    number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
+	    if (!readTapeStream(&ADOLC_CURRENT_TAPE_INFOS,
+			ADOLC_CURRENT_TAPE_INFOS.val_file, VALUES_TAPE,
+			(ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number) *
+			sizeof(double), ADOLC_CURRENT_TAPE_INFOS.valBuffer,
+			number * sizeof(double)))
+		fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
+	    ADOLC_CURRENT_TAPE_INFOS.numVals_Tape -= number;
+	    ADOLC_CURRENT_TAPE_INFOS.currVal =
+		ADOLC_CURRENT_TAPE_INFOS.lastValP1;
+	} else if ( ip > 0 ) {
 	    number = ADOLC_CURRENT_TAPE_INFOS.stats[VAL_BUFFER_SIZE];
 	    fseek(ADOLC_CURRENT_TAPE_INFOS.val_file, sizeof(double) *
 		(ADOLC_CURRENT_TAPE_INFOS.numVals_Tape - number), SEEK_SET);
 	    chunkSize = ADOLC_IO_CHUNK_SIZE / sizeof(double);
 	    chunks = number / chunkSize;
 	    for (i = 0; i < chunks; ++i)
-		if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+		if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
 		i * chunkSize, chunkSize * sizeof(double), 1,
 		ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
 		    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
 	    remain = number % chunkSize;
 	    if (remain != 0)
-		if (fread(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
+		if (readTapeData(ADOLC_CURRENT_TAPE_INFOS.valBuffer +
 		chunks * chunkSize, remain * sizeof(double), 1,
 		ADOLC_CURRENT_TAPE_INFOS.val_file) != 1)
 		    fail(ADOLC_EVAL_VAL_TAPE_READ_FAILED);
@@ -57,6 +57,33 @@ ADOLC_ID;
 
 extern ADOLC_ID adolc_id;
 
+/* entries of the stats of a tape following the public ones (taping.h),
+ * stored with them in the statSpace of the locations file but not returned
+ * by tapestats() */
+enum TapeStatEntries {
+    LOC_FILE_FORMAT = STAT_SIZE,   /* encoding of the locations file */
+    TAPE_STAT_SIZE
+};
+
+/* values of stats[LOC_FILE_FORMAT], old tapes read as ADOLC_LOC_PLAIN */
+enum LocFileFormats {
+    ADOLC_LOC_PLAIN,                   /* blocks of locints as in the buffer */
+    ADOLC_LOC_DELTA          /* zig-zag delta varint frames, see taping.c */
+};
+
+/* encodings of spilled taylor stack blocks (TAYLORCODEC), see taping.c */
+enum TayCodecs {
+    ADOLC_TAY_PLAIN,                       /* blocks of revreals as in core */
+    ADOLC_TAY_REPEATS,       /* repeats of the previous value are dropped */
+    ADOLC_TAY_FLOAT       /* as above, remaining values stored as float */
+};
+
+enum TapeIOModes {
+    ADOLC_IO_STDIO,                          /* buffered fread and fwrite */
+    ADOLC_IO_PREAD,   /* unbuffered pread/pwrite, pages dropped from cache */
+    ADOLC_IO_DIRECT             /* as above, aligned blocks with O_DIRECT */
+};
+
 /****************************************************************************/
 /* tape types => used for file name generation                              */
 /****************************************************************************/
@@ -64,9 +91,18 @@ enum TAPENAMES {
     LOCATIONS_TAPE,
     VALUES_TAPE,
     OPERATIONS_TAPE,
-    TAYLORS_TAPE
+    TAYLORS_TAPE,
+    CONTAINER_TAPE        /* op/loc/val in a single file (TAPECONTAINER) */
 };
 
+/* a block of the op/loc/val stream of a container tape, streams are
+ * indexed by LOCATIONS_TAPE, VALUES_TAPE and OPERATIONS_TAPE */
+typedef struct TapeBlock {
+    size_t streamOffset;            /* position within the stream (bytes) */
+    size_t fileOffset;               /* position within the container file */
+    size_t size;                                              /* in bytes */
+} TapeBlock;
+
 /****************************************************************************/
 /* Errors handled by fail(...)                                              */
 /****************************************************************************/
@@ -190,6 +226,7 @@ typedef struct PersistantTapeInfos { /* survive tape re-usage */
     char *loc_fileName;
     char *val_fileName;
     char *tay_fileName;
+    char *container_fileName;
 
     int keepTape; /* - remember if tapes shall be written out to disk
                      - this information can only be given at taping time and
@@ -200,6 +237,18 @@ typedef struct PersistantTapeInfos { /* survive tape re-usage */
      */
     int skipFileCleanup;
 
+    /**
+     * memory mapped reading of disk based tapes during sweeps
+     * 0 - as configured in .adolcrc, > 0 - enabled, < 0 - disabled
+     */
+    int mmapTape;
+
+    /**
+     * decoded first order sweeps over the tape kept in core
+     * 0 - as configured in .adolcrc, > 0 - enabled, < 0 - disabled
+     */
+    int decodeTape;
+
     revreal *paramstore;
 #ifdef __cplusplus
     PersistantTapeInfos();
@@ -223,7 +272,7 @@ typedef struct TapeInfos {
     uint numInds;
     uint numDeps;
     int keepTaylors;             /* == 1 - write taylor stack in taping mode */
-    size_t stats[STAT_SIZE];
+    size_t stats[TAPE_STAT_SIZE];
     int traceFlag;
     char tapingComplete;
 
@@ -248,6 +297,47 @@ typedef struct TapeInfos {
     locint *currLoc;
     locint *lastLocP1;
     size_t numLocs_Tape;
+    unsigned char *locFrame;  /* encoded block (stats[LOC_FILE_FORMAT] != 0) */
+    size_t locFramePos;    /* file offset of the frame after the current one
+                              (forward) or of the current frame (reverse) */
+
+    /* memory mapped op/loc/val files (during sweeps only), while a file is
+     * mapped the corresponding buffer pointer walks through the mapping and
+     * the allocated buffer is parked in *BufferSave */
+    unsigned char *opMap;
+    locint *locMap;
+    double *valMap;
+    size_t opMapSize, locMapSize, valMapSize;       /* mapped size in bytes */
+    unsigned char *opBufferSave;
+    locint *locBufferSave;
+    double *valBufferSave;
+
+    /* background writing of full buffers and reading of the next block
+     * during sweeps (IOBUFNUM > 1), NULL otherwise */
+    struct TapeWriterStream *opWriter, *locWriter, *valWriter, *tayWriter;
+    struct TapeReadAhead *opReader, *locReader, *valReader, *tayReader;
+
+    /* single file container (TAPECONTAINER), op_file, loc_file and val_file
+     * then all refer to the container file */
+    char containerTape;
+    TapeBlock *blockIndex[3];     /* blocks of each stream in stream order */
+    size_t numBlocks[3];
+    size_t maxBlocks[3];
+    size_t containerSize;                    /* bytes written so far */
+
+    /* in-core tape cache (TAPECACHESIZE) */
+    size_t cacheStamp;        /* time of the last use, oldest is evicted */
+    char cacheEvicted;        /* moved to disk by the cache, reloaded on use */
+    char cacheOnDisk;          /* files hold a valid copy of the tape */
+
+    /* fixed width instructions of an in-core tape (tape_decode.c) */
+    struct DecodedTape *decodedTape;
+    char decodeRejected;     /* tape has operations the decoder rejects */
+    /* kernels compiled from the tape by tape_codegen (tape_codegen.c) */
+    struct CompiledTape *compiledTape;
+    /* serial tape whose op/loc/val buffers and decoded tape this view of a
+     * worker thread reads (see openTape), NULL for tapes owning them */
+    struct TapeInfos *sharedTape;
 
     /* taylor stack tape */
     FILE *tay_file;
@@ -262,6 +352,17 @@ typedef struct TapeInfos {
     uint deg_save;                 /* degree to save and saved respectively */
     uint tay_numInds;             /* # of independents for the taylor stack */
     uint tay_numDeps;               /* # of dependents for the taylor stack */
+    char tayCodec;              /* encoding of the blocks in the taylor file */
+    size_t *tayBlockEnd;   /* file offset behind each block (codec only) */
+    size_t numTayBlocks;
+    size_t maxTayBlocks;
+    unsigned char *tayCodecBuffer;      /* encoded block being read/written */
+    char tayKeepSelective;   /* results of linear operations only pushed
+                                  if needed (SELECTIVETAYLORS), see below */
+    unsigned char *tayKeepBits;       /* one bit per such result: pushed? */
+    size_t numTayKeepBits;
+    size_t maxTayKeepBytes;
+    size_t tayKeepBitPos;             /* next bit to read back in reverse */
 
     /* checkpointing */
     locint lowestXLoc_for;     /* location of the first ind. - forward mode */
@@ -324,6 +425,18 @@ typedef struct GlobalTapeVarsCL {
     locint valueBufferSize;     /* in a local config file .adolcrc. */
     locint taylorBufferSize;
     int maxNumberTaylorBuffers;
+    char mmapTapes;      /* map disk based tapes during sweeps (.adolcrc) */
+    int numIOBuffers;  /* buffers per stream for asynchronous writing */
+    char locFileFormat;       /* format of new locations files (.adolcrc) */
+    char tapeContainer;    /* write new tapes as a single file (.adolcrc) */
+    size_t tapeCacheSize;  /* bytes for in-core tapes, 0 = no limit (.adolcrc) */
+    size_t tapeCacheClock;             /* counts uses of tapes for the LRU */
+    size_t tapeCacheHits, tapeCacheMisses, tapeCacheEvictions;
+    char tayCodec;      /* encoding of spilled taylor stacks (.adolcrc) */
+    char selectiveTaylors;   /* selective taylor recording (.adolcrc) */
+    char tapeIOMode;          /* access to the tape files (.adolcrc) */
+    char optimizeTapes;      /* optimize tapes in trace_off (.adolcrc) */
+    char decodeTapes;   /* decoded sweeps over in-core tapes (.adolcrc) */
 
     char inParallelRegion;       /* set to 1 if in an OpenMP parallel region */
     char newTape;               /* signals: at least one tape created (0/1) */
@@ -348,6 +461,13 @@ typedef struct GlobalTapeVarsCL {
 }
 GlobalTapeVars;
 
+/* storage class of the per thread environment */
+#if defined(ADOLC_THREADLOCAL)
+#define ADOLC_THREAD_LOCAL __thread
+#else
+#define ADOLC_THREAD_LOCAL
+#endif
+
 #if defined(_OPENMP)
 
 extern int isParallel();
@@ -378,6 +498,31 @@ extern int isParallel();
 #define ADOLC_CHECKPOINTS_STACK ADOLC_checkpointsStack[ADOLC_threadNumber]
 #define REVOLVE_NUMBERS revolve_numbers[ADOLC_threadNumber]
 
+#elif defined(ADOLC_THREADLOCAL)
+
+#define ADOLC_TAPE_INFOS_BUFFER_DECL *tapeInfosBuffer
+#define ADOLC_TAPE_STACK_DECL *tapeStack
+#define ADOLC_CURRENT_TAPE_INFOS_DECL *currentTapeInfos
+#define ADOLC_CURRENT_TAPE_INFOS_FALLBACK_DECL *currentTapeInfos_fallBack
+#define ADOLC_GLOBAL_TAPE_VARS_DECL *globalTapeVars
+#define ADOLC_EXT_DIFF_FCTS_BUFFER_DECL *ADOLC_extDiffFctsBuffer
+#define ADOLC_CHECKPOINTS_STACK_DECL *ADOLC_checkpointsStack
+
+/* the environment of a thread is created when it first calls ADOL-C */
+#define ADOLC_OPENMP_THREAD_NUMBER
+#define ADOLC_OPENMP_GET_THREAD_NUMBER \
+    if (globalTapeVars == NULL) initThreadEnvironment()
+#define ADOLC_OPENMP_RESTORE_THREAD_NUMBER
+
+#define ADOLC_TAPE_INFOS_BUFFER (*tapeInfosBuffer)
+#define ADOLC_TAPE_STACK (*tapeStack)
+#define ADOLC_CURRENT_TAPE_INFOS (*currentTapeInfos)
+#define ADOLC_CURRENT_TAPE_INFOS_FALLBACK (*currentTapeInfos_fallBack)
+#define ADOLC_GLOBAL_TAPE_VARS (*globalTapeVars)
+#define ADOLC_EXT_DIFF_FCTS_BUFFER (*ADOLC_extDiffFctsBuffer)
+#define ADOLC_CHECKPOINTS_STACK (*ADOLC_checkpointsStack)
+#define REVOLVE_NUMBERS (*revolve_numbers)
+
 #else
 
 #define ADOLC_TAPE_INFOS_BUFFER_DECL tapeInfosBuffer
@@ -403,9 +548,22 @@ extern int isParallel();
 
 #endif /* _OPENMP */
 
-extern TapeInfos ADOLC_CURRENT_TAPE_INFOS_DECL;
-extern TapeInfos ADOLC_CURRENT_TAPE_INFOS_FALLBACK_DECL;
-extern GlobalTapeVars ADOLC_GLOBAL_TAPE_VARS_DECL;
+extern ADOLC_THREAD_LOCAL TapeInfos ADOLC_CURRENT_TAPE_INFOS_DECL;
+extern ADOLC_THREAD_LOCAL TapeInfos ADOLC_CURRENT_TAPE_INFOS_FALLBACK_DECL;
+extern ADOLC_THREAD_LOCAL GlobalTapeVars ADOLC_GLOBAL_TAPE_VARS_DECL;
+
+#if defined(ADOLC_THREADLOCAL)
+#include <adolc/revolve.h>
+extern ADOLC_THREAD_LOCAL revolve_nums *revolve_numbers;
+
+extern ADOLC_THREAD_LOCAL unsigned int ADOLC_threadIndex;
+/* number of the thread in the order of first use, 0 for the thread that
+ * loaded the library, which reads .adolcrc for all threads */
+
+void initThreadEnvironment();
+/* creates the environment of the calling thread, it is released when the
+ * thread terminates */
+#endif
 
 /****************************************************************************/
 /* C Function interfaces                                                    */
@@ -511,6 +669,21 @@ void put_tay_block(revreal *lastValP1);
     }
 /* puts a taylor value from the value stack buffer to the taylor buffer */
 
+void put_tay_keep_bit(int kept);
+/* records whether the old result value of a linear operation was written
+ * to the taylor stack (zos_forward with SELECTIVETAYLORS) */
+
+int get_tay_keep_bit();
+/* reads the bits written by put_tay_keep_bit back in reverse order */
+
+#define ADOLC_GET_TAYLOR_LINEAR(X) \
+    {\
+        if (!ADOLC_CURRENT_TAPE_INFOS.tayKeepSelective || get_tay_keep_bit())\
+            ADOLC_GET_TAYLOR(X)\
+    }
+/* as ADOLC_GET_TAYLOR for the results of linear operations, whose old value
+ * is left out of a selectively recorded taylor stack if not needed */
+
 void get_taylors(locint loc, int degree);
 /* puts a block of taylor coefficients from the value stack buffer to the
  * taylor buffer --- Higher Order Scalar */
@@ -534,6 +707,9 @@ void start_trace();
 void stop_trace(int flag);
 /* stop Tracing, clean up, and turn off trace_flag */
 
+void put_params();
+/* writes the parameters of the current tape behind its end_of_tape */
+
 void close_tape(int flag);
 /* close open tapes, update stats and clean up */
 
@@ -552,6 +728,136 @@ void init_rev_sweep(short tag);
 void end_sweep();
 /* finish a forward or reverse sweep */
 
+void unmap_tape_files(TapeInfos *tapeInfos);
+/* release memory mapped tape files and restore the allocated buffers */
+
+void finish_tape_io(TapeInfos *tapeInfos);
+/* wait for all blocks of the tape handed to the background I/O thread */
+
+void close_tape_files(TapeInfos *tapeInfos);
+/* close the op/loc/val files of a tape (a container file only once) */
+
+void free_block_index(TapeInfos *tapeInfos);
+/* release the block index of a container tape */
+
+void free_tay_index(TapeInfos *tapeInfos);
+/* release the block index and codec buffer of the taylor file and the bits
+ * of a selectively recorded taylor stack */
+
+double **myalloc2_aligned(size_t m, size_t n);
+/* as myalloc2 (adalloc.c), each row starting at a multiple of
+ * ADOLC_VECTOR_ALIGNMENT bytes */
+
+size_t in_core_tape_size(const TapeInfos *tapeInfos);
+/* bytes held by a tape completely kept in core, 0 for other tapes */
+
+struct DecodedTape *get_decoded_tape();
+/* the current tape decoded into fixed width instructions, NULL if it is not
+ * completely kept in core or contains operations the decoded sweeps do not
+ * handle --- decoded once and kept until the tape is rewritten or evicted */
+
+struct DecodedTape *decode_current_tape();
+/* as get_decoded_tape, regardless of the setting "DECODETAPES" */
+
+void free_decoded_tape(TapeInfos *tapeInfos);
+/* release the decoded instructions of a tape */
+
+/* Loops over the directions of the decoded vector sweeps and the points of
+ * the batched sweeps are OpenMP simd loops if the compiler supports them
+ * (configure adds -fopenmp-simd), these sweeps are compiled for AVX-512,
+ * AVX2 and the default target if the compiler supports target clones, the
+ * processor selecting the variant when the library is loaded (not with
+ * threaded dispatch, see tape_decode.c) */
+#if defined(ADOLC_SIMD) || defined(_OPENMP)
+#define ADOLC_SIMD_LOOP _Pragma("omp simd")
+#else
+#define ADOLC_SIMD_LOOP
+#endif
+#if defined(ADOLC_SIMD_CLONES)
+#define ADOLC_SIMD_TARGETS \
+    __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define ADOLC_SIMD_TARGETS
+#endif
+
+void zos_forward_decoded(const struct DecodedTape *tape, int keep,
+                         const double *basepoint, double *valuepoint,
+                         double *dp_T0);
+void fos_forward_decoded(const struct DecodedTape *tape, int keep,
+                         const double *basepoint, const double *argument,
+                         double *valuepoint, double *taylors,
+                         double *dp_T0, double *dp_T);
+void fov_forward_decoded(const struct DecodedTape *tape, int p,
+                         const double *basepoint, double **argument,
+                         double *valuepoint, double **taylors,
+                         double *dp_T0, double **dpp_T);
+/* forward sweeps over a decoded tape, the stream sweeps call them with their
+ * buffers after checking the counts and allocating the taylors */
+
+void zos_forward_parallel_decoded(struct DecodedTape *tape, int keep,
+                                  const double *basepoint,
+                                  double *valuepoint, double *dp_T0);
+void fos_forward_parallel_decoded(struct DecodedTape *tape, int keep,
+                                  const double *basepoint,
+                                  const double *argument,
+                                  double *valuepoint, double *taylors,
+                                  double *dp_T0, double *dp_T);
+/* zos_forward_decoded and fos_forward_decoded, running the levels of
+ * independent operations of the tape on the threads of an OpenMP team if
+ * nothing is kept and there are at least ADOLC_PARALLEL_OPS operations per
+ * level on average; the levels are sorted out on the first such sweep */
+
+void fov_forward_parallel_decoded(const struct DecodedTape *tape, int p,
+                                  int offset, const double *basepoint,
+                                  double **argument, double *valuepoint,
+                                  double **taylors, double *dp_T0,
+                                  double **dpp_T);
+/* fov_forward_decoded on the columns offset..offset+p-1 of argument and
+ * taylors, splitting the directions into slices for the threads of an
+ * OpenMP team if there are at least ADOLC_PARALLEL_DIRECTIONS per thread */
+
+void fos_reverse_decoded(const struct DecodedTape *tape, double *lagrange,
+                         double *results, revreal *rp_T, revreal *rp_A);
+void fov_reverse_decoded(const struct DecodedTape *tape, int p,
+                         double **lagrange, double **results,
+                         revreal *rp_T, revreal **rpp_A);
+/* reverse sweeps over a decoded tape, reading the taylor stack as the
+ * stream sweeps do */
+
+void fov_reverse_parallel_decoded(const struct DecodedTape *tape, int p,
+                                  double **lagrange, double **results,
+                                  revreal *rp_T, revreal **rpp_A);
+/* fov_reverse_decoded, splitting the directions into slices for the threads
+ * of an OpenMP team as fov_forward_parallel_decoded */
+
+void free_compiled_tape(TapeInfos *tapeInfos);
+/* unload the kernels compiled from a tape by tape_codegen */
+
+int zos_forward_compiled(int keep, const double *basepoint,
+                         double *valuepoint, double *dp_T0);
+int fos_forward_compiled(int keep, const double *basepoint,
+                         const double *argument, double *valuepoint,
+                         double *taylors, double *dp_T0, double *dp_T);
+int fov_forward_compiled(int p, const double *basepoint, double **argument,
+                         double *valuepoint, double **taylors,
+                         double *dp_T0, double **dpp_T);
+int fos_reverse_compiled(double *lagrange, double *results, revreal *rp_T,
+                         revreal *rp_A);
+/* run the compiled kernel of the current tape in place of the sweep with
+ * the same arguments as the decoded sweeps, return 0 if there is none */
+
+#define ADOLC_HASH_INIT 14695981039346656037ULL
+unsigned long long hashBytes(unsigned long long hash, const void *data,
+                             size_t size);
+/* continues the FNV-1a hash "hash" (ADOLC_HASH_INIT for a new one) over
+ * "size" bytes from "data" */
+
+void evict_tape();
+/* write the in-core streams of the current tape to disk, release buffers */
+
+void write_tape_files(TapeInfos *tapeInfos);
+/* as evict_tape for any tape while no tape is active */
+
 
 
 void fail(int error);
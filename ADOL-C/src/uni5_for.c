@@ -235,6 +235,13 @@ void extend_nonlinearity_domain_binary
 #endif
 #endif
 
+/*--------------------------------------------------------------------------*/
+/*                                                    decoded in-core tapes */
+#if (defined(_ZOS_) || defined(_FOS_) || defined(_FOV_)) && \
+    !defined(_ABS_NORM_) && !defined(_ABS_NORM_SIG_)
+#define _DECODED_
+#endif
+
 /*--------------------------------------------------------------------------*/
 /*                                                               KEEP stuff */
 #if defined(_KEEP_)
@@ -307,6 +314,133 @@ if (keep){\
 #define IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
 #endif
 
+/*--------------------------------------------------------------------------*/
+/*                                               selective taylor recording */
+/* The reverse rules of linear operations do not read the old value of the */
+/* result. With SELECTIVETAYLORS it is only written if some reverse rule    */
+/* reads it, i.e., if it was marked as read since it has been assigned by   */
+/* a linear operation. Operations reading locations other than arg, arg1,  */
+/* arg2 and res start a new epoch, which invalidates all marks.             */
+#if defined(_KEEP_) && defined(_ZOS_)
+#define IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p) \
+    { \
+        if (tayKeepStamp != NULL) { \
+            if (tayKeepStamp[res] == tayKeepEpoch) \
+                put_tay_keep_bit(0); \
+            else { \
+                put_tay_keep_bit(1); \
+                IF_KEEP_WRITE_TAYLOR(res,keep,k,p) \
+            } \
+            tayKeepStamp[res] = tayKeepEpoch; \
+        } else \
+            IF_KEEP_WRITE_TAYLOR(res,keep,k,p) \
+    }
+
+static void markTaylorReads(unsigned char operation, locint arg,
+                            locint arg1, locint arg2, locint res,
+                            size_t *stamp, size_t *epoch, size_t maxLives) {
+    switch (operation) {
+        case end_of_op:
+        case end_of_int:
+        case end_of_val:
+        case start_of_tape:
+        case end_of_tape:
+        case assign_a:
+        case assign_d:
+        case neg_sign_p:
+        case recipr_p:
+        case assign_p:
+        case assign_d_zero:
+        case assign_d_one:
+        case assign_ind:
+        case eq_plus_d:
+        case eq_plus_p:
+        case eq_plus_a:
+        case eq_min_d:
+        case eq_min_p:
+        case eq_min_a:
+        case eq_mult_d:
+        case eq_mult_p:
+        case incr_a:
+        case decr_a:
+        case plus_a_a:
+        case plus_a_a_a:
+        case axpy_d_a:
+        case plus_d_a:
+        case plus_a_p:
+        case min_a_p:
+        case min_a_a:
+        case min_d_a:
+        case mult_d_a:
+        case mult_a_p:
+        case pos_sign_a:
+        case neg_sign_a:
+            break;
+        case eq_zero:
+        case neq_zero:
+        case le_zero:
+        case gt_zero:
+        case ge_zero:
+        case lt_zero:
+        case assign_dep:
+        case eq_mult_a:
+        case mult_a_a:
+        case eq_plus_prod:
+        case eq_min_prod:
+        case div_a_a:
+        case div_d_a:
+        case div_p_a:
+        case exp_op:
+        case sin_op:
+        case cos_op:
+        case atan_op:
+        case asin_op:
+        case acos_op:
+        case asinh_op:
+        case acosh_op:
+        case atanh_op:
+        case erf_op:
+        case log_op:
+        case pow_op:
+        case pow_op_p:
+        case sqrt_op:
+        case gen_quad:
+        case min_op:
+        case abs_val:
+        case ceil_op:
+        case floor_op:
+        case cond_assign:
+        case cond_eq_assign:
+        case cond_assign_s:
+        case cond_eq_assign_s:
+        case neq_a_a:
+        case eq_a_a:
+        case le_a_a:
+        case ge_a_a:
+        case lt_a_a:
+        case gt_a_a:
+        case neq_a_p:
+        case eq_a_p:
+        case le_a_p:
+        case ge_a_p:
+        case lt_a_p:
+        case gt_a_p:
+            /* unused operands hold stale locations, which is harmless */
+            if (arg < maxLives) stamp[arg] = 0;
+            if (arg1 < maxLives) stamp[arg1] = 0;
+            if (arg2 < maxLives) stamp[arg2] = 0;
+            if (res < maxLives) stamp[res] = 0;
+            break;
+        default:
+            ++*epoch;
+            break;
+    }
+}
+#else
+#define IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p) \
+    IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+#endif
+
 /*--------------------------------------------------------------------------*/
 /*                                                      access to variables */
 #if !defined(_ZOS_)
@@ -1005,6 +1139,14 @@ int  hov_forward(
 
 #if defined(_KEEP_)
     int taylbuf=0;
+#if defined(_ZOS_)
+    size_t *tayKeepStamp = NULL, tayKeepEpoch = 1;
+#endif
+#endif
+
+#if defined(_DECODED_)
+    struct DecodedTape *decodedTape;
+    int compiledSweep = 0;
 #endif
 
 #if defined(_HOV_)
@@ -1209,6 +1351,13 @@ int  hov_forward(
       taylbuf = ADOLC_CURRENT_TAPE_INFOS.stats[TAY_BUFFER_SIZE];
 
         taylor_begin(taylbuf,keep-1);
+        if (ADOLC_GLOBAL_TAPE_VARS.selectiveTaylors) {
+            tayKeepStamp = (size_t *)
+                calloc(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES],
+                       sizeof(size_t));
+            if (tayKeepStamp == NULL) fail(ADOLC_MALLOC_FAILED);
+            ADOLC_CURRENT_TAPE_INFOS.tayKeepSelective = 1;
+        }
     }
 #endif
 
@@ -1289,7 +1438,7 @@ int  hov_forward(
     /*--------------------------------------------------------------------------*/
 #else                                                                /* FOV */
 #if defined(_FOV_)
-    dpp_T = myalloc2(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES],p);
+    dpp_T = myalloc2_aligned(ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES],p);
     ADOLC_CURRENT_TAPE_INFOS.dpp_T = dpp_T;
     ADOLC_CURRENT_TAPE_INFOS.numTay = p;
     ADOLC_CURRENT_TAPE_INFOS.gDegree = 1;
@@ -1354,6 +1503,64 @@ int  hov_forward(
 #   define UPDATE_TAYLORWRITTEN(X)
 #endif /* ADOLC_DEBUG */
 
+#if defined(_DECODED_)
+    /* tapes compiled by tape_codegen run their kernel, other tapes kept in
+     * core completely are swept over their decoded form */
+#if defined(_ZOS_)
+#if defined(_KEEP_)
+    if (tayKeepStamp == NULL)
+        compiledSweep = zos_forward_compiled(keep, basepoint, valuepoint,
+                                             dp_T0);
+#else
+    compiledSweep = zos_forward_compiled(0, basepoint, valuepoint, dp_T0);
+#endif
+#elif defined(_FOS_)
+#if defined(_KEEP_)
+    compiledSweep = fos_forward_compiled(keep, basepoint, argument,
+                                         valuepoint, taylors, dp_T0, dp_T);
+#else
+    compiledSweep = fos_forward_compiled(0, basepoint, argument,
+                                         valuepoint, taylors, dp_T0, dp_T);
+#endif
+#elif !defined(_CHUNKED_)
+    compiledSweep = fov_forward_compiled(p, basepoint, argument,
+                                         valuepoint, taylors, dp_T0, dpp_T);
+#endif
+    decodedTape = compiledSweep ? NULL : get_decoded_tape();
+#if defined(_ZOS_) && defined(_KEEP_)
+    if (tayKeepStamp != NULL)
+        decodedTape = NULL;
+#endif
+    if (compiledSweep)
+        operation = end_of_tape;
+    else if (decodedTape != NULL) {
+#if defined(_ZOS_)
+#if defined(_KEEP_)
+        zos_forward_parallel_decoded(decodedTape, keep, basepoint, valuepoint,
+                                     dp_T0);
+#else
+        zos_forward_parallel_decoded(decodedTape, 0, basepoint, valuepoint,
+                                     dp_T0);
+#endif
+#elif defined(_FOS_)
+#if defined(_KEEP_)
+        fos_forward_parallel_decoded(decodedTape, keep, basepoint, argument,
+                                     valuepoint, taylors, dp_T0, dp_T);
+#else
+        fos_forward_parallel_decoded(decodedTape, 0, basepoint, argument,
+                                     valuepoint, taylors, dp_T0, dp_T);
+#endif
+#elif defined(_CHUNKED_)
+        fov_forward_parallel_decoded(decodedTape, p, offset, basepoint,
+                                     argument, valuepoint, taylors, dp_T0,
+                                     dpp_T);
+#else
+        fov_forward_parallel_decoded(decodedTape, p, 0, basepoint, argument,
+                                     valuepoint, taylors, dp_T0, dpp_T);
+#endif
+        operation = end_of_tape;
+    } else
+#endif
     operation=get_op_f();
 #if defined(ADOLC_DEBUG)
     ++countPerOperation[operation];
@@ -1515,7 +1722,7 @@ int  hov_forward(
                 arg = get_locint_f();
                 res = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 
 #if !defined(_NTIGHT_)
@@ -1549,7 +1756,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = coval;
@@ -1586,7 +1793,7 @@ int  hov_forward(
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 #endif
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 if (operation == recipr_p) 
@@ -1621,7 +1828,7 @@ int  hov_forward(
                 /* double value. (0) (=) */
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = 0.0;
@@ -1652,7 +1859,7 @@ int  hov_forward(
                 /* double value. (1) (=) */
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = 1.0;
@@ -1684,7 +1891,7 @@ int  hov_forward(
                 /* independent double value (<<=) */
                 res = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = basepoint[indexi];
@@ -1776,7 +1983,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] += coval;
@@ -1791,7 +1998,7 @@ int  hov_forward(
 #if !defined(_NTIGHT_)
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 #endif
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] += coval;
@@ -1804,7 +2011,7 @@ int  hov_forward(
                 arg = get_locint_f();
                 res = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] += dp_T0[arg];
@@ -1845,7 +2052,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] -= coval;
@@ -1861,7 +2068,7 @@ int  hov_forward(
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 #endif
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] -= coval;
@@ -1874,7 +2081,7 @@ int  hov_forward(
                 arg = get_locint_f();
                 res = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] -= dp_T0[arg];
@@ -1915,7 +2122,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] *= coval;
@@ -1944,7 +2151,7 @@ int  hov_forward(
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg];
 #endif
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] *= coval;
@@ -2025,7 +2232,7 @@ int  hov_forward(
             case incr_a:                        /* Increment an adouble    incr_a */
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res]++;
@@ -2036,7 +2243,7 @@ int  hov_forward(
             case decr_a:                        /* Increment an adouble    decr_a */
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res]--;
@@ -2053,7 +2260,7 @@ int  hov_forward(
                 arg2 = get_locint_f();
                 res  = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 		 
 #if !defined(_NTIGHT_)
@@ -2087,6 +2294,61 @@ int  hov_forward(
 #endif /* ALL_TOGETHER_AGAIN */
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case plus_a_a_a:         /* Add three adoubles, fused      plus_a_a_a */
+                /* (+ +) */
+                arg1 = get_locint_f();
+                arg2 = get_locint_f();
+                arg  = get_locint_f();
+                res  = get_locint_f();
+
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
+
+#if !defined(_NTIGHT_)
+                dp_T0[res] = dp_T0[arg1] + dp_T0[arg2] + dp_T0[arg];
+#endif /* !_NTIGHT_ */
+
+#if defined(_INDO_)
+#if defined(_INDOPRO_)
+                if (res == arg)
+                    merge_3_index_domains(res, arg1, arg2, ind_dom);
+                else if (res == arg2)
+                    merge_3_index_domains(res, arg1, arg, ind_dom);
+                else {
+                    combine_2_index_domains(res, arg1, arg2, ind_dom);
+                    merge_2_index_domains(res, arg, ind_dom);
+                }
+#endif
+#if defined(_NONLIND_)
+		// first step: z = u+w
+		fod[opind].entry = maxopind+2;
+		fod[opind].left = &fod[arg_index[arg1]];
+		fod[opind].right = &fod[arg_index[arg2]];
+		opind++;
+		// second step: v = z+x
+		fod[opind].entry = maxopind+2;
+		fod[opind].left = &fod[opind-1];
+		fod[opind].right = &fod[arg_index[arg]];
+                arg_index[res] = opind++;
+#endif
+#else
+#if !defined(_ZOS_) /* BREAK_ZOS */
+                ASSIGN_T(Tres,  TAYLOR_BUFFER[res])
+                ASSIGN_T(Targ1, TAYLOR_BUFFER[arg1])
+                ASSIGN_T(Targ2, TAYLOR_BUFFER[arg2])
+                ASSIGN_T(Targ,  TAYLOR_BUFFER[arg])
+
+#ifdef _INT_FOR_
+                FOR_0_LE_l_LT_pk
+                TRES_INC = TARG1_INC | TARG2_INC | TARG_INC;
+#else
+                FOR_0_LE_l_LT_pk
+                TRES_INC = TARG1_INC + TARG2_INC + TARG_INC;
+#endif
+#endif
+#endif /* ALL_TOGETHER_AGAIN */
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case plus_d_a:             /* Add an adouble and a double    plus_d_a */
                 /* (+) */
@@ -2097,7 +2359,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = dp_T0[arg] + coval;
@@ -2132,7 +2394,7 @@ int  hov_forward(
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg1];
 #endif
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 if (operation == plus_a_p)
@@ -2166,7 +2428,7 @@ int  hov_forward(
                 arg2 = get_locint_f();
                 res  = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = dp_T0[arg1] -
@@ -2211,7 +2473,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = coval - dp_T0[arg];
@@ -2453,7 +2715,7 @@ int  hov_forward(
 #endif
 		get_val_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = dp_T0[arg] * coval;
@@ -2482,6 +2744,53 @@ int  hov_forward(
 #endif /* ALL_TOGETHER_AGAIN */
                 break;
 
+                /*--------------------------------------------------------------------------*/
+            case axpy_d_a:     /* Add a multiple of an adouble to     axpy_d_a */
+                /* an adouble, fused (* +) */
+                arg1 = get_locint_f();
+                arg2 = get_locint_f();
+                res  = get_locint_f();
+#if !defined(_NTIGHT_)
+                coval = 
+#endif
+		get_val_f();
+
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
+
+#if !defined(_NTIGHT_)
+                dp_T0[res] = dp_T0[arg1] * coval + dp_T0[arg2];
+#endif /* !_NTIGHT_ */
+
+#if defined(_INDO_)
+#if defined(_INDOPRO_)
+                if (res == arg2)
+                    merge_2_index_domains(res, arg1, ind_dom);
+                else
+                    combine_2_index_domains(res, arg1, arg2, ind_dom);
+#endif
+#if defined(_NONLIND_)
+		fod[opind].entry = maxopind+2;
+		fod[opind].left = &fod[arg_index[arg1]];
+		fod[opind].right = &fod[arg_index[arg2]];
+                arg_index[res] = opind++;
+#endif
+#else
+#if !defined(_ZOS_) /* BREAK_ZOS */
+                ASSIGN_T(Tres,  TAYLOR_BUFFER[res])
+                ASSIGN_T(Targ1, TAYLOR_BUFFER[arg1])
+                ASSIGN_T(Targ2, TAYLOR_BUFFER[arg2])
+
+#ifdef _INT_FOR_
+                FOR_0_LE_l_LT_pk
+                TRES_INC = TARG1_INC | TARG2_INC;
+#else
+                FOR_0_LE_l_LT_pk
+                TRES_INC = TARG1_INC * coval + TARG2_INC;
+#endif
+#endif
+#endif /* ALL_TOGETHER_AGAIN */
+                break;
+
                 /*--------------------------------------------------------------------------*/
             case mult_a_p:         /* Multiply an adouble by a double    mult_a_p */
                 /* (*) */
@@ -2492,7 +2801,7 @@ int  hov_forward(
                 coval = ADOLC_CURRENT_TAPE_INFOS.pTapeInfos.paramstore[arg1];
 #endif
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = dp_T0[arg] * coval;
@@ -2742,7 +3051,7 @@ int  hov_forward(
             arg   = get_locint_f();
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = dp_T0[arg];
@@ -2771,7 +3080,7 @@ int  hov_forward(
                 arg   = get_locint_f();
                 res   = get_locint_f();
 
-                IF_KEEP_WRITE_TAYLOR(res,keep,k,p)
+                IF_KEEP_WRITE_TAYLOR_LINEAR(res,keep,k,p)
 
 #if !defined(_NTIGHT_)
                 dp_T0[res] = -dp_T0[arg];
@@ -4292,9 +4601,10 @@ int  hov_forward(
                             VEC_INC(Targ1, k-i)
                                 VEC_INC(Targ2, k-i)
                                 BREAK_FOR_I
+                            } else {
+                                Targ1++;
+                                Targ2++;
                             }
-                        Targ1++;
-                        Targ2++;
                       }
                       if (Targ == NULL) /* e.g. both are equal */
                           Targ = Targ1OP;
@@ -6583,6 +6893,13 @@ int  hov_forward(
 
         } /* endswitch */
 
+#if defined(_KEEP_) && defined(_ZOS_)
+        if (tayKeepStamp != NULL)
+            markTaylorReads(operation, arg, arg1, arg2, res, tayKeepStamp,
+                    &tayKeepEpoch,
+                    ADOLC_CURRENT_TAPE_INFOS.stats[NUM_MAX_LIVES]);
+#endif
+
         /* Read the next operation */
         operation=get_op_f();
 #if defined(ADOLC_DEBUG)
@@ -6601,6 +6918,9 @@ int  hov_forward(
 
 #if defined(_KEEP_)
     if (keep) taylor_close(taylbuf);
+#if defined(_ZOS_)
+    free(tayKeepStamp);
+#endif
 #endif
 
     /* clean up */